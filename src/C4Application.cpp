@@ -269,6 +269,8 @@ bool C4Application::ProcessCallback(const char *szMessage, int iProcess)
 void C4Application::Clear()
 {
 	Game.Clear();
+	// retained def graphics must go before the graphics system
+	Game.Defs.ClearRetainedGraphics();
 	NextMission.Clear();
 	// close system group (System.c4g)
 	SystemGroup.Close();
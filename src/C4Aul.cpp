@@ -430,7 +430,7 @@ void C4AulScriptFunc::CopyBody(C4AulScriptFunc &FromFunc)
 // C4AulScriptEngine
 
 C4AulScriptEngine::C4AulScriptEngine() :
-	warnCnt(0), errCnt(0), nonStrictCnt(0), lineCnt(0)
+	iNextCoroutineNumber(1), pRunningCoroutine(nullptr), fCoroutinesBlocked(false), warnCnt(0), errCnt(0), nonStrictCnt(0), lineCnt(0)
 {
 	// /me r b engine
 	Engine = this;
@@ -451,6 +451,9 @@ C4AulScriptEngine::~C4AulScriptEngine() { Clear(); }
 
 void C4AulScriptEngine::Clear()
 {
+	// coroutines reference functions and values of all scripts
+	ClearCoroutines();
+	iNextCoroutineNumber = 1;
 	// clear inherited
 	C4AulScript::Clear();
 	// clear own stuff
@@ -469,6 +472,8 @@ void C4AulScriptEngine::Clear()
 
 void C4AulScriptEngine::UnLink()
 {
+	// suspended coroutines point into the code that is about to be recompiled
+	ClearCoroutines();
 	// unlink scripts
 	C4AulScript::UnLink();
 	// clear string table ("hold" strings only)
@@ -478,6 +483,84 @@ void C4AulScriptEngine::UnLink()
 	// variable or constant at runtime by removing it from the script.
 }
 
+int32_t C4AulScriptEngine::StartCoroutine(C4AulScriptFunc *pFunc, C4Object *pObj, const C4AulParSet &Pars, int32_t iBudget)
+{
+	if (!pFunc || fCoroutinesBlocked) return 0;
+	if (iBudget <= 0) iBudget = C4AUL_CoroutineDefaultBudget;
+	auto pCoroutine = std::make_unique<C4AulCoroutine>(iNextCoroutineNumber++, iBudget);
+	pCoroutine->Start(pFunc, pObj, Pars);
+	Coroutines.push_back(std::move(pCoroutine));
+	return Coroutines.back()->Number;
+}
+
+bool C4AulScriptEngine::StopCoroutine(int32_t iNumber)
+{
+	// only mark it; the stack is released after the next ExecuteCoroutines
+	for (const auto &pCoroutine : Coroutines)
+		if (pCoroutine->Number == iNumber && !pCoroutine->IsStopped())
+		{
+			pCoroutine->Stop();
+			return true;
+		}
+	return false;
+}
+
+bool C4AulScriptEngine::IsCoroutineRunning(int32_t iNumber)
+{
+	for (const auto &pCoroutine : Coroutines)
+		if (pCoroutine->Number == iNumber)
+			return !pCoroutine->IsStopped();
+	return false;
+}
+
+bool C4AulScriptEngine::AnyCoroutineRunning()
+{
+	for (const auto &pCoroutine : Coroutines)
+		if (!pCoroutine->IsStopped())
+			return true;
+	return false;
+}
+
+bool C4AulScriptEngine::YieldCoroutine()
+{
+	if (!pRunningCoroutine) return false;
+	pRunningCoroutine->RequestYield();
+	return true;
+}
+
+void C4AulScriptEngine::ExecuteCoroutines()
+{
+	// in order of creation; coroutines started meanwhile get their first slice next frame
+	const size_t iCount = Coroutines.size();
+	for (size_t i = 0; i < iCount; ++i)
+	{
+		C4AulCoroutine *pCoroutine = Coroutines[i].get();
+		pRunningCoroutine = pCoroutine;
+		pCoroutine->Resume();
+		pRunningCoroutine = nullptr;
+	}
+	// remove finished and stopped ones
+	std::erase_if(Coroutines, [](const auto &pCoroutine) { return pCoroutine->IsStopped(); });
+}
+
+void C4AulScriptEngine::ClearCoroutines()
+{
+	// a coroutine cannot be destroyed while it is executing
+	if (pRunningCoroutine)
+	{
+		for (const auto &pCoroutine : Coroutines) pCoroutine->Stop();
+		return;
+	}
+	Coroutines.clear();
+}
+
+void C4AulScriptEngine::ClearCoroutinePointers(C4Object *pObj)
+{
+	for (const auto &pCoroutine : Coroutines)
+		if (!pCoroutine->IsStopped() && pCoroutine->RefersTo(pObj))
+			pCoroutine->Stop();
+}
+
 void C4AulScriptEngine::RegisterGlobalConstant(const char *szName, const C4Value &rValue)
 {
 	// Register name and set value.
@@ -518,17 +601,11 @@ void C4AulScriptEngine::CompileFunc(StdCompiler *pComp)
 
 // C4AulFuncMap
 
-static const size_t CapacityInc = 1024;
+static const size_t InitialSlotCount = 1024;
 
-C4AulFuncMap::C4AulFuncMap() : Capacity(CapacityInc), FuncCnt(0), Funcs(new C4AulFunc *[CapacityInc])
-{
-	memset(Funcs, 0, sizeof(C4AulFunc *) * Capacity);
-}
+C4AulFuncMap::C4AulFuncMap() : Slots(InitialSlotCount, Slot{0, nullptr}), SlotCnt(0), FuncCnt(0) {}
 
-C4AulFuncMap::~C4AulFuncMap()
-{
-	delete[] Funcs;
-}
+C4AulFuncMap::~C4AulFuncMap() = default;
 
 unsigned int C4AulFuncMap::Hash(const char *name)
 {
@@ -539,93 +616,116 @@ unsigned int C4AulFuncMap::Hash(const char *name)
 	return h;
 }
 
+size_t C4AulFuncMap::FindSlot(const char *Name, unsigned int iHash) const
+{
+	// the table is never full, so this always hits a free slot eventually
+	const size_t iMask = Slots.size() - 1;
+	for (size_t i = iHash & iMask; ; i = (i + 1) & iMask)
+	{
+		const Slot &slot = Slots[i];
+		if (!slot.First || (slot.Hash == iHash && SEqual(Name, slot.First->Name)))
+			return i;
+	}
+}
+
+void C4AulFuncMap::Grow()
+{
+	std::vector<Slot> OldSlots(Slots.size() * 2, Slot{0, nullptr});
+	std::swap(Slots, OldSlots);
+	const size_t iMask = Slots.size() - 1;
+	for (const Slot &slot : OldSlots)
+		if (slot.First)
+		{
+			size_t i = slot.Hash & iMask;
+			while (Slots[i].First) i = (i + 1) & iMask;
+			Slots[i] = slot;
+		}
+}
+
+void C4AulFuncMap::FreeSlot(size_t iSlot)
+{
+	// shift following entries back so no probe sequence is interrupted
+	const size_t iMask = Slots.size() - 1;
+	for (size_t j = (iSlot + 1) & iMask; Slots[j].First; j = (j + 1) & iMask)
+	{
+		const size_t iHome = Slots[j].Hash & iMask;
+		// entry may move if its home slot does not lie cyclically in (iSlot, j]
+		const bool fStays = iSlot <= j ? (iSlot < iHome && iHome <= j) : (iSlot < iHome || iHome <= j);
+		if (!fStays)
+		{
+			Slots[iSlot] = Slots[j];
+			iSlot = j;
+		}
+	}
+	Slots[iSlot].First = nullptr;
+	--SlotCnt;
+}
+
 C4AulFunc *C4AulFuncMap::GetFirstFunc(const char *Name)
 {
 	if (!Name) return nullptr;
-	C4AulFunc *Func = Funcs[Hash(Name) % Capacity];
-	while (Func && !SEqual(Name, Func->Name))
-		Func = Func->MapNext;
-	return Func;
+	return Slots[FindSlot(Name, Hash(Name))].First;
 }
 
 C4AulFunc *C4AulFuncMap::GetNextSNFunc(const C4AulFunc *After)
 {
-	C4AulFunc *Func = After->MapNext;
-	while (Func && !SEqual(After->Name, Func->Name))
-		Func = Func->MapNext;
-	return Func;
+	return After->MapNext;
 }
 
 C4AulFunc *C4AulFuncMap::GetFunc(const char *Name, const C4AulScript *Owner, const C4AulFunc *After)
 {
 	if (!Name) return nullptr;
-	C4AulFunc *Func = Funcs[Hash(Name) % Capacity];
+	C4AulFunc *Func;
 	if (After)
-	{
-		while (Func && Func != After)
-			Func = Func->MapNext;
-		if (Func)
-			Func = Func->MapNext;
-	}
-	while (Func && (Func->Owner != Owner || !SEqual(Name, Func->Name)))
+		Func = SEqual(Name, After->Name) ? After->MapNext : nullptr;
+	else
+		Func = Slots[FindSlot(Name, Hash(Name))].First;
+	while (Func && Func->Owner != Owner)
 		Func = Func->MapNext;
 	return Func;
 }
 
 void C4AulFuncMap::Add(C4AulFunc *func, bool bAtStart)
 {
-	if (++FuncCnt > Capacity)
+	++FuncCnt;
+	// keep load factor below 3/4
+	if ((SlotCnt + 1) * 4 > static_cast<int>(Slots.size()) * 3) Grow();
+	const unsigned int iHash = Hash(func->Name);
+	Slot &slot = Slots[FindSlot(func->Name, iHash)];
+	if (!slot.First)
 	{
-		int NCapacity = Capacity + CapacityInc;
-		C4AulFunc **NFuncs = new C4AulFunc *[NCapacity];
-		memset(NFuncs, 0, sizeof(C4AulFunc *) * NCapacity);
-		for (int i = 0; i < Capacity; ++i)
-		{
-			while (Funcs[i])
-			{
-				// Get a pointer to the bucket
-				C4AulFunc **pNFunc = &(NFuncs[Hash(Funcs[i]->Name) % NCapacity]);
-				// get a pointer to the end of the linked list
-				while (*pNFunc) pNFunc = &((*pNFunc)->MapNext);
-				// Move the func over
-				*pNFunc = Funcs[i];
-				// proceed with the next list member
-				Funcs[i] = Funcs[i]->MapNext;
-				// Terminate the linked list
-				(*pNFunc)->MapNext = nullptr;
-			}
-		}
-		Capacity = NCapacity;
-		delete[] Funcs;
-		Funcs = NFuncs;
+		// first function of that name
+		slot.Hash = iHash;
+		slot.First = func;
+		func->MapNext = nullptr;
+		++SlotCnt;
 	}
-	// Get a pointer to the bucket
-	C4AulFunc **pFunc = &(Funcs[Hash(func->Name) % Capacity]);
-	if (bAtStart)
+	else if (bAtStart)
 	{
 		// move the current first to the second position
-		func->MapNext = *pFunc;
+		func->MapNext = slot.First;
+		slot.First = func;
 	}
 	else
 	{
-		// get a pointer to the end of the linked list
-		while (*pFunc)
-		{
-			pFunc = &((*pFunc)->MapNext);
-		}
+		// append to the functions of the same name
+		C4AulFunc *pLast = slot.First;
+		while (pLast->MapNext) pLast = pLast->MapNext;
+		pLast->MapNext = func;
+		func->MapNext = nullptr;
 	}
-	// Add the func
-	*pFunc = func;
 }
 
 void C4AulFuncMap::Remove(C4AulFunc *func)
 {
-	C4AulFunc **pFunc = &Funcs[Hash(func->Name) % Capacity];
+	const size_t iSlot = FindSlot(func->Name, Hash(func->Name));
+	C4AulFunc **pFunc = &Slots[iSlot].First;
 	while (*pFunc != func)
 	{
-		pFunc = &((*pFunc)->MapNext);
 		assert(*pFunc); // crash on remove of a not contained func
+		pFunc = &((*pFunc)->MapNext);
 	}
 	*pFunc = (*pFunc)->MapNext;
+	if (!Slots[iSlot].First) FreeSlot(iSlot);
 	--FuncCnt;
 }
@@ -32,6 +32,7 @@
 
 #include <cstdint>
 #include <list>
+#include <memory>
 #include <vector>
 
 // class predefs
@@ -289,7 +290,7 @@ public:
 
 protected:
 	C4AulFunc *Prev, *Next; // linked list members
-	C4AulFunc *MapNext; // map member
+	C4AulFunc *MapNext; // map member: next function of the same name
 	C4AulFunc *LinkedTo; // points to next linked function; destructor will destroy linked func, too
 
 public:
@@ -379,10 +380,20 @@ public:
 	C4AulFunc *GetNextSNFunc(const C4AulFunc *After);
 
 private:
-	C4AulFunc **Funcs;
+	// one slot per function name; same-named functions are chained via MapNext
+	struct Slot
+	{
+		unsigned int Hash;
+		C4AulFunc *First; // nullptr if slot is free
+	};
+
+	std::vector<Slot> Slots; // open addressing with linear probing; size is a power of two
+	int SlotCnt; // used slots
 	int FuncCnt;
-	int Capacity;
 	static unsigned int Hash(const char *Name);
+	size_t FindSlot(const char *Name, unsigned int iHash) const; // returns matching or free slot
+	void Grow();
+	void FreeSlot(size_t iSlot);
 
 protected:
 	void Add(C4AulFunc *func, bool bAtEnd = true);
@@ -521,12 +532,50 @@ public:
 	friend class C4AulParseState;
 };
 
+// script function executed in slices over several frames on its own context and value stack
+class C4AulCoroutine
+{
+public:
+	C4AulCoroutine(int32_t iNumber, int32_t iBudget);
+	~C4AulCoroutine();
+
+	C4AulCoroutine(const C4AulCoroutine &) = delete;
+	C4AulCoroutine &operator=(const C4AulCoroutine &) = delete;
+
+public:
+	const int32_t Number;
+	const int32_t Budget; // bytecodes executed per frame
+
+	void Start(C4AulScriptFunc *pFunc, C4Object *pObj, const C4AulParSet &Pars);
+	void Resume(); // execute one slice; stops the coroutine if the function returned
+	void RequestYield(); // suspend at the next instruction
+	void Stop() { fStopped = true; RequestYield(); }
+	bool IsStopped() const { return fStopped; }
+	bool RefersTo(const C4Object *pObj) const; // whether any call on the stack runs in the context of pObj
+	C4AulScriptFunc *GetFunc() const { return pFunc; }
+	C4Object *GetObj() const { return pObj; }
+
+private:
+	std::unique_ptr<class C4AulExec> Exec;
+	C4AulScriptFunc *pFunc; // started function and its context
+	C4Object *pObj;
+	bool fStopped;
+};
+
+#define C4AUL_CoroutineDefaultBudget 10000
+
 // holds all C4AulScripts
 class C4AulScriptEngine : public C4AulScript
 {
 protected:
 	C4AulFuncMap FuncLookUp;
 
+	// running coroutines in order of creation; stopped ones are removed after executing them
+	std::vector<std::unique_ptr<C4AulCoroutine>> Coroutines;
+	int32_t iNextCoroutineNumber;
+	C4AulCoroutine *pRunningCoroutine;
+	bool fCoroutinesBlocked; // no new coroutines during AbortCoroutines callbacks
+
 public:
 	int warnCnt, errCnt; // number of warnings/errors
 	int nonStrictCnt; // number of non-strict scripts
@@ -576,6 +625,16 @@ public:
 
 	bool DenumerateVariablePointers();
 	void UnLink(); // called when a script is being reloaded (clears string table)
+
+	int32_t StartCoroutine(C4AulScriptFunc *pFunc, C4Object *pObj, const C4AulParSet &Pars, int32_t iBudget); // returns coroutine number; first slice runs in the next ExecuteCoroutines
+	bool StopCoroutine(int32_t iNumber);
+	bool IsCoroutineRunning(int32_t iNumber);
+	bool AnyCoroutineRunning();
+	bool YieldCoroutine(); // suspend currently running coroutine; false if not called from one
+	void ExecuteCoroutines(); // run one slice of each coroutine; called once per frame
+	void ClearCoroutines(); // abort all coroutines silently, e.g. before relinking scripts
+	void AbortCoroutines(); // abort all coroutines before synchronization, since their state is not saved; logs and notifies their scripts
+	void ClearCoroutinePointers(C4Object *pObj); // stop coroutines running in the context of pObj
 	// Compile scenario script data (without strings and constants)
 	void CompileFunc(StdCompiler *pComp);
 
@@ -23,6 +23,8 @@
 #include <C4Object.h>
 #include <C4Config.h>
 #include <C4Game.h>
+#include <C4Log.h>
+#include <C4Script.h>
 #include <C4ValueHash.h>
 #include <C4Wrappers.h>
 
@@ -101,7 +103,7 @@ class C4AulExec
 {
 public:
 	C4AulExec()
-		: pCurCtx(Contexts - 1), pCurVal(Values - 1), iTraceStart(-1) {}
+		: pCurCtx(Contexts - 1), pCurVal(Values - 1), iTraceStart(-1), fProfiling(false), iBudget(-1), fYield(false), fSuspended(false) {}
 
 private:
 	C4AulScriptContext Contexts[MAX_CONTEXT_STACK];
@@ -115,10 +117,21 @@ private:
 	time_t tDirectExecStart, tDirectExecTotal; // profiler time for DirectExec
 	C4AulScript *pProfiledScript;
 
+	// time slicing (coroutines only)
+	int32_t iBudget; // bytecodes left in this slice; -1 if unlimited
+	bool fYield; // suspend at next instruction
+	bool fSuspended; // set when Exec returned because of the above
+
 public:
 	C4Value Exec(C4AulScriptFunc *pSFunc, C4Object *pObj, const C4Value pPars[], bool fPassErrors, bool fTemporaryScript = false);
 	C4Value Exec(C4AulBCC *pCPos, bool fPassErrors);
 
+	void PushFunc(C4AulScriptFunc *pSFunc, C4Object *pObj, const C4Value pPars[], bool fTemporaryScript = false); // push context for pSFunc without executing it
+	bool ExecSlice(int32_t iInstructions); // continue at top context; returns false once the function returned
+	void RequestYield() { fYield = true; }
+	void Abort(); // unwind everything
+	bool RefersTo(const C4Object *pObj) const;
+
 	void StartTrace();
 	void StartProfiling(C4AulScript *pScript); // resets profling times and starts recording the times
 	void StopProfiling(); // stop the profiler and displays results
@@ -316,6 +329,14 @@ private:
 C4AulExec AulExec;
 
 C4Value C4AulExec::Exec(C4AulScriptFunc *pSFunc, C4Object *pObj, const C4Value *pnPars, bool fPassErrors, bool fTemporaryScript)
+{
+	PushFunc(pSFunc, pObj, pnPars, fTemporaryScript);
+
+	// Execute
+	return Exec(pSFunc->Code, fPassErrors);
+}
+
+void C4AulExec::PushFunc(C4AulScriptFunc *pSFunc, C4Object *pObj, const C4Value *pnPars, bool fTemporaryScript)
 {
 	// Push parameters
 	C4Value *pPars = pCurVal + 1;
@@ -346,9 +367,32 @@ C4Value C4AulExec::Exec(C4AulScriptFunc *pSFunc, C4Object *pObj, const C4Value *
 	ctx.CPos = nullptr;
 	ctx.Caller = nullptr;
 	PushContext(ctx);
+}
 
-	// Execute
-	return Exec(pSFunc->Code, fPassErrors);
+bool C4AulExec::ExecSlice(int32_t iInstructions)
+{
+	if (pCurCtx < Contexts) return false;
+	iBudget = iInstructions;
+	fSuspended = false;
+	Exec(pCurCtx->CPos ? pCurCtx->CPos : pCurCtx->Func->Code, false);
+	iBudget = -1;
+	if (fSuspended) return true;
+	// returned or failed: errors only unwind the calls made since the slice started
+	Abort();
+	return false;
+}
+
+void C4AulExec::Abort()
+{
+	while (pCurCtx >= Contexts) PopContext();
+	PopValuesUntil(Values - 1);
+}
+
+bool C4AulExec::RefersTo(const C4Object *pObj) const
+{
+	for (const C4AulScriptContext *pCtx = Contexts; pCtx <= pCurCtx; ++pCtx)
+		if (pCtx->Obj == pObj) return true;
+	return false;
 }
 
 C4Value C4AulExec::Exec(C4AulBCC *pCPos, bool fPassErrors)
@@ -1302,6 +1346,15 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos, bool fPassErrors)
 			// Continue
 			if (!fJump)
 				pCPos++;
+
+			// Time slice used up?
+			if (iBudget >= 0 && (fYield || !iBudget--))
+			{
+				pCurCtx->CPos = pCPos;
+				fYield = false;
+				fSuspended = true;
+				return C4VNull;
+			}
 		}
 	}
 	catch (const C4AulError &e)
@@ -1512,6 +1565,65 @@ C4AulBCC *C4AulExec::Call(C4AulFunc *pFunc, C4Value *pReturn, C4Value *pPars, C4
 	}
 }
 
+// C4AulCoroutine
+
+C4AulCoroutine::C4AulCoroutine(int32_t iNumber, int32_t iBudget)
+	: Number(iNumber), Budget(iBudget), Exec(std::make_unique<C4AulExec>()), pFunc(nullptr), pObj(nullptr), fStopped(false) {}
+
+C4AulCoroutine::~C4AulCoroutine()
+{
+	Exec->Abort();
+}
+
+void C4AulCoroutine::Start(C4AulScriptFunc *pFunc, C4Object *pObj, const C4AulParSet &Pars)
+{
+	this->pFunc = pFunc; this->pObj = pObj;
+	Exec->PushFunc(pFunc, pObj, Pars.Par);
+}
+
+void C4AulCoroutine::Resume()
+{
+	if (fStopped) return;
+	if (!Exec->ExecSlice(Budget)) fStopped = true;
+}
+
+void C4AulCoroutine::RequestYield()
+{
+	Exec->RequestYield();
+}
+
+bool C4AulCoroutine::RefersTo(const C4Object *pObj) const
+{
+	return Exec->RefersTo(pObj);
+}
+
+void C4AulScriptEngine::AbortCoroutines()
+{
+	struct AbortedCoroutine
+	{
+		int32_t Number;
+		C4AulScriptFunc *Func;
+		C4Object *Obj;
+	};
+	std::vector<AbortedCoroutine> Aborted;
+	for (const auto &pCoroutine : Coroutines)
+		if (!pCoroutine->IsStopped())
+			Aborted.push_back({pCoroutine->Number, pCoroutine->GetFunc(), pCoroutine->GetObj()});
+	ClearCoroutines();
+	// tell the scripts, so they can restart the work later (e.g. from a timer)
+	// coroutines started now would not be in the savegame made at this synchronization, so they are refused
+	fCoroutinesBlocked = true;
+	for (const auto &Coroutine : Aborted)
+	{
+		LogF("Warning: Script coroutine %d (%s) aborted by synchronization", Coroutine.Number, Coroutine.Func->Name);
+		if (Coroutine.Obj && !Coroutine.Obj->Status) continue;
+		C4AulScript *pScript = Coroutine.Obj ? &Coroutine.Obj->Def->Script : Coroutine.Func->Owner;
+		if (C4AulScriptFunc *pCallback = pScript->GetSFunc(PSF_CoroutineAborted, AA_PROTECTED, true))
+			pCallback->Exec(Coroutine.Obj, C4AulParSet{C4VInt(Coroutine.Number), C4VString(Coroutine.Func->Name)});
+	}
+	fCoroutinesBlocked = false;
+}
+
 void C4AulStartTrace()
 {
 	AulExec.StartTrace();
@@ -2341,6 +2341,8 @@ void C4Command::Set(int32_t iCommand, C4Object *pObj, C4Object *pTarget, C4Value
 	// Set
 	Command = iCommand;
 	cObj = pObj;
+	Target.SetHolder(pObj);
+	Target2.SetHolder(pObj);
 	Target = pTarget;
 	Tx = nTx; Ty = iTy;
 	Target2 = pTarget2;
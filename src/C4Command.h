@@ -84,7 +84,7 @@ public:
 	int32_t Command;
 	C4Value Tx;
 	int32_t Ty;
-	C4EnumeratedObjectPtr Target, Target2;
+	C4TargetObjectPtr Target, Target2;
 	int32_t Data;
 	int32_t UpdateInterval;
 	int32_t Evaluated, PathChecked, Finished;
@@ -62,6 +62,8 @@
 #define C4CFN_MassMover        "MassMover.c4b"
 #define C4CFN_CtrlRec          "CtrlRec.c4b"
 #define C4CFN_CtrlRecText      "CtrlRec.txt"
+#define C4CFN_RecKeyframes     "Keyframes.txt"
+#define C4CFN_RecKeyframe      "Keyframe%08d.c4s"
 #define C4CFN_TexMap           "TexMap.txt"
 #define C4CFN_MatMap           "MatMap.txt"
 #define C4CFN_Title            "Title%s.txt|Title.txt"
@@ -71,6 +73,7 @@
 #define C4CFN_ScenarioIcon     "Icon.bmp"
 #define C4CFN_IconPNG          "Icon.png"
 #define C4CFN_ScenarioObjects  "Objects.txt"
+#define C4CFN_ScenarioObjectsBin "Objects.c4b"
 #define C4CFN_ScenarioDesc     "Desc%s.rtf"
 #define C4CFN_DefGraphics      "Graphics.bmp"
 #define C4CFN_DefGraphicsPNG   "Graphics.png"
@@ -110,6 +113,8 @@
 #define C4CFN_Language  "Language*.txt"
 #define C4CFN_KeyConfig "KeyConfig.txt"
 
+#define C4CFN_DefCoreCache "DefCoreCache.dat"
+
 #define C4CFN_Log    "Clonk.log"
 #define C4CFN_LogEx  "Clonk%d.log" // created if regular logfile is in use
 #define C4CFN_Names  "Names.txt"
@@ -137,10 +142,10 @@
 
 // File Load Sequences
 
-#define C4FLS_Scenario         "Loader*.bmp|Loader*.png|Loader*.jpeg|Loader*.jpg|Fonts.txt|Scenario.txt|Title*.txt|Info.txt|Desc*.rtf|Icon.png|Icon.bmp|Game.txt|StringTbl*.txt|Teams.txt|Parameters.txt|Info.txt|Sect*.c4g|Music.c4g|*.mid|*.wav|Desc*.rtf|Title.bmp|Title.png|*.c4d|Material.c4g|MatMap.txt|Landscape.bmp|Landscape.png|" C4CFN_DiffLandscape "|Sky.bmp|Sky.png|Sky.jpeg|Sky.jpg|PXS.c4b|MassMover.c4b|CtrlRec.c4b|Strings.txt|Objects.txt|RoundResults.txt|Author.txt|Version.txt|Names.txt|*.c4d|Script.c|Script*.c|System.c4g"
-#define C4FLS_Section          "Scenario.txt|Game.txt|Landscape.bmp|Landscape.png|Sky.bmp|Sky.png|Sky.jpeg|Sky.jpg|PXS.c4b|MassMover.c4b|CtrlRec.c4b|Strings.txt|Objects.txt"
+#define C4FLS_Scenario         "Loader*.bmp|Loader*.png|Loader*.jpeg|Loader*.jpg|Fonts.txt|Scenario.txt|Title*.txt|Info.txt|Desc*.rtf|Icon.png|Icon.bmp|Game.txt|StringTbl*.txt|Teams.txt|Parameters.txt|Info.txt|Sect*.c4g|Music.c4g|*.mid|*.wav|Desc*.rtf|Title.bmp|Title.png|*.c4d|Material.c4g|MatMap.txt|Landscape.bmp|Landscape.png|" C4CFN_DiffLandscape "|Sky.bmp|Sky.png|Sky.jpeg|Sky.jpg|PXS.c4b|MassMover.c4b|CtrlRec.c4b|Strings.txt|Objects.txt|Objects.c4b|RoundResults.txt|Author.txt|Version.txt|Names.txt|*.c4d|Script.c|Script*.c|System.c4g"
+#define C4FLS_Section          "Scenario.txt|Game.txt|Landscape.bmp|Landscape.png|Sky.bmp|Sky.png|Sky.jpeg|Sky.jpg|PXS.c4b|MassMover.c4b|CtrlRec.c4b|Strings.txt|Objects.txt|Objects.c4b"
 #define C4FLS_SectionLandscape "Scenario.txt|Landscape.bmp|Landscape.png|PXS.c4b|MassMover.c4b"
-#define C4FLS_SectionObjects   "Strings.txt|Objects.txt"
+#define C4FLS_SectionObjects   "Strings.txt|Objects.txt|Objects.c4b"
 #define C4FLS_Def              "Particle.txt|DefCore.txt|Graphics.bmp|Graphics.png|Overlay.png|Graphics*.png|Overlay*.png|Portrait*.png|Portrait*.bmp|ActMap.txt|Script.c|Script*.c|C4Script.c|StringTbl*.txt|Names*.txt|Title*.txt|ClonkNames.txt|" C4CFN_RankNameFiles "|Rank.bmp|Rank.png|Desc*.txt|Overlay.png|Title.bmp|Title.png|Icon.bmp|Author.txt|Version.txt|" C4CFN_SoundFiles "|*.c4d"
 #define C4FLS_Player           "Player.txt|Portrait.png|Portrait.bmp|*.c4i"
 #define C4FLS_Object           "ObjectInfo.txt|Portrait.png|Portrait.bmp"
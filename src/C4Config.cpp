@@ -81,6 +81,7 @@ void C4ConfigGeneral::CompileFunc(StdCompiler *pComp)
 #endif
 	pComp->Value(mkNamingAdapt(FPS,                     "FPS",                     false,         false, true));
 	pComp->Value(mkNamingAdapt(Record,                  "Record",                  false,         false, true));
+	pComp->Value(mkNamingAdapt(RecordKeyframeInterval,  "RecordKeyframeInterval",  0,             false, true));
 	pComp->Value(mkNamingAdapt(ScreenshotFolder,        "ScreenshotFolder",        "Screenshots", false, true));
 	pComp->Value(mkNamingAdapt(FairCrew,                "NoCrew",                  false,         false, true));
 	pComp->Value(mkNamingAdapt(FairCrewStrength,        "DefCrewStrength",         1000,          false, true));
@@ -111,7 +112,17 @@ void C4ConfigGeneral::CompileFunc(StdCompiler *pComp)
 
 void C4ConfigDeveloper::CompileFunc(StdCompiler *pComp)
 {
-	pComp->Value(mkNamingAdapt(AutoFileReload, "AutoFileReload", true, false, true));
+	pComp->Value(mkNamingAdapt(AutoFileReload,     "AutoFileReload",     true,  false, true));
+	pComp->Value(mkNamingAdapt(DefCoreCache,       "DefCoreCache",       false, false, true));
+	pComp->Value(mkNamingAdapt(DefCoreCacheVerify, "DefCoreCacheVerify", false, false, true));
+	pComp->Value(mkNamingAdapt(DefLoadThreads,     "DefLoadThreads",     0,     false, true));
+	pComp->Value(mkNamingAdapt(RetainDefGraphics,  "RetainDefGraphics",  false, false, true));
+	pComp->Value(mkNamingAdapt(AsyncLog,           "AsyncLog",           true,  false, true));
+	pComp->Value(mkNamingAdapt(ObjectQueryVerify,  "ObjectQueryVerify",  false, false, true));
+	pComp->Value(mkNamingAdapt(ContactCache,       "ContactCache",       true,  false, true));
+	pComp->Value(mkNamingAdapt(ContactCacheVerify, "ContactCacheVerify", false, false, true));
+	pComp->Value(mkNamingAdapt(mkStringAdaptM(DebugRecTypes), "DebugRecTypes", "", false, true));
+	pComp->Value(mkNamingAdapt(KeyDispatchStats,   "KeyDispatchStats",   false, false, true));
 }
 
 void C4ConfigGraphics::CompileFunc(StdCompiler *pComp)
@@ -230,6 +241,7 @@ void C4ConfigNetwork::CompileFunc(StdCompiler *pComp)
 	pComp->Value(mkNamingAdapt(AutomaticUpdate,           "EnableAutomaticUpdate",  true));
 	pComp->Value(mkNamingAdapt(LastUpdateTime,            "LastUpdateTime",         0,    false, true));
 	pComp->Value(mkNamingAdapt(AsyncMaxWait,              "AsyncMaxWait",           2,    false, true));
+	pComp->Value(mkNamingAdapt(BackgroundDynamicSave,     "BackgroundDynamicSave",  false, false, true));
 
 	constexpr auto defaultPuncherServer = "netpuncher.openclonk.org:11115";
 	pComp->Value(mkNamingAdapt(s(PuncherAddress), "PuncherAddress", defaultPuncherServer, false, true));
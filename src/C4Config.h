@@ -65,6 +65,7 @@ public:
 	char MissionAccess[CFG_MaxString + 1];
 	bool FPS;
 	bool Record;
+	int32_t RecordKeyframeInterval; // frames between keyframe savegames in records; 0 for none. Keyframes synchronize the game, but keep the random sequence and wait for running script coroutines
 	bool MMTimer;    // use multimedia-timers
 	bool FairCrew;   // don't use permanent crew physicals
 	int32_t FairCrewStrength; // strength of clonks in fair crew mode
@@ -99,6 +100,16 @@ class C4ConfigDeveloper
 {
 public:
 	bool AutoFileReload;
+	bool DefCoreCache;
+	bool DefCoreCacheVerify;
+	int32_t DefLoadThreads; // PNG decoding threads during definition loading; 0 = automatic, 1 = decode on main thread
+	bool RetainDefGraphics; // keep graphics of unchanged definitions from one round to the next
+	bool AsyncLog; // write log file and console output on a separate thread
+	bool ObjectQueryVerify; // check indexed object searches against a full list scan
+	bool ContactCache; // reuse vertex contact checks of objects that did not move
+	bool ContactCacheVerify; // recompute cached vertex contacts and log mismatches and contact check counts
+	char DebugRecTypes[CFG_MaxString + 1]; // ;-separated debug record types captured by DEBUGREC builds (e.g. "Random;SetPix"); empty for all. Must match between record and playback
+	bool KeyDispatchStats; // time keyboard dispatch and log the average per key event when the round is cleared
 	void CompileFunc(StdCompiler *pComp);
 };
 
@@ -204,6 +215,7 @@ public:
 	bool AutomaticUpdate;
 	uint64_t LastUpdateTime;
 	int32_t AsyncMaxWait;
+	bool BackgroundDynamicSave;
 
 public:
 	void CompileFunc(StdCompiler *pComp);
@@ -27,10 +27,20 @@
 #include <C4Log.h>
 #include <C4Wrappers.h>
 #include <C4Player.h>
+#include <C4ValueHash.h>
 
 #include <cassert>
 #include <cinttypes>
 
+// First engine build whose control packets carry the sync check hashes and the keyframe flag
+static constexpr int32_t C4ControlExtFieldsBuild = 357;
+
+// Records of older builds don't contain these fields
+static bool HasExtControlFields()
+{
+	return !Game.C4S.Head.Replay || Game.C4S.Head.C4XVer[4] >= C4ControlExtFieldsBuild;
+}
+
 // *** C4ControlPacket
 C4ControlPacket::C4ControlPacket()
 	: iByClient(Game.Control.ClientID()) {}
@@ -422,7 +432,7 @@ void C4ControlPlayerCommand::CompileFunc(StdCompiler *pComp)
 
 // *** C4ControlSyncCheck
 
-C4ControlSyncCheck::C4ControlSyncCheck() {}
+C4ControlSyncCheck::C4ControlSyncCheck() : LandscapeHash(0), ObjectsHash(0), PXSHash(0), ScriptHash(0) {}
 
 void C4ControlSyncCheck::Set()
 {
@@ -437,6 +447,10 @@ void C4ControlSyncCheck::Set()
 	ObjectCount = Game.Objects.ObjectCount();
 	ObjectEnumerationIndex = Game.ObjectEnumerationIndex;
 	SectShapeSum = Game.Objects.Sectors.getShapeSum();
+	LandscapeHash = Game.Landscape.GetPixHash();
+	ObjectsHash = GetObjectsHash();
+	PXSHash = Game.PXS.GetSyncHash();
+	ScriptHash = GetScriptHash();
 }
 
 int32_t C4ControlSyncCheck::GetAllCrewPosX()
@@ -448,6 +462,117 @@ int32_t C4ControlSyncCheck::GetAllCrewPosX()
 	return cpx;
 }
 
+uint32_t C4ControlSyncCheck::GetObjectsHash()
+{
+	// the object list order is synchronized, so it is part of the hash
+	uint32_t dwHash = 0;
+	// removed objects wait in the list for deletion, but are not saved, so clients that joined from a savegame don't have them
+	for (C4Object *pObj : Game.Objects)
+	{
+		if (!pObj->Status) continue;
+		SyncHashAdd(dwHash, pObj->Number);
+		SyncHashAdd(dwHash, pObj->id);
+		SyncHashAdd(dwHash, pObj->Status);
+		SyncHashAdd(dwHash, pObj->Contained ? pObj->Contained->Number : 0);
+		SyncHashAdd(dwHash, fixtoi(pObj->fix_x, FIXED_FPF));
+		SyncHashAdd(dwHash, fixtoi(pObj->fix_y, FIXED_FPF));
+		SyncHashAdd(dwHash, fixtoi(pObj->fix_r, FIXED_FPF));
+		SyncHashAdd(dwHash, fixtoi(pObj->xdir, FIXED_FPF));
+		SyncHashAdd(dwHash, fixtoi(pObj->ydir, FIXED_FPF));
+		SyncHashAdd(dwHash, pObj->GetCon());
+		SyncHashAdd(dwHash, pObj->Energy);
+		SyncHashAdd(dwHash, pObj->Owner);
+		SyncHashAdd(dwHash, pObj->Action.Act);
+		SyncHashAdd(dwHash, pObj->Action.Phase);
+		for (int32_t i = 0; i < pObj->Local.GetSize(); ++i)
+			AddValueHash(dwHash, pObj->Local.GetItem(i));
+	}
+	return dwHash;
+}
+
+uint32_t C4ControlSyncCheck::GetScriptHash()
+{
+	uint32_t dwHash = 0;
+	const C4ValueList &Global = Game.ScriptEngine.Global;
+	for (int32_t i = 0; i < Global.GetSize(); ++i)
+		AddValueHash(dwHash, Global.GetItem(i));
+	C4ValueMapData &GlobalNamed = Game.ScriptEngine.GlobalNamed;
+	for (int32_t i = 0; i < GlobalNamed.GetAnzItems(); ++i)
+		AddValueHash(dwHash, *GlobalNamed.GetItem(i));
+	return dwHash;
+}
+
+void C4ControlSyncCheck::AddValueHash(uint32_t &dwHash, const C4Value &rValue, int32_t iDepth)
+{
+	const C4Value &rRef = rValue.GetRefVal();
+	const C4V_Type eType = rRef.GetType();
+	SyncHashAdd(dwHash, eType);
+	switch (eType)
+	{
+	case C4V_Int: case C4V_Bool: case C4V_C4ID:
+		SyncHashAdd(dwHash, rRef._getInt());
+		break;
+	case C4V_C4Object:
+		SyncHashAdd(dwHash, rRef._getObj()->Number);
+		break;
+	case C4V_String:
+		for (const char *szChar = rRef._getStr()->Data.getData(); szChar && *szChar; ++szChar)
+			SyncHashAdd(dwHash, static_cast<uint8_t>(*szChar));
+		break;
+	case C4V_Array:
+	{
+		// arrays and maps may nest deeply or even contain themselves
+		const C4ValueArray &Array = *rRef._getArray();
+		SyncHashAdd(dwHash, Array.GetSize());
+		if (iDepth < 2)
+			for (int32_t i = 0; i < Array.GetSize(); ++i)
+				AddValueHash(dwHash, Array.GetItem(i), iDepth + 1);
+		break;
+	}
+	case C4V_Map:
+	{
+		// order independent
+		uint32_t dwContentHash = 0;
+		C4ValueHash &Map = *rRef._getMap();
+		SyncHashAdd(dwHash, static_cast<uint32_t>(Map.size()));
+		if (iDepth < 2)
+			for (const auto &it : Map)
+			{
+				uint32_t dwItemHash = 0;
+				AddValueHash(dwItemHash, it.first, iDepth + 1);
+				AddValueHash(dwItemHash, it.second, iDepth + 1);
+				dwContentHash += dwItemHash;
+			}
+		SyncHashAdd(dwHash, dwContentHash);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void C4ControlSyncCheck::LogDivergence(const C4ControlSyncCheck &SyncCheck) const
+{
+	// name the subsystems whose state differs, the counters only tell that something went wrong
+	std::string strDiverging;
+	const bool fHashes = HasExtControlFields();
+	const auto check = [&strDiverging](bool fEqual, const char *szName)
+	{
+		if (fEqual) return;
+		if (!strDiverging.empty()) strDiverging += ", ";
+		strDiverging += szName;
+	};
+	check(Random3 == SyncCheck.Random3 && RandomCount == SyncCheck.RandomCount, "Random");
+	check(!fHashes || LandscapeHash == SyncCheck.LandscapeHash, "Landscape");
+	check((!fHashes || ObjectsHash == SyncCheck.ObjectsHash) && ObjectCount == SyncCheck.ObjectCount && ObjectEnumerationIndex == SyncCheck.ObjectEnumerationIndex && AllCrewPosX == SyncCheck.AllCrewPosX, "Objects");
+	check(SectShapeSum == SyncCheck.SectShapeSum, "Sectors");
+	check((!fHashes || PXSHash == SyncCheck.PXSHash) && PXSCount == SyncCheck.PXSCount, "PXS");
+	check(MassMoverIndex == SyncCheck.MassMoverIndex, "MassMover");
+	check(!fHashes || ScriptHash == SyncCheck.ScriptHash, "Script");
+	if (!strDiverging.empty())
+		LogFatal(FormatString("Network: Diverging: %s", strDiverging.c_str()).getData());
+}
+
 void C4ControlSyncCheck::Execute() const
 {
 	// control host?
@@ -461,6 +586,11 @@ void C4ControlSyncCheck::Execute() const
 		return;
 	}
 
+	// records of older builds have no hashes to compare
+	const bool fHashesEqual = !HasExtControlFields()
+		|| (LandscapeHash == pSyncCheck->LandscapeHash && ObjectsHash == pSyncCheck->ObjectsHash
+			&& PXSHash == pSyncCheck->PXSHash && ScriptHash == pSyncCheck->ScriptHash);
+
 	// Not equal
 	if (Frame != pSyncCheck->Frame
 		|| (ControlTick           != pSyncCheck->ControlTick && !Game.Control.isReplay())
@@ -471,7 +601,8 @@ void C4ControlSyncCheck::Execute() const
 		|| MassMoverIndex         != pSyncCheck->MassMoverIndex
 		|| ObjectCount            != pSyncCheck->ObjectCount
 		|| ObjectEnumerationIndex != pSyncCheck->ObjectEnumerationIndex
-		|| SectShapeSum           != pSyncCheck->SectShapeSum)
+		|| SectShapeSum           != pSyncCheck->SectShapeSum
+		|| !fHashesEqual)
 	{
 		const char *szThis = "Client", *szOther = Game.Control.isReplay() ? "Rec " : "Host";
 		if (iByClient != Game.Control.ClientID())
@@ -482,6 +613,9 @@ void C4ControlSyncCheck::Execute() const
 		LogFatal("Network: Synchronization loss!");
 		LogFatal(FormatString("Network: %s Frm %i Ctrl %i Rnc %i Rn3 %i Cpx %i PXS %i MMi %i Obc %i Oei %i Sct %i", szThis,            Frame,           ControlTick,           RandomCount,           Random3,           AllCrewPosX,           PXSCount,           MassMoverIndex,           ObjectCount,           ObjectEnumerationIndex,           SectShapeSum).getData());
 		LogFatal(FormatString("Network: %s Frm %i Ctrl %i Rnc %i Rn3 %i Cpx %i PXS %i MMi %i Obc %i Oei %i Sct %i", szOther, SyncCheck.Frame, SyncCheck.ControlTick, SyncCheck.RandomCount, SyncCheck.Random3, SyncCheck.AllCrewPosX, SyncCheck.PXSCount, SyncCheck.MassMoverIndex, SyncCheck.ObjectCount, SyncCheck.ObjectEnumerationIndex, SyncCheck.SectShapeSum).getData());
+		LogFatal(FormatString("Network: %s Lsh %08x Obh %08x PXh %08x Sch %08x", szThis,            LandscapeHash,           ObjectsHash,           PXSHash,           ScriptHash).getData());
+		LogFatal(FormatString("Network: %s Lsh %08x Obh %08x PXh %08x Sch %08x", szOther, SyncCheck.LandscapeHash, SyncCheck.ObjectsHash, SyncCheck.PXSHash, SyncCheck.ScriptHash).getData());
+		LogDivergence(SyncCheck);
 		StartSoundEffect("SyncError");
 #ifndef NDEBUG
 		// Debug safe
@@ -513,6 +647,13 @@ void C4ControlSyncCheck::CompileFunc(StdCompiler *pComp)
 	pComp->Value(mkNamingAdapt(mkIntPackAdapt(ObjectCount),            "ObjectCount",             0));
 	pComp->Value(mkNamingAdapt(mkIntPackAdapt(ObjectEnumerationIndex), "ObjectEnumerationIndex",  0));
 	pComp->Value(mkNamingAdapt(mkIntPackAdapt(SectShapeSum),           "SectShapeSum",            0));
+	if (HasExtControlFields())
+	{
+		pComp->Value(mkNamingAdapt(LandscapeHash,                      "LandscapeHash",           0u));
+		pComp->Value(mkNamingAdapt(ObjectsHash,                        "ObjectsHash",             0u));
+		pComp->Value(mkNamingAdapt(PXSHash,                            "PXSHash",                 0u));
+		pComp->Value(mkNamingAdapt(ScriptHash,                         "ScriptHash",              0u));
+	}
 	C4ControlPacket::CompileFunc(pComp);
 }
 
@@ -520,7 +661,14 @@ void C4ControlSyncCheck::CompileFunc(StdCompiler *pComp)
 
 void C4ControlSynchronize::Execute() const
 {
-	Game.Synchronize(fSavePlrFiles);
+	// keyframes must not change the game, so they can't abort coroutines
+	if (fKeyframe && Game.ScriptEngine.AnyCoroutineRunning())
+	{
+		LogSilentF("Network: Keyframe synchronization skipped (Frame %i), script coroutines are running", Game.FrameCounter);
+		Game.Control.OnKeyframeSkipped();
+		return;
+	}
+	Game.Synchronize(fSavePlrFiles, fKeyframe);
 	if (fSyncClearance) Game.SyncClearance();
 }
 
@@ -528,6 +676,8 @@ void C4ControlSynchronize::CompileFunc(StdCompiler *pComp)
 {
 	pComp->Value(mkNamingAdapt(fSavePlrFiles,  "SavePlrs",  false));
 	pComp->Value(mkNamingAdapt(fSyncClearance, "SyncClear", false));
+	if (HasExtControlFields())
+		pComp->Value(mkNamingAdapt(fKeyframe,  "Keyframe",  false));
 	C4ControlPacket::CompileFunc(pComp);
 }
 
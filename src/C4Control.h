@@ -27,6 +27,7 @@
 #include <string>
 
 class C4Record;
+class C4Value;
 
 // *** control base classes
 
@@ -208,6 +209,10 @@ protected:
 	int32_t ObjectCount;
 	int32_t ObjectEnumerationIndex;
 	int32_t SectShapeSum;
+	uint32_t LandscapeHash;
+	uint32_t ObjectsHash;
+	uint32_t PXSHash;
+	uint32_t ScriptHash;
 
 public:
 	void Set();
@@ -217,16 +222,21 @@ public:
 
 protected:
 	static int32_t GetAllCrewPosX();
+	static uint32_t GetObjectsHash();
+	static uint32_t GetScriptHash();
+	static void AddValueHash(uint32_t &dwHash, const C4Value &rValue, int32_t iDepth = 0);
+	void LogDivergence(const C4ControlSyncCheck &SyncCheck) const;
 };
 
 class C4ControlSynchronize : public C4ControlPacket // sync
 {
 public:
-	C4ControlSynchronize(bool fSavePlrFiles = false, bool fSyncClearance = false)
-		: fSavePlrFiles(fSavePlrFiles), fSyncClearance(fSyncClearance) {}
+	C4ControlSynchronize(bool fSavePlrFiles = false, bool fSyncClearance = false, bool fKeyframe = false)
+		: fSavePlrFiles(fSavePlrFiles), fSyncClearance(fSyncClearance), fKeyframe(fKeyframe) {}
 
 protected:
 	bool fSavePlrFiles, fSyncClearance;
+	bool fKeyframe; // for a record keyframe: keeps the random sequence, skipped while coroutines run
 
 public:
 	DECLARE_C4CONTROL_VIRTUALS
@@ -446,6 +446,9 @@ LONG WINAPI GenerateDump(EXCEPTION_POINTERS *pExceptionPointers)
 		strcat(buffer, "to the developers.");
 	}
 
+	// Pending log lines first
+	FlushLogOnCrash();
+
 	// Write dump (human readable format)
 	if (GetLogFD() != -1)
 	{
@@ -30,6 +30,7 @@
 #include <C4Wrappers.h>
 #include <C4Object.h>
 #include "C4Network2Res.h"
+#include <StdSha1.h>
 
 #include <algorithm>
 
@@ -209,8 +210,19 @@ bool C4DefCore::Load(C4Group &hGroup)
 	if (hGroup.LoadEntryString(C4CFN_DefCore, Source))
 	{
 		StdStrBuf Name = hGroup.GetFullName() + FormatString("%cDefCore.txt", DirectorySeparator);
-		if (!Compile(Source.getData(), Name.getData()))
-			return false;
+		// Use cached parse if the source has not changed
+		C4DefCoreCache *pCache = Config.Developer.DefCoreCache ? &Game.Defs.CoreCache : nullptr;
+		if (pCache && pCache->Lookup(Source, *this))
+		{
+			if (Config.Developer.DefCoreCacheVerify)
+				pCache->Verify(Source, *this, Name.getData());
+		}
+		else
+		{
+			if (!Compile(Source.getData(), Name.getData()))
+				return false;
+			if (pCache) pCache->Store(Source, *this);
+		}
 		Source.Clear();
 
 		// Adjust category: C4D_CrewMember by CrewMember flag
@@ -246,6 +258,117 @@ bool C4DefCore::Compile(const char *szSource, const char *szName)
 	return CompileFromBuf_LogWarn<StdCompilerINIRead>(mkNamingAdapt(*this, "DefCore"), StdStrBuf::MakeRef(szSource), szName);
 }
 
+// C4DefCoreCache
+
+C4DefCoreCache::C4DefCoreCache()
+{
+	Clear();
+}
+
+void C4DefCoreCache::Clear()
+{
+	Entries.clear();
+	UsedKeys.clear();
+	fLoaded = fChanged = false;
+	ResetStats();
+}
+
+bool C4DefCoreCache::Load(const char *szFilename)
+{
+	// Only read once; entries stored later stay in memory for the next round
+	if (fLoaded) return true;
+	fLoaded = true;
+	StdBuf Buf;
+	if (!Buf.LoadFromFile(szFilename)) return false;
+	try
+	{
+		CompileFromBuf<StdCompilerBinRead>(mkSTLMapAdapt(Entries), Buf);
+	}
+	catch (const StdCompiler::Exception &)
+	{
+		// Corrupt or outdated file: rebuild
+		LogSilentF("DefCore cache: Discarding unreadable %s", szFilename);
+		Entries.clear();
+		fChanged = true;
+		return false;
+	}
+	return true;
+}
+
+bool C4DefCoreCache::Save(const char *szFilename)
+{
+	// Evict entries of deleted or changed definitions, so the file does not grow forever
+	if (std::erase_if(Entries, [this](const auto &entry) { return !UsedKeys.contains(entry.first); }))
+		fChanged = true;
+	if (!fChanged) return true;
+	StdBuf Buf = DecompileToBuf<StdCompilerBinWrite>(mkSTLMapAdapt(Entries));
+	if (!Buf.SaveToFile(szFilename)) return false;
+	fChanged = false;
+	return true;
+}
+
+std::string C4DefCoreCache::GetKey(const StdStrBuf &Source)
+{
+	// Engine version is part of the key, so entries written by another build are never used
+	StdSha1 Sha1;
+	Sha1.Update(C4VERSION, SLen(C4VERSION));
+	Sha1.Update(Source.getData(), Source.getLength());
+	uint8_t Hash[StdSha1::DigestLength];
+	Sha1.GetHash(Hash);
+	std::string Key;
+	for (const auto byte : Hash)
+		Key += FormatString("%02x", byte).getData();
+	return Key;
+}
+
+bool C4DefCoreCache::Lookup(const StdStrBuf &Source, C4DefCore &rDefCore)
+{
+	std::string Key = GetKey(Source);
+	const auto it = Entries.find(Key);
+	if (it == Entries.end()) { ++Misses; return false; }
+	try
+	{
+		CompileFromBuf<StdCompilerBinRead>(rDefCore, it->second);
+	}
+	catch (const StdCompiler::Exception &)
+	{
+		// Stale entry: drop it and parse the source again
+		Entries.erase(it);
+		fChanged = true;
+		rDefCore.Default();
+		++Misses;
+		return false;
+	}
+	UsedKeys.insert(std::move(Key));
+	++Hits;
+	return true;
+}
+
+void C4DefCoreCache::Store(const StdStrBuf &Source, C4DefCore &rDefCore)
+{
+	std::string Key = GetKey(Source);
+	Entries[Key] = DecompileToBuf<StdCompilerBinWrite>(rDefCore);
+	UsedKeys.insert(std::move(Key));
+	fChanged = true;
+}
+
+bool C4DefCoreCache::Verify(const StdStrBuf &Source, C4DefCore &rDefCore, const char *szName)
+{
+	C4DefCore Fresh;
+	if (!CompileFromBuf_LogWarn<StdCompilerINIRead>(mkNamingAdapt(Fresh, "DefCore"), Source, szName))
+		return false;
+	StdBuf FreshBuf = DecompileToBuf<StdCompilerBinWrite>(Fresh);
+	if (FreshBuf == DecompileToBuf<StdCompilerBinWrite>(rDefCore))
+		return true;
+	// Mismatch: use and cache the fresh parse
+	LogF("DefCore cache: Cached data for %s differs from source!", szName);
+	++Mismatches;
+	CompileFromBuf<StdCompilerBinRead>(rDefCore, FreshBuf);
+	Entries[GetKey(Source)] = std::move(FreshBuf);
+	fChanged = true;
+	return false;
+}
+
 void C4DefCore::CompileFunc(StdCompiler *pComp)
 {
 	pComp->Value(mkNamingAdapt(mkC4IDAdapt(id),               "id",         C4ID_None));
@@ -487,6 +610,7 @@ void C4Def::Default()
 	iNumRankSymbols = 1;
 	PortraitCount = 0;
 	Portraits = nullptr;
+	GraphicsStamp = {};
 	pFairCrewPhysical = nullptr;
 	Scale = 1.0f;
 }
@@ -499,6 +623,7 @@ C4Def::~C4Def()
 void C4Def::Clear()
 {
 	Graphics.Clear();
+	GraphicsStamp = {};
 
 	Script.Clear();
 	StringTable.Clear();
@@ -597,11 +722,17 @@ bool C4Def::Load(C4Group &hGroup,
 
 	// Read surface bitmap
 	if (dwLoadWhat & C4D_Load_Bitmap)
-		if (!Graphics.LoadAllGraphics(hGroup, !!ColorByOwner))
-		{
-			DebugLogF("  Error loading graphics of %s (%s)", hGroup.GetFullName().getData(), C4IdText(id));
-			return false;
-		}
+	{
+		// Graphics colorized by material are modified after loading and can't be reused
+		if (Config.Developer.RetainDefGraphics && !*ColorByMaterial)
+			GraphicsStamp.Get(hGroup, !!ColorByOwner);
+		if (!Game.Defs.AdoptRetainedGraphics(*this))
+			if (!Graphics.LoadAllGraphics(hGroup, !!ColorByOwner))
+			{
+				DebugLogF("  Error loading graphics of %s (%s)", hGroup.GetFullName().getData(), C4IdText(id));
+				return false;
+			}
+	}
 
 	// Read portraits
 	if (dwLoadWhat & C4D_Load_Bitmap)
@@ -887,7 +1018,7 @@ void C4Def::Synchronize()
 
 // C4DefList
 
-C4DefList::C4DefList()
+C4DefList::C4DefList() : RetainedGraphicsHits(0), RetainedGraphicsBytes(0), RetainedGraphicsTime(0)
 {
 	Clear();
 }
@@ -895,6 +1026,7 @@ C4DefList::C4DefList()
 C4DefList::~C4DefList()
 {
 	Clear();
+	ClearRetainedGraphics();
 }
 
 int32_t C4DefList::Load(C4Group &hGroup, uint32_t dwLoadWhat,
@@ -1105,13 +1237,62 @@ void C4DefList::Remove(C4Def *def)
 	}
 }
 
-void C4DefList::Clear()
+void C4DefList::Clear(bool fRetainGraphics)
 {
+	if (fRetainGraphics)
+	{
+		// Move graphics out of the defs before they are destroyed
+		// Everything else is reloaded, so per-round state starts fresh
+		for (const auto &def : Defs)
+		{
+			if (!def->GraphicsStamp.fValid) continue;
+			auto &entry = RetainedGraphics[def->Filename];
+			entry.Stamp = def->GraphicsStamp;
+			entry.Graphics = std::make_unique<C4DefGraphics>();
+			entry.Graphics->TakeGraphics(def->Graphics);
+			def->Portraits = nullptr; def->PortraitCount = 0;
+		}
+		RetainedGraphicsBytes = GetRetainedGraphicsBytes();
+		RetainedGraphicsTime = timeGetTime();
+	}
 	Defs.clear();
 	LoadFailure = false;
 	Sorted = false;
 }
 
+bool C4DefList::AdoptRetainedGraphics(C4Def &rDef)
+{
+	if (!rDef.GraphicsStamp.fValid) return false;
+	const auto it = RetainedGraphics.find(rDef.Filename);
+	if (it == RetainedGraphics.end()) return false;
+	// Group changed since the graphics were loaded? Load them again
+	if (!(it->second.Stamp == rDef.GraphicsStamp))
+	{
+		RetainedGraphics.erase(it);
+		return false;
+	}
+	rDef.Graphics.TakeGraphics(*it->second.Graphics);
+	RetainedGraphics.erase(it);
+	++RetainedGraphicsHits;
+	return true;
+}
+
+void C4DefList::ClearRetainedGraphics()
+{
+	RetainedGraphics.clear();
+	RetainedGraphicsHits = 0;
+	RetainedGraphicsBytes = 0;
+	RetainedGraphicsTime = 0;
+}
+
+size_t C4DefList::GetRetainedGraphicsBytes() const
+{
+	size_t iBytes = 0;
+	for (const auto &[filename, entry] : RetainedGraphics)
+		iBytes += entry.Graphics->GetBitmapBytes();
+	return iBytes;
+}
+
 C4Def *C4DefList::ID2Def(C4ID id)
 {
 	if (id == C4ID_None) return nullptr;
@@ -36,6 +36,9 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 const int32_t C4D_None                   = 0,
@@ -303,6 +306,33 @@ protected:
 	bool Compile(const char *szSource, const char *szName);
 };
 
+// Binary copies of parsed DefCore.txt files, keyed by a hash of the source and engine version
+class C4DefCoreCache
+{
+public:
+	C4DefCoreCache();
+
+public:
+	int32_t Hits, Misses, Mismatches;
+
+public:
+	void Clear();
+	bool Load(const char *szFilename);
+	bool Save(const char *szFilename); // drops entries that were not used since the cache was loaded
+	bool Lookup(const StdStrBuf &Source, C4DefCore &rDefCore);
+	void Store(const StdStrBuf &Source, C4DefCore &rDefCore);
+	bool Verify(const StdStrBuf &Source, C4DefCore &rDefCore, const char *szName); // returns false if cached data differs from a fresh parse
+	void ResetStats() { Hits = Misses = Mismatches = 0; }
+
+protected:
+	std::string GetKey(const StdStrBuf &Source);
+
+private:
+	std::unordered_map<std::string, StdBuf> Entries;
+	std::unordered_set<std::string> UsedKeys; // looked up or stored in this session
+	bool fLoaded, fChanged;
+};
+
 class C4Def : public C4DefCore
 {
 	friend class C4DefList;
@@ -330,6 +360,7 @@ public:
 	C4FacetExSurface *pRankSymbols; bool fRankSymbolsOwned;
 	int32_t iNumRankSymbols; // number of rank symbols available, if loaded
 	C4DefGraphics Graphics; // base graphics. points to additional graphics
+	C4DefGraphicsStamp GraphicsStamp; // entries Graphics were loaded from; only valid if they may be retained
 	int32_t PortraitCount;
 	C4PortraitGraphics *Portraits; // Portraits (linked list of C4AdditionalDefGraphics)
 	float Scale;
@@ -383,9 +414,17 @@ public:
 
 public:
 	bool LoadFailure;
+	C4DefCoreCache CoreCache; // kept over Clear() so later rounds can reuse it
+	int32_t RetainedGraphicsHits; // defs that adopted retained graphics since the last ClearRetainedGraphics()
+	size_t RetainedGraphicsBytes; // bitmap memory held by retained graphics when they were stored
+	uint32_t RetainedGraphicsTime; // timeGetTime() when graphics were retained
 
 public:
-	void Clear();
+	void Clear(bool fRetainGraphics = false); // if set, graphics of unchanged defs are kept for the next Load
+	bool AdoptRetainedGraphics(C4Def &rDef); // hand retained graphics to a def loaded from the same, unchanged group
+	void ClearRetainedGraphics(); // free graphics that have not been adopted
+	int32_t GetRetainedGraphicsCount() const { return static_cast<int32_t>(RetainedGraphics.size()); }
+	size_t GetRetainedGraphicsBytes() const; // bitmap memory held by graphics not adopted yet
 	int32_t Load(C4Group &hGroup,
 		uint32_t dwLoadWhat, const char *szLanguage,
 		C4SoundSystem *pSoundSystem = nullptr,
@@ -420,6 +459,13 @@ private:
 	std::vector<std::unique_ptr<C4Def>> Defs;
 	bool Sorted;
 
+	struct RetainedGraphicsEntry
+	{
+		C4DefGraphicsStamp Stamp;
+		std::unique_ptr<C4DefGraphics> Graphics;
+	};
+	std::unordered_map<std::string, RetainedGraphicsEntry> RetainedGraphics; // by def filename; kept over Clear()
+
 public:
 	using Iterable = ConstIterableMember<&C4DefList::Defs>;
 };
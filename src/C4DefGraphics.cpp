@@ -32,6 +32,21 @@
 #include <C4Player.h>
 #include <C4Log.h>
 
+// C4DefGraphicsStamp
+
+void C4DefGraphicsStamp::Get(C4Group &hGroup, bool fColorByOwner)
+{
+	// all entries LoadAllGraphics may read: graphics, overlays and portraits
+	CRC = 0; Size = 0;
+	for (const char *szWildcard : { "Graphics*", "Overlay*", C4CFN_Portraits })
+	{
+		CRC = CRC * 31 + hGroup.EntryCRC32(szWildcard);
+		Size += hGroup.EntrySize(szWildcard);
+	}
+	this->fColorByOwner = fColorByOwner;
+	fValid = true;
+}
+
 // C4DefGraphics
 
 C4DefGraphics::C4DefGraphics(C4Def *pOwnDef)
@@ -268,6 +283,29 @@ bool C4DefGraphics::CopyGraphicsFrom(C4DefGraphics &rSource)
 	return true;
 }
 
+void C4DefGraphics::TakeGraphics(C4DefGraphics &rSource)
+{
+	// clear previous
+	Clear();
+	// move bitmaps and additional graphics over
+	Bitmap = std::exchange(rSource.Bitmap, nullptr);
+	BitmapClr = std::exchange(rSource.BitmapClr, nullptr);
+	fColorBitmapAutoCreated = std::exchange(rSource.fColorBitmapAutoCreated, false);
+	pNext = std::exchange(rSource.pNext, nullptr);
+	// additional graphics belong to this def now
+	for (C4DefGraphics *pGfx = pNext; pGfx; pGfx = pGfx->pNext)
+		pGfx->pDef = pDef;
+}
+
+size_t C4DefGraphics::GetBitmapBytes()
+{
+	size_t iBytes = 0;
+	for (C4DefGraphics *pGfx = this; pGfx; pGfx = pGfx->pNext)
+		for (C4Surface *pSfc : { pGfx->Bitmap, pGfx->BitmapClr })
+			if (pSfc) iBytes += static_cast<size_t>(pSfc->Wdt) * pSfc->Hgt * 4;
+	return iBytes;
+}
+
 void C4DefGraphics::DrawClr(C4Facet &cgo, bool fAspect, uint32_t dwClr)
 {
 	// create facet and draw it
@@ -279,8 +317,14 @@ void C4DefGraphics::DrawClr(C4Facet &cgo, bool fAspect, uint32_t dwClr)
 void C4DefGraphicsAdapt::CompileFunc(StdCompiler *pComp)
 {
 	bool fCompiler = pComp->isCompiler();
-	// nothing?
-	if (!fCompiler && !pDefGraphics) return;
+	// nothing? Binary compilers can't omit it, so they store a flag
+	if (!pComp->hasNaming())
+	{
+		bool fNull = !pDefGraphics;
+		pComp->Value(fNull);
+		if (fNull) { pDefGraphics = nullptr; return; }
+	}
+	else if (!fCompiler && !pDefGraphics) return;
 	// definition
 	C4ID id; if (!fCompiler) id = pDefGraphics->pDef->id;
 	pComp->Value(mkC4IDAdapt(id));
@@ -888,6 +932,12 @@ void C4GraphicsOverlayListAdapt::CompileFunc(StdCompiler *pComp)
 		// read the whole list
 		C4GraphicsOverlay *pLast = nullptr;
 		bool fContinue;
+		// binary: an empty list is a single false flag
+		if (!fNaming)
+		{
+			pComp->Value(fContinue);
+			if (!fContinue) return;
+		}
 		do
 		{
 			C4GraphicsOverlay *pNext = new C4GraphicsOverlay();
@@ -926,11 +976,13 @@ void C4GraphicsOverlayListAdapt::CompileFunc(StdCompiler *pComp)
 		for (C4GraphicsOverlay *pPos = pOverlay; pPos; pPos = pPos->GetNext())
 		{
 			// separate
-			if (pPos != pOverlay)
-				if (fNaming)
+			if (fNaming)
+			{
+				if (pPos != pOverlay)
 					pComp->Separator(StdCompiler::SEP_SEP2);
-				else
-					pComp->Value(fContinue);
+			}
+			else
+				pComp->Value(fContinue);
 			// write
 			pComp->Value(*pPos);
 		}
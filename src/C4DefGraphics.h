@@ -34,6 +34,18 @@ class C4AdditionalDefGraphics;
 class C4DefGraphicsPtrBackup;
 class C4PortraitGraphics;
 
+// identifies the graphics entries of a definition group, so unchanged graphics can be reused by later rounds
+struct C4DefGraphicsStamp
+{
+	uint32_t CRC = 0;
+	int32_t Size = 0;
+	bool fColorByOwner = false;
+	bool fValid = false; // only set for graphics that may be retained
+
+	void Get(C4Group &hGroup, bool fColorByOwner);
+	bool operator==(const C4DefGraphicsStamp &) const = default;
+};
+
 class C4DefGraphics
 {
 public:
@@ -63,6 +75,8 @@ public:
 	}
 
 	bool CopyGraphicsFrom(C4DefGraphics &rSource); // copy bitmaps from source graphics
+	void TakeGraphics(C4DefGraphics &rSource); // take over bitmaps and additional graphics of source; source is left empty
+	size_t GetBitmapBytes(); // approximate memory used by all bitmaps including additional graphics
 
 	virtual const char *GetName() { return nullptr; } // return name to be stored in safe game files
 
@@ -509,7 +509,7 @@ void C4Effect::CompileFunc(StdCompiler *pComp)
 	pComp->Value(mkC4IDAdapt(idCommandTarget));
 	pComp->Separator(StdCompiler::SEP_END); // ')'
 	// read variables
-	if (pComp->isCompiler() || EffectVars.GetSize() > 0)
+	if (pComp->isCompiler() || !pComp->hasNaming() || EffectVars.GetSize() > 0)
 		if (pComp->Separator(StdCompiler::SEP_START2)) // '['
 		{
 			pComp->Value(EffectVars);
@@ -42,6 +42,16 @@ void C4EnumeratedObjectPtr::Denumerate()
 	}
 }
 
+void C4TargetObjectPtr::Register()
+{
+	if (holder && Object()) Game.Objects.AddReferrer(Object(), holder);
+}
+
+void C4TargetObjectPtr::Unregister()
+{
+	if (holder && Object()) Game.Objects.RemoveReferrer(Object(), holder);
+}
+
 void C4EnumeratedObjectPtr::CompileFunc(StdCompiler *compiler, bool intPack)
 {
 	if (intPack)
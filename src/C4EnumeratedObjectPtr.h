@@ -72,13 +72,67 @@ public:
 	void CompileFunc(StdCompiler *compiler, bool intPack = false);
 };
 
+// An enumerated pointer to the target of an action or command.
+// Registers its holder as a referrer of the target with Game.Objects.
+class C4TargetObjectPtr : public C4EnumeratedObjectPtr
+{
+private:
+	C4Object *holder{};
+
+public:
+	C4TargetObjectPtr() = default;
+	C4TargetObjectPtr(const C4TargetObjectPtr &) = delete;
+	~C4TargetObjectPtr() { Unregister(); }
+
+	C4TargetObjectPtr &operator=(const C4TargetObjectPtr &other) { return *this = static_cast<const C4EnumeratedObjectPtr &>(other); }
+	C4TargetObjectPtr &operator=(const C4EnumeratedObjectPtr &other)
+	{
+		Unregister();
+		C4EnumeratedObjectPtr::operator=(other);
+		Register();
+		return *this;
+	}
+	C4TargetObjectPtr &operator=(C4Object *obj)
+	{
+		Unregister();
+		C4EnumeratedObjectPtr::operator=(obj);
+		Register();
+		return *this;
+	}
+	C4TargetObjectPtr &operator=(std::nullptr_t) { Reset(); return *this; }
+
+	C4Object *Holder() const noexcept { return holder; }
+	void SetHolder(C4Object *newHolder)
+	{
+		Unregister();
+		holder = newHolder;
+		Register();
+	}
+
+	void Reset()
+	{
+		Unregister();
+		C4EnumeratedObjectPtr::Reset();
+	}
+	void Denumerate()
+	{
+		Unregister();
+		C4EnumeratedObjectPtr::Denumerate();
+		Register();
+	}
+
+private:
+	void Register();
+	void Unregister();
+};
+
 namespace
 {
 	template<typename... Args>
 	constexpr void CheckArgs(Args &... args) noexcept
 	{
 		static_assert(sizeof...(args) > 0, "At least one argument is required");
-		static_assert((std::is_same_v<Args, C4EnumeratedObjectPtr> && ...), "Only C4EnumeratedObjectPtr& can be passed as arguments");
+		static_assert((std::is_base_of_v<C4EnumeratedObjectPtr, Args> && ...), "Only C4EnumeratedObjectPtr& can be passed as arguments");
 	}
 }
 
@@ -297,6 +297,14 @@ void C4Facet::DrawX(C4Surface *sfcTarget, int32_t iX, int32_t iY, int32_t iWdt,
 		true);
 }
 
+void C4Facet::BatchX(int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt, int32_t iSectionX, int32_t iSectionY) const
+{
+	if (!lpDDraw || !Surface || !Wdt || !Hgt) return;
+	lpDDraw->BatchBlit(Surface,
+		float(X + Wdt * iSectionX), float(Y + Hgt * iSectionY), float(Wdt), float(Hgt),
+		iX, iY, iWdt, iHgt);
+}
+
 void C4Facet::DrawXFloat(C4Surface *sfcTarget, float fX, float fY, float fWdt, float fHgt) const
 {
 	if (!lpDDraw || !Surface || !sfcTarget || !Wdt || !Hgt || fWdt <= 0 || fHgt <= 0) return;
@@ -413,7 +421,7 @@ void C4DrawTransform::CompileFunc(StdCompiler *pComp)
 	}
 	pComp->Separator();
 	pComp->Value(FlipDir);
-	if (!fCompiler && mat[6] == 0 && mat[7] == 0 && mat[8] == 1) return;
+	if (!fCompiler && pComp->hasNaming() && mat[6] == 0 && mat[7] == 0 && mat[8] == 1) return;
 	// because of backwards-compatibility, the last row comes after flipdir
 	for (i = 6; i < 9; ++i)
 	{
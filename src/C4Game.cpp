@@ -51,10 +51,14 @@
 
 #include <StdFile.h>
 #include <StdGL.h>
+#include <StdNoGfx.h>
 
+#include <algorithm>
 #include <iterator>
+#include <optional>
 #include <sstream>
 #include <utility>
+#include <vector>
 
 constexpr unsigned int defaultIngameGameTickDelay = 28;
 
@@ -78,6 +82,17 @@ bool C4Game::InitDefs()
 {
 	int32_t iDefs = 0;
 	Log(LoadResStr("IDS_PRC_INITDEFS"));
+	// Parsed DefCores of previous runs
+	const bool fDefCoreCache = Config.Developer.DefCoreCache;
+	if (fDefCoreCache)
+	{
+		Defs.CoreCache.Load(Config.AtUserPath(C4CFN_DefCoreCache));
+		Defs.CoreCache.ResetStats();
+	}
+	const uint32_t tLoadStart = timeGetTime();
+	// Decode graphics in parallel; all surfaces are complete when the queue is destroyed
+	std::optional<C4SurfaceLoadQueue> LoadQueue;
+	if (Config.Developer.DefLoadThreads != 1) LoadQueue.emplace(Config.Developer.DefLoadThreads);
 	int iDefResCount = 0;
 	for ([[maybe_unused]] const auto &def : Parameters.GameRes.iterRes(NRT_Definitions))
 		++iDefResCount;
@@ -100,6 +115,37 @@ bool C4Game::InitDefs()
 	// Absolutely no defs: we don't like that
 	if (!iDefs) { LogFatal(LoadResStr("IDS_PRC_NODEFS")); return false; }
 
+	// Finish pending graphics and report load time
+	int32_t iLoadThreads = 0, iDecodeCount = 0;
+	if (LoadQueue)
+	{
+		LoadQueue->FinishAll();
+		iLoadThreads = LoadQueue->GetThreadCount(); iDecodeCount = LoadQueue->GetDecodeCount();
+		LoadQueue.reset();
+	}
+	LogSilentF("Definitions: %d loaded in %u ms (%d decode threads, %d graphics decoded in parallel)",
+		iDefs, timeGetTime() - tLoadStart, iLoadThreads, iDecodeCount);
+
+	// Graphics retained from the previous round that were not adopted belong to changed or removed defs
+	if (Defs.RetainedGraphicsTime)
+	{
+		const size_t iUnusedBytes = Defs.GetRetainedGraphicsBytes();
+		LogSilentF("Definition graphics: %d reused, %d discarded; %u KB retained, %u KB still in use; restart took %u ms",
+			Defs.RetainedGraphicsHits, Defs.GetRetainedGraphicsCount(),
+			static_cast<unsigned int>(Defs.RetainedGraphicsBytes / 1024), static_cast<unsigned int>((Defs.RetainedGraphicsBytes - iUnusedBytes) / 1024),
+			timeGetTime() - Defs.RetainedGraphicsTime);
+	}
+	Defs.ClearRetainedGraphics();
+
+	// Store new parses for the next start
+	if (fDefCoreCache)
+	{
+		LogSilentF("DefCore cache: %d cached, %d parsed, %d mismatches",
+			Defs.CoreCache.Hits, Defs.CoreCache.Misses, Defs.CoreCache.Mismatches);
+		if (!Defs.CoreCache.Save(Config.AtUserPath(C4CFN_DefCoreCache)))
+			LogSilentF("DefCore cache: Could not save %s", C4CFN_DefCoreCache);
+	}
+
 	// Check def engine version (should be done immediately on def load)
 	iDefs = Defs.CheckEngineVersion(C4XVER1, C4XVER2, C4XVER3, C4XVER4, C4XVERBUILD);
 	if (iDefs > 0) { LogF(LoadResStr("IDS_PRC_DEFSINVC4X"), iDefs); }
@@ -565,7 +611,7 @@ void C4Game::Clear()
 	Weather.Clear();
 	GraphicsSystem.Clear();
 	DeleteObjects(true);
-	Defs.Clear();
+	Defs.Clear(Config.Developer.RetainDefGraphics);
 	Landscape.Clear();
 	PXS.Clear();
 	delete pGlobalEffects; pGlobalEffects = nullptr;
@@ -595,6 +641,7 @@ void C4Game::Clear()
 	ScenarioSysLangStringTable.Clear();
 	CloseScenario();
 	GroupSet.Clear();
+	KeyboardInput.LogDispatchStats();
 	KeyboardInput.Clear();
 
 	if (Application.MusicSystem)
@@ -735,6 +782,8 @@ C4ST_NEW(LandscapeStat,   "C4Game::Execute Landscape.Execute")
 C4ST_NEW(MusicSystemStat, "C4Game::Execute MusicSystem.Execute")
 C4ST_NEW(MessagesStat,    "C4Game::Execute Messages.Execute")
 C4ST_NEW(ScriptStat,      "C4Game::Execute Script.Execute")
+C4ST_NEW(CoroutineStat,   "C4Game::Execute ScriptEngine.ExecuteCoroutines")
+C4ST_NEW(CrossCheckStat,  "C4Game::ExecObjects Objects.CrossCheck")
 
 #define EXEC_S(Expressions, Stat) \
 	{ C4ST_START(Stat) Expressions C4ST_STOP(Stat) }
@@ -794,6 +843,7 @@ bool C4Game::Execute() // Returns true if the game is over
 	EXEC_S_DR(Application.MusicSystem->Execute();, MusicSystemStat, "Music")
 	EXEC_S_DR(Messages.Execute();,                 MessagesStat,    "MsgEx")
 	EXEC_S_DR(Script.Execute();,                   ScriptStat,      "Scrpt")
+	EXEC_S_DR(ScriptEngine.ExecuteCoroutines();,   CoroutineStat,   "CoRtn")
 
 	EXEC_DR(MouseControl.Execute();, "Input")
 
@@ -809,11 +859,29 @@ bool C4Game::Execute() // Returns true if the game is over
 		if (!GameOverDlgShown) ShowGameOverDlg();
 	}
 
+	// contact check counters
+	C4Shape::ContactStats.NextFrame();
+
 	// show stat each 1000 ticks
 	if (!(FrameCounter % 1000))
 	{
 		C4ST_SHOWPARTSTAT
 		C4ST_RESETPART
+		if (Config.Developer.ContactCacheVerify)
+		{
+			C4ShapeContactStats &rStats = C4Shape::ContactStats;
+			LogSilentF("Contact checks: %u per frame, %u%% cached, %u mismatches", rStats.TotalChecks / 1000, rStats.TotalChecks ? static_cast<uint32_t>(uint64_t{rStats.TotalCacheHits} * 100 / rStats.TotalChecks) : 0u, rStats.Mismatches);
+			rStats.TotalChecks = rStats.TotalCacheHits = rStats.Mismatches = 0;
+		}
+		// draw calls of the headless renderer
+		if (auto *pNoGfx = dynamic_cast<CStdNoGfx *>(lpDDraw))
+		{
+			const CStdNoGfx::DrawCallStats &rDraw = pNoGfx->GetDrawCallStats();
+			if (rDraw.Blits || rDraw.Lines || rDraw.Pixels || rDraw.Quads)
+				LogSilentF("Draw calls since last report: %u blits, %u lines, %u pixels, %u quads; batches: %u lines, %u pixels, %u sprites",
+					rDraw.Blits, rDraw.Lines, rDraw.Pixels, rDraw.Quads, rDraw.LineBatches, rDraw.PixBatches, rDraw.SpriteBatches);
+			pNoGfx->ResetDrawCallStats();
+		}
 	}
 
 #ifdef DEBUGREC
@@ -973,6 +1041,7 @@ void C4Game::ClearPointers(C4Object *pObj)
 	BackObjects.ClearPointers(pObj);
 	ForeObjects.ClearPointers(pObj);
 	Messages.ClearPointers(pObj);
+	ScriptEngine.ClearCoroutinePointers(pObj);
 	ClearObjectPtrs(pObj);
 	Players.ClearPointers(pObj);
 	GraphicsSystem.ClearPointers(pObj);
@@ -1193,6 +1262,433 @@ C4Object *C4Game::CreateObjectConstruction(C4ID id,
 	return pObj;
 }
 
+// Search criteria shared by the legacy FindObject and ObjectCount
+struct C4LegacyFindCriteria
+{
+	C4ID id;
+	uint32_t ocf;
+	const char *szAction;
+	bool fFindActIdle;
+	C4Object *pActionTarget;
+	C4Object *pExclude;
+	C4Object *pContainer;
+	int32_t iOwner;
+
+	bool Match(C4Object *cObj) const
+	{
+		// Status
+		return cObj->Status
+			// ID
+			&& ((id == C4ID_None) || (cObj->Def->id == id))
+			// OCF (match any specified)
+			&& (cObj->OCF & ocf)
+			// Exclude
+			&& (cObj != pExclude)
+			// Action
+			&& (!szAction || !szAction[0] || (fFindActIdle && cObj->Action.Act <= ActIdle) || ((cObj->Action.Act > ActIdle) && SEqual(szAction, cObj->Def->ActMap[cObj->Action.Act].Name)))
+			// ActionTarget
+			&& (!pActionTarget || ((cObj->Action.Act > ActIdle) && ((cObj->Action.Target == pActionTarget) || (cObj->Action.Target2 == pActionTarget))))
+			// Container
+			&& (!pContainer || (cObj->Contained == pContainer) || ((reinterpret_cast<std::intptr_t>(pContainer) == NO_CONTAINER) && !cObj->Contained) || ((reinterpret_cast<std::intptr_t>(pContainer) == ANY_CONTAINER) && cObj->Contained))
+			// Owner
+			&& ((iOwner == ANY_OWNER) || (cObj->Owner == iOwner));
+	}
+
+	bool MatchPoint(C4Object *cObj, int32_t iX, int32_t iY) const
+	{
+		return Match(cObj)
+			&& Inside<int32_t>(iX - (cObj->x + cObj->Shape.x), 0, cObj->Shape.Wdt - 1)
+			&& Inside<int32_t>(iY - (cObj->y + cObj->Shape.y), 0, cObj->Shape.Hgt - 1);
+	}
+
+	bool MatchRange(C4Object *cObj, int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt) const
+	{
+		return Match(cObj)
+			&& Inside<int32_t>(cObj->x - iX, 0, iWdt - 1)
+			&& Inside<int32_t>(cObj->y - iY, 0, iHgt - 1);
+	}
+
+	// Full range, point or range; closest searches are resolved separately
+	bool MatchArea(C4Object *cObj, int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt) const
+	{
+		if (!iX && !iY && !iWdt && !iHgt) return Match(cObj);
+		if (!iWdt && !iHgt) return MatchPoint(cObj, iX, iY);
+		return MatchRange(cObj, iX, iY, iWdt, iHgt);
+	}
+};
+
+// Returns the candidate that comes first in the main object list.
+// If pAfter is given, only objects behind it are considered.
+static C4Object *FirstInListOrder(const std::vector<C4Object *> &Candidates, C4Object *pAfter)
+{
+	// the list scans never get past an object that is not in the main list
+	if (pAfter && !pAfter->ListOrder) return nullptr;
+	const uint64_t iAfter = pAfter ? pAfter->ListOrder : 0;
+	C4Object *pFirst = nullptr;
+	for (C4Object *cObj : Candidates)
+		if (cObj->ListOrder > iAfter && (!pFirst || cObj->ListOrder < pFirst->ListOrder))
+			pFirst = cObj;
+	return pFirst;
+}
+
+// Resolves a closest search from all matches that are not nearer than the last closest
+static C4Object *ResolveClosest(const std::vector<std::pair<C4Object *, int32_t>> &Candidates, int32_t iFartherThan, C4Object *pFindNext)
+{
+	std::vector<C4Object *> Matches;
+	// same distance as the last closest: first one behind it in list order
+	for (const auto &[cObj, iDistance] : Candidates)
+		if (iDistance == iFartherThan)
+			Matches.push_back(cObj);
+	if (C4Object *pResult = FirstInListOrder(Matches, pFindNext)) return pResult;
+	// closest; ties go to the first one in list order
+	bool fFound = false; int32_t iClosest = 0;
+	for (const auto &[cObj, iDistance] : Candidates)
+		if (iDistance > iFartherThan && (!fFound || iDistance < iClosest))
+		{
+			fFound = true; iClosest = iDistance;
+		}
+	Matches.clear();
+	if (fFound)
+		for (const auto &[cObj, iDistance] : Candidates)
+			if (iDistance == iClosest)
+				Matches.push_back(cObj);
+	return FirstInListOrder(Matches, nullptr);
+}
+
+// All objects of the main list whose action or commands target pTarget, each once
+static std::vector<C4Object *> GetReferrers(C4Object *pTarget)
+{
+	std::vector<C4Object *> Referrers;
+	if (const auto *pReferrers = Game.Objects.GetReferrers(pTarget))
+	{
+		Referrers = *pReferrers;
+		// the referrer index covers inactive objects as well, which the list scans never see
+		std::erase_if(Referrers, [](C4Object *cObj) { return cObj->Status != C4OS_NORMAL; });
+		std::sort(Referrers.begin(), Referrers.end());
+		Referrers.erase(std::unique(Referrers.begin(), Referrers.end()), Referrers.end());
+	}
+	return Referrers;
+}
+
+// Searches by action target only need to check the objects referring to it
+static C4Object *FindObjectInReferrers(const C4LegacyFindCriteria &Criteria, int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt, C4Object *pFindNext)
+{
+	std::vector<C4Object *> Candidates = GetReferrers(Criteria.pActionTarget);
+	// Closest
+	if ((iWdt == -1) && (iHgt == -1))
+	{
+		int32_t iFartherThan = -1;
+		if (pFindNext)
+			iFartherThan = (pFindNext->x - iX) * (pFindNext->x - iX) + (pFindNext->y - iY) * (pFindNext->y - iY);
+		std::vector<std::pair<C4Object *, int32_t>> Distances;
+		for (C4Object *cObj : Candidates)
+			if (Criteria.Match(cObj))
+			{
+				const int32_t iDistance = (cObj->x - iX) * (cObj->x - iX) + (cObj->y - iY) * (cObj->y - iY);
+				if (iDistance >= iFartherThan) Distances.emplace_back(cObj, iDistance);
+			}
+		return ResolveClosest(Distances, iFartherThan, pFindNext);
+	}
+	std::erase_if(Candidates, [&](C4Object *cObj) { return !Criteria.MatchArea(cObj, iX, iY, iWdt, iHgt); });
+	return FirstInListOrder(Candidates, pFindNext);
+}
+
+// Reports an indexed query that disagrees with the full list scan
+static void ObjectQueryMismatch(const char *szQuery)
+{
+	LogF("Object query mismatch in %s!", szQuery);
+	assert(!"Object query mismatch");
+}
+
+// Whether BlastObjects would affect any uncontained object
+static bool AnyBlastTarget(C4Object *cObj, int32_t tx, int32_t ty, int32_t level, C4Object *pLayer)
+{
+	if (!cObj->Status || cObj->Contained || cObj->pLayer != pLayer) return false;
+	// Direct hit
+	if (Inside<int32_t>(ty - (cObj->y + cObj->Shape.y), -5, cObj->Shape.Hgt - 1 + 10))
+		if (Inside<int32_t>(tx - (cObj->x + cObj->Shape.x), -5, cObj->Shape.Wdt - 1 + 10))
+			return true;
+	// Shock wave hit
+	if (!(cObj->Category & (C4D_Living | C4D_Object | C4D_Vehicle))) return false;
+	if (cObj->Def->NoHorizontalMove) return false;
+	if (Abs(ty - cObj->y) > level || Abs(tx - cObj->x) > level) return false;
+	if (cObj->Def->Grab != 1)
+	{
+		if (cObj->Category & C4D_Vehicle) return false;
+		if (cObj->Action.Act >= 0 && cObj->Def->ActMap[cObj->Action.Act].Procedure == DFA_FLOAT) return false;
+	}
+	return true;
+}
+
+// Whether ShakeObjects would roll the dice for any object
+static bool AnyShakeTarget(C4Object *cObj, int32_t tx, int32_t ty, int32_t range)
+{
+	return cObj->Status && !cObj->Contained && (cObj->Category & C4D_Living)
+		&& Abs(ty - cObj->y) <= range && Abs(tx - cObj->x) <= range;
+}
+
+// Sector pre-check of BlastObjects: false if no object can be hit
+static bool AnyBlastTargetInSectors(int32_t tx, int32_t ty, int32_t level, C4Object *pLayer)
+{
+	C4LSectors &Sectors = Game.Objects.Sectors;
+	if (!Sectors.Sectors || level > std::max(Sectors.PxWdt, Sectors.PxHgt)) return true;
+	C4LSector *pSct; C4ObjectLink *cLnk;
+	// Direct hits by shape
+	C4LArea HitArea(&Sectors, tx - 10, ty - 10, 16, 16);
+	for (C4ObjectList *pLst = HitArea.FirstObjectShapes(&pSct); pLst; pLst = HitArea.NextObjectShapes(pLst, &pSct))
+		for (cLnk = pLst->First; cLnk; cLnk = cLnk->Next)
+			if (AnyBlastTarget(cLnk->Obj, tx, ty, level, pLayer))
+				return true;
+	// Shock wave hits by position
+	if (level >= 0)
+	{
+		C4LArea WaveArea(&Sectors, tx - level, ty - level, 2 * level + 1, 2 * level + 1);
+		for (C4ObjectList *pLst = WaveArea.FirstObjects(&pSct); pLst; pLst = WaveArea.NextObjects(pLst, &pSct))
+			for (cLnk = pLst->First; cLnk; cLnk = cLnk->Next)
+				if (AnyBlastTarget(cLnk->Obj, tx, ty, level, pLayer))
+					return true;
+	}
+	return false;
+}
+
+// Sector pre-check of ShakeObjects: false if no object is in range
+static bool AnyShakeTargetInSectors(int32_t tx, int32_t ty, int32_t range)
+{
+	C4LSectors &Sectors = Game.Objects.Sectors;
+	if (!Sectors.Sectors || range > std::max(Sectors.PxWdt, Sectors.PxHgt)) return true;
+	if (range < 0) return false;
+	C4LArea Area(&Sectors, tx - range, ty - range, 2 * range + 1, 2 * range + 1); C4LSector *pSct;
+	for (C4ObjectList *pLst = Area.FirstObjects(&pSct); pLst; pLst = Area.NextObjects(pLst, &pSct))
+		for (C4ObjectLink *cLnk = pLst->First; cLnk; cLnk = cLnk->Next)
+			if (AnyShakeTarget(cLnk->Obj, tx, ty, range))
+				return true;
+	return false;
+}
+
+// Collects all objects matching a point or range search from the sectors.
+// Returns false for searches that are not bounded by an area.
+static bool CollectInSectors(const C4LegacyFindCriteria &Criteria, int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt, std::vector<C4Object *> &Candidates)
+{
+	C4LSectors &Sectors = Game.Objects.Sectors;
+	if (!Sectors.Sectors) return false;
+	C4ObjectLink *cLnk;
+	// Point: objects whose shape contains it
+	if (!iWdt && !iHgt)
+	{
+		// Full range
+		if (!iX && !iY) return false;
+		C4LSector *pSct = Sectors.SectorAt(iX, iY);
+		if (pSct->ObjectShapesOCF.May(Criteria.ocf))
+			for (cLnk = pSct->ObjectShapes.First; cLnk; cLnk = cLnk->Next)
+				if (Criteria.MatchPoint(cLnk->Obj, iX, iY))
+					Candidates.push_back(cLnk->Obj);
+		return true;
+	}
+	// Range: objects positioned inside it
+	if (iWdt <= 0 || iHgt <= 0) return false;
+	C4LArea Area(&Sectors, iX, iY, iWdt, iHgt); C4LSector *pSct;
+	for (C4ObjectList *pLst = Area.FirstObjects(&pSct); pLst; pLst = Area.NextObjects(pLst, &pSct))
+		if (pSct->ObjectsOCF.May(Criteria.ocf))
+			for (cLnk = pLst->First; cLnk; cLnk = cLnk->Next)
+				if (Criteria.MatchRange(cLnk->Obj, iX, iY, iWdt, iHgt))
+					Candidates.push_back(cLnk->Obj);
+	return true;
+}
+
+// Finds the first object in list order that matches a point or range search from the sectors.
+// The sector lists are in main list order, so each of them is only scanned up to its first match.
+// Returns false for searches that are not bounded by an area.
+static bool FindFirstInSectors(const C4LegacyFindCriteria &Criteria, int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt, C4Object *pFindNext, C4Object *&pResult)
+{
+	C4LSectors &Sectors = Game.Objects.Sectors;
+	if (!Sectors.Sectors) return false;
+	const bool fPoint = !iWdt && !iHgt;
+	// Full range
+	if (fPoint && !iX && !iY) return false;
+	if (!fPoint && (iWdt <= 0 || iHgt <= 0)) return false;
+	pResult = nullptr;
+	// the list scans never get past an object that is not in the main list
+	if (pFindNext && !pFindNext->ListOrder) return true;
+	const uint64_t iAfter = pFindNext ? pFindNext->ListOrder : 0;
+	auto CheckList = [&](const C4ObjectList &List, auto &&Match)
+	{
+		for (C4ObjectLink *cLnk = List.First; cLnk; cLnk = cLnk->Next)
+		{
+			C4Object *cObj = cLnk->Obj;
+			if (cObj->ListOrder <= iAfter) continue;
+			// everything behind comes after the current result
+			if (pResult && cObj->ListOrder >= pResult->ListOrder) return;
+			if (Match(cObj))
+			{
+				pResult = cObj; return;
+			}
+		}
+	};
+	// Point: objects whose shape contains it
+	if (fPoint)
+	{
+		C4LSector *pSct = Sectors.SectorAt(iX, iY);
+		if (pSct->ObjectShapesOCF.May(Criteria.ocf))
+			CheckList(pSct->ObjectShapes, [&](C4Object *cObj) { return Criteria.MatchPoint(cObj, iX, iY); });
+		return true;
+	}
+	// Range: objects positioned inside it
+	C4LArea Area(&Sectors, iX, iY, iWdt, iHgt); C4LSector *pSct;
+	for (C4ObjectList *pLst = Area.FirstObjects(&pSct); pLst; pLst = Area.NextObjects(pLst, &pSct))
+		if (pSct->ObjectsOCF.May(Criteria.ocf))
+			CheckList(*pLst, [&](C4Object *cObj) { return Criteria.MatchRange(cObj, iX, iY, iWdt, iHgt); });
+	return true;
+}
+
+// Closest search through expanding rings of sectors around the point
+static bool FindClosestInSectors(const C4LegacyFindCriteria &Criteria, int32_t iX, int32_t iY, C4Object *pFindNext, C4Object *&pResult)
+{
+	C4LSectors &Sectors = Game.Objects.Sectors;
+	if (!Sectors.Sectors) return false;
+	// the rings need a center sector
+	if (!Inside<int32_t>(iX, 0, Sectors.PxWdt - 1) || !Inside<int32_t>(iY, 0, Sectors.PxHgt - 1)) return false;
+	// Finding next closest: find closest but further away than last closest
+	int32_t iFartherThan = -1;
+	if (pFindNext)
+		iFartherThan = (pFindNext->x - iX) * (pFindNext->x - iX) + (pFindNext->y - iY) * (pFindNext->y - iY);
+	// collect everything not nearer than the last closest
+	std::vector<std::pair<C4Object *, int32_t>> Candidates;
+	bool fFound = false; int32_t iClosest = 0;
+	auto CheckSector = [&](C4LSector *pSct)
+	{
+		if (!pSct->ObjectsOCF.May(Criteria.ocf)) return;
+		for (C4ObjectLink *cLnk = pSct->Objects.First; cLnk; cLnk = cLnk->Next)
+		{
+			C4Object *cObj = cLnk->Obj;
+			if (!Criteria.Match(cObj)) continue;
+			const int32_t iDistance = (cObj->x - iX) * (cObj->x - iX) + (cObj->y - iY) * (cObj->y - iY);
+			if (iDistance < iFartherThan) continue;
+			Candidates.emplace_back(cObj, iDistance);
+			if (iDistance > iFartherThan && (!fFound || iDistance < iClosest))
+			{
+				fFound = true; iClosest = iDistance;
+			}
+		}
+	};
+	CheckSector(&Sectors.SectorOut);
+	const int32_t iSctX = iX / C4LSectorWdt, iSctY = iY / C4LSectorHgt;
+	const int32_t iMaxRing = std::max({iSctX, Sectors.Wdt - 1 - iSctX, iSctY, Sectors.Hgt - 1 - iSctY});
+	for (int32_t iRing = 0; iRing <= iMaxRing; ++iRing)
+	{
+		// everything in this ring and beyond is farther away than the closest one
+		if (fFound && iRing > 1)
+		{
+			const int32_t iMinDist = (iRing - 1) * std::min(C4LSectorWdt, C4LSectorHgt);
+			if (iMinDist * iMinDist > iClosest) break;
+		}
+		for (int32_t y = iSctY - iRing; y <= iSctY + iRing; ++y)
+		{
+			if (!Inside<int32_t>(y, 0, Sectors.Hgt - 1)) continue;
+			// inner rows only have the two border sectors
+			const int32_t iStep = (Abs(y - iSctY) == iRing) ? 1 : 2 * iRing;
+			for (int32_t x = iSctX - iRing; x <= iSctX + iRing; x += iStep)
+				if (Inside<int32_t>(x, 0, Sectors.Wdt - 1))
+					CheckSector(&Sectors.Sectors[y * Sectors.Wdt + x]);
+		}
+	}
+	pResult = ResolveClosest(Candidates, iFartherThan, pFindNext);
+	return true;
+}
+
+// The original scan through the main list
+static C4Object *FindObjectInList(const C4LegacyFindCriteria &Criteria, int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt, C4Object *pFindNext)
+{
+	C4Object *pClosest = nullptr;
+	int32_t iClosest = 0, iDistance, iFartherThan = -1;
+	C4Object *cObj;
+	C4ObjectLink *cLnk;
+	C4Object *pFindNextCpy = pFindNext;
+
+	// Finding next closest: find closest but further away than last closest
+	if (pFindNext && (iWdt == -1) && (iHgt == -1))
+	{
+		iFartherThan = (pFindNext->x - iX) * (pFindNext->x - iX) + (pFindNext->y - iY) * (pFindNext->y - iY);
+		pFindNext = nullptr;
+	}
+
+	// Scan all objects
+	for (cLnk = Game.Objects.First; cLnk && (cObj = cLnk->Obj); cLnk = cLnk->Next)
+	{
+		// Not skipping to find next
+		if (!pFindNext)
+			if (Criteria.Match(cObj))
+				// Area
+			{
+				// Full range
+				if ((iX == 0) && (iY == 0) && (iWdt == 0) && (iHgt == 0))
+					return cObj;
+				// Point
+				if ((iWdt == 0) && (iHgt == 0))
+				{
+					if (Inside<int32_t>(iX - (cObj->x + cObj->Shape.x), 0, cObj->Shape.Wdt - 1))
+						if (Inside<int32_t>(iY - (cObj->y + cObj->Shape.y), 0, cObj->Shape.Hgt - 1))
+							return cObj;
+					continue;
+				}
+				// Closest
+				if ((iWdt == -1) && (iHgt == -1))
+				{
+					iDistance = (cObj->x - iX) * (cObj->x - iX) + (cObj->y - iY) * (cObj->y - iY);
+					// same distance?
+					if ((iDistance == iFartherThan) && !pFindNextCpy)
+						return cObj;
+					// nearer than/first closest?
+					if (!pClosest || (iDistance < iClosest))
+						if (iDistance > iFartherThan)
+						{
+							pClosest = cObj; iClosest = iDistance;
+						}
+				}
+				// Range
+				else if (Inside<int32_t>(cObj->x - iX, 0, iWdt - 1) && Inside<int32_t>(cObj->y - iY, 0, iHgt - 1))
+					return cObj;
+			}
+
+		// Find next mark reached
+		if (cObj == pFindNextCpy) pFindNext = pFindNextCpy = nullptr;
+	}
+
+	return pClosest;
+}
+
+// The original count through the main list
+static int32_t ObjectCountInList(const C4LegacyFindCriteria &Criteria, int32_t x, int32_t y, int32_t wdt, int32_t hgt)
+{
+	int32_t iResult = 0;
+	C4Object *cObj; C4ObjectLink *clnk;
+	for (clnk = Game.Objects.First; clnk && (cObj = clnk->Obj); clnk = clnk->Next)
+		if (Criteria.Match(cObj))
+			// Area
+		{
+			// Full range
+			if ((x == 0) && (y == 0) && (wdt == 0) && (hgt == 0))
+			{
+				iResult++; continue;
+			}
+			// Point
+			if ((wdt == 0) && (hgt == 0))
+			{
+				if (Inside<int32_t>(x - (cObj->x + cObj->Shape.x), 0, cObj->Shape.Wdt - 1))
+					if (Inside<int32_t>(y - (cObj->y + cObj->Shape.y), 0, cObj->Shape.Hgt - 1))
+					{
+						iResult++; continue;
+					}
+				continue;
+			}
+			// Range
+			if (Inside<int32_t>(cObj->x - x, 0, wdt - 1) && Inside<int32_t>(cObj->y - y, 0, hgt - 1))
+			{
+				iResult++; continue;
+			}
+		}
+	return iResult;
+}
+
 void C4Game::BlastObjects(int32_t tx, int32_t ty, int32_t level, C4Object *inobj, int32_t iCausedBy, C4Object *pByObj)
 {
 	C4Object *cObj; C4ObjectLink *clnk;
@@ -1212,6 +1708,17 @@ void C4Game::BlastObjects(int32_t tx, int32_t ty, int32_t level, C4Object *inobj
 	// Uncontained blast local outside objects
 	else
 	{
+		// Nothing in reach: skip the scan, which has to stay in list order for the random calls
+		if (!AnyBlastTargetInSectors(tx, ty, level, pByObj))
+		{
+			if (Config.Developer.ObjectQueryVerify)
+				for (clnk = Objects.First; clnk && (cObj = clnk->Obj); clnk = clnk->Next)
+					if (AnyBlastTarget(cObj, tx, ty, level, pByObj))
+					{
+						ObjectQueryMismatch("BlastObjects"); break;
+					}
+			return;
+		}
 		for (clnk = Objects.First; clnk && (cObj = clnk->Obj); clnk = clnk->Next)
 			if (cObj->Status) if (!cObj->Contained) if (cObj->pLayer == pByObj)
 			{
@@ -1254,6 +1761,18 @@ void C4Game::ShakeObjects(int32_t tx, int32_t ty, int32_t range, int32_t iCaused
 {
 	C4Object *cObj; C4ObjectLink *clnk;
 
+	// Nothing in range: skip the scan, which has to stay in list order for the random calls
+	if (!AnyShakeTargetInSectors(tx, ty, range))
+	{
+		if (Config.Developer.ObjectQueryVerify)
+			for (clnk = Objects.First; clnk && (cObj = clnk->Obj); clnk = clnk->Next)
+				if (AnyShakeTarget(cObj, tx, ty, range))
+				{
+					ObjectQueryMismatch("ShakeObjects"); break;
+				}
+		return;
+	}
+
 	for (clnk = Objects.First; clnk && (cObj = clnk->Obj); clnk = clnk->Next)
 		if (cObj->Status) if (!cObj->Contained)
 			if (cObj->Category & C4D_Living)
@@ -1293,12 +1812,7 @@ C4Object *C4Game::FindObject(C4ID id,
 	int32_t iOwner,
 	C4Object *pFindNext)
 {
-	C4Object *pClosest = nullptr;
-	int32_t iClosest = 0, iDistance, iFartherThan = -1;
-	C4Object *cObj;
-	C4ObjectLink *cLnk;
 	C4Def *pDef;
-	C4Object *pFindNextCpy = pFindNext;
 
 	// check the easy cases first
 	if (id != C4ID_None)
@@ -1307,73 +1821,30 @@ C4Object *C4Game::FindObject(C4ID id,
 		if (!pDef->Count) return nullptr; // no instances at all
 	}
 
-	// Finding next closest: find closest but further away than last closest
-	if (pFindNext && (iWdt == -1) && (iHgt == -1))
-	{
-		iFartherThan = (pFindNext->x - iX) * (pFindNext->x - iX) + (pFindNext->y - iY) * (pFindNext->y - iY);
-		pFindNext = nullptr;
-	}
+	const C4LegacyFindCriteria Criteria{id, ocf, szAction, SEqual(szAction, "Idle") || SEqual(szAction, "ActIdle"), pActionTarget, pExclude, pContainer, iOwner};
 
-	bool bFindActIdle = SEqual(szAction, "Idle") || SEqual(szAction, "ActIdle");
+	// Searches by action target go through the referrers, area searches through the sectors
+	C4Object *pResult;
+	bool fIndexed = true;
+	if (pActionTarget)
+		pResult = FindObjectInReferrers(Criteria, iX, iY, iWdt, iHgt, pFindNext);
+	else if ((iWdt == -1) && (iHgt == -1))
+		fIndexed = FindClosestInSectors(Criteria, iX, iY, pFindNext, pResult);
+	else
+		fIndexed = FindFirstInSectors(Criteria, iX, iY, iWdt, iHgt, pFindNext, pResult);
+	if (!fIndexed)
+		return FindObjectInList(Criteria, iX, iY, iWdt, iHgt, pFindNext);
 
-	// Scan all objects
-	for (cLnk = Objects.First; cLnk && (cObj = cLnk->Obj); cLnk = cLnk->Next)
+	if (Config.Developer.ObjectQueryVerify)
 	{
-		// Not skipping to find next
-		if (!pFindNext)
-			// Status
-			if (cObj->Status)
-				// ID
-				if ((id == C4ID_None) || (cObj->Def->id == id))
-					// OCF (match any specified)
-					if (cObj->OCF & ocf)
-						// Exclude
-						if (cObj != pExclude)
-							// Action
-							if (!szAction || !szAction[0] || (bFindActIdle && cObj->Action.Act <= ActIdle) || ((cObj->Action.Act > ActIdle) && SEqual(szAction, cObj->Def->ActMap[cObj->Action.Act].Name)))
-								// ActionTarget
-								if (!pActionTarget || ((cObj->Action.Act > ActIdle) && ((cObj->Action.Target == pActionTarget) || (cObj->Action.Target2 == pActionTarget))))
-									// Container
-									if (!pContainer || (cObj->Contained == pContainer) || ((reinterpret_cast<std::intptr_t>(pContainer) == NO_CONTAINER) && !cObj->Contained) || ((reinterpret_cast<std::intptr_t>(pContainer) == ANY_CONTAINER) && cObj->Contained))
-										// Owner
-										if ((iOwner == ANY_OWNER) || (cObj->Owner == iOwner))
-											// Area
-										{
-											// Full range
-											if ((iX == 0) && (iY == 0) && (iWdt == 0) && (iHgt == 0))
-												return cObj;
-											// Point
-											if ((iWdt == 0) && (iHgt == 0))
-											{
-												if (Inside<int32_t>(iX - (cObj->x + cObj->Shape.x), 0, cObj->Shape.Wdt - 1))
-													if (Inside<int32_t>(iY - (cObj->y + cObj->Shape.y), 0, cObj->Shape.Hgt - 1))
-														return cObj;
-												continue;
-											}
-											// Closest
-											if ((iWdt == -1) && (iHgt == -1))
-											{
-												iDistance = (cObj->x - iX) * (cObj->x - iX) + (cObj->y - iY) * (cObj->y - iY);
-												// same distance?
-												if ((iDistance == iFartherThan) && !pFindNextCpy)
-													return cObj;
-												// nearer than/first closest?
-												if (!pClosest || (iDistance < iClosest))
-													if (iDistance > iFartherThan)
-													{
-														pClosest = cObj; iClosest = iDistance;
-													}
-											}
-											// Range
-											else if (Inside<int32_t>(cObj->x - iX, 0, iWdt - 1) && Inside<int32_t>(cObj->y - iY, 0, iHgt - 1))
-												return cObj;
-										}
-
-		// Find next mark reached
-		if (cObj == pFindNextCpy) pFindNext = pFindNextCpy = nullptr;
+		C4Object *pListResult = FindObjectInList(Criteria, iX, iY, iWdt, iHgt, pFindNext);
+		if (pResult != pListResult)
+		{
+			ObjectQueryMismatch("FindObject");
+			return pListResult;
+		}
 	}
-
-	return pClosest;
+	return pResult;
 }
 
 C4Object *C4Game::FindVisObject(int32_t tx, int32_t ty, int32_t iPlr, const C4Facet &fctViewport,
@@ -1459,7 +1930,7 @@ int32_t C4Game::ObjectCount(C4ID id,
 	C4Object *pContainer,
 	int32_t iOwner)
 {
-	int32_t iResult = 0; C4Def *pDef;
+	C4Def *pDef;
 	// check the easy cases first
 	if (id != C4ID_None)
 	{
@@ -1469,49 +1940,29 @@ int32_t C4Game::ObjectCount(C4ID id,
 			// plain id-search: return known count
 			return pDef->Count;
 	}
-	C4Object *cObj; C4ObjectLink *clnk;
-	bool bFindActIdle = SEqual(szAction, "Idle") || SEqual(szAction, "ActIdle");
-	for (clnk = Objects.First; clnk && (cObj = clnk->Obj); clnk = clnk->Next)
-		// Status
-		if (cObj->Status)
-			// ID
-			if ((id == C4ID_None) || (cObj->Def->id == id))
-				// OCF
-				if (cObj->OCF & ocf)
-					// Exclude
-					if (cObj != pExclude)
-						// Action
-						if (!szAction || !szAction[0] || (bFindActIdle && cObj->Action.Act <= ActIdle) || ((cObj->Action.Act > ActIdle) && SEqual(szAction, cObj->Def->ActMap[cObj->Action.Act].Name)))
-							// ActionTarget
-							if (!pActionTarget || ((cObj->Action.Act > ActIdle) && ((cObj->Action.Target == pActionTarget) || (cObj->Action.Target2 == pActionTarget))))
-								// Container
-								if (!pContainer || (cObj->Contained == pContainer) || ((reinterpret_cast<std::intptr_t>(pContainer) == NO_CONTAINER) && !cObj->Contained) || ((reinterpret_cast<std::intptr_t>(pContainer) == ANY_CONTAINER) && cObj->Contained))
-									// Owner
-									if ((iOwner == ANY_OWNER) || (cObj->Owner == iOwner))
-										// Area
-									{
-										// Full range
-										if ((x == 0) && (y == 0) && (wdt == 0) && (hgt == 0))
-										{
-											iResult++; continue;
-										}
-										// Point
-										if ((wdt == 0) && (hgt == 0))
-										{
-											if (Inside<int32_t>(x - (cObj->x + cObj->Shape.x), 0, cObj->Shape.Wdt - 1))
-												if (Inside<int32_t>(y - (cObj->y + cObj->Shape.y), 0, cObj->Shape.Hgt - 1))
-												{
-													iResult++; continue;
-												}
-											continue;
-										}
-										// Range
-										if (Inside<int32_t>(cObj->x - x, 0, wdt - 1) && Inside<int32_t>(cObj->y - y, 0, hgt - 1))
-										{
-											iResult++; continue;
-										}
-									}
 
+	const C4LegacyFindCriteria Criteria{id, ocf, szAction, SEqual(szAction, "Idle") || SEqual(szAction, "ActIdle"), pActionTarget, pExclude, pContainer, iOwner};
+
+	// Counts by action target go through the referrers, area counts through the sectors
+	std::vector<C4Object *> Candidates;
+	if (pActionTarget)
+	{
+		Candidates = GetReferrers(pActionTarget);
+		std::erase_if(Candidates, [&](C4Object *cObj) { return !Criteria.MatchArea(cObj, x, y, wdt, hgt); });
+	}
+	else if (!CollectInSectors(Criteria, x, y, wdt, hgt, Candidates))
+		return ObjectCountInList(Criteria, x, y, wdt, hgt);
+
+	const auto iResult = static_cast<int32_t>(Candidates.size());
+	if (Config.Developer.ObjectQueryVerify)
+	{
+		const int32_t iListResult = ObjectCountInList(Criteria, x, y, wdt, hgt);
+		if (iResult != iListResult)
+		{
+			ObjectQueryMismatch("ObjectCount");
+			return iListResult;
+		}
+	}
 	return iResult;
 }
 
@@ -1553,7 +2004,9 @@ void C4Game::ExecObjects() // Every Tick1 by Execute
 #endif
 
 	// Cross check objects
+	C4ST_START(CrossCheckStat)
 	Objects.CrossCheck();
+	C4ST_STOP(CrossCheckStat)
 
 #ifdef DEBUGREC
 	AddDbgRec(RCT_Block, "ObjRs", 6);
@@ -2587,7 +3040,7 @@ bool C4Game::InitGameSecondPart(C4Group &hGroup, C4ScenarioSection *section, boo
 	Objects.Init(Landscape.Width, Landscape.Height);
 
 	// Pathfinder
-	if (!section) PathFinder.Init(&LandscapeFree, &TransferZones);
+	PathFinder.Init(&LandscapeFree, &TransferZones);
 	SetInitProgress(90);
 
 	// PXS
@@ -3627,14 +4080,21 @@ void C4Game::SyncClearance()
 	Objects.SyncClearance();
 }
 
-void C4Game::Synchronize(bool fSavePlayerFiles)
+void C4Game::Synchronize(bool fSavePlayerFiles, bool fKeyframe)
 {
 	// Log
 	LogSilentF("Network: Synchronization (Frame %i) [PlrSave: %d]", FrameCounter, fSavePlayerFiles);
-	// callback to control (to start record)
-	Control.OnGameSynchronizing();
+	// Coroutine stacks are not saved, so all clients drop them here
+	// Done before a record is started, so it starts with the effects of the abort callbacks
+	// Record keyframes are skipped while coroutines are running, so they never abort any
+	ScriptEngine.AbortCoroutines();
+	// callback to control (to start record or save keyframe)
+	Control.OnGameSynchronizing(fKeyframe);
 	// Fix random
-	FixRandom(Game.Parameters.RandomSeed);
+	// Keyframes continue the random sequence, so recording doesn't change it; playback started from one restores it here
+	// The other members are still synchronized, just like the game started from the keyframe does
+	if (!fKeyframe && !Control.RestoreKeyframeRandom())
+		FixRandom(Game.Parameters.RandomSeed);
 	// Synchronize members
 	Defs.Synchronize();
 	Landscape.Synchronize();
@@ -3684,30 +4144,54 @@ C4Object *C4Game::FindFriendlyBase(int32_t iPlayer, int32_t iIndex)
 	return nullptr;
 }
 
+// Whether any command of cObj matches FindObjectByCommand
+static bool HasMatchingCommand(C4Object *cObj, int32_t iCommand, C4Object *pTarget, const C4Value &iTx, int32_t iTy, C4Object *pTarget2)
+{
+	// Status
+	if (cObj->Status)
+		// Check commands
+		for (C4Command *pCommand = cObj->Command; pCommand; pCommand = pCommand->Next)
+			// Command
+			if (pCommand->Command == iCommand)
+				// Target
+				if (!pTarget || (pCommand->Target == pTarget))
+					// Position
+					if ((!iTx && !iTy) || ((pCommand->Tx == iTx) && (pCommand->Ty == iTy)))
+						// Target2
+						if (!pTarget2 || (pCommand->Target2 == pTarget2))
+							// Found
+							return true;
+	return false;
+}
+
 C4Object *C4Game::FindObjectByCommand(int32_t iCommand, C4Object *pTarget, C4Value iTx, int32_t iTy, C4Object *pTarget2, C4Object *pFindNext)
 {
 	C4Object *cObj; C4ObjectLink *clnk;
-	for (clnk = Objects.First; clnk && (cObj = clnk->Obj); clnk = clnk->Next)
+	C4Object *pListResult = nullptr;
+	C4Object *pFindNextCpy = pFindNext;
+	// Commands with a target only need to check the objects referring to it
+	const bool fIndexed = pTarget || pTarget2;
+	if (!fIndexed || Config.Developer.ObjectQueryVerify)
+		for (clnk = Objects.First; clnk && (cObj = clnk->Obj); clnk = clnk->Next)
+		{
+			// find next
+			if (pFindNextCpy) { if (cObj == pFindNextCpy) pFindNextCpy = nullptr; continue; }
+			if (HasMatchingCommand(cObj, iCommand, pTarget, iTx, iTy, pTarget2))
+			{
+				pListResult = cObj; break;
+			}
+		}
+	if (!fIndexed) return pListResult;
+
+	std::vector<C4Object *> Candidates = GetReferrers(pTarget ? pTarget : pTarget2);
+	std::erase_if(Candidates, [&](C4Object *cObj) { return !HasMatchingCommand(cObj, iCommand, pTarget, iTx, iTy, pTarget2); });
+	C4Object *pResult = FirstInListOrder(Candidates, pFindNext);
+	if (Config.Developer.ObjectQueryVerify && pResult != pListResult)
 	{
-		// find next
-		if (pFindNext) { if (cObj == pFindNext) pFindNext = nullptr; continue; }
-		// Status
-		if (cObj->Status)
-			// Check commands
-			for (C4Command *pCommand = cObj->Command; pCommand; pCommand = pCommand->Next)
-				// Command
-				if (pCommand->Command == iCommand)
-					// Target
-					if (!pTarget || (pCommand->Target == pTarget))
-						// Position
-						if ((!iTx && !iTy) || ((pCommand->Tx == iTx) && (pCommand->Ty == iTy)))
-							// Target2
-							if (!pTarget2 || (pCommand->Target2 == pTarget2))
-								// Found
-								return cObj;
+		ObjectQueryMismatch("FindObjectByCommand");
+		return pListResult;
 	}
-	// Not found
-	return nullptr;
+	return pResult;
 }
 
 bool C4Game::InitNetworkFromAddress(const char *szAddress)
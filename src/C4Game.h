@@ -216,7 +216,7 @@ public:
 	bool Unpause();
 	bool IsPaused();
 	// Network
-	void Synchronize(bool fSavePlayerFiles);
+	void Synchronize(bool fSavePlayerFiles, bool fKeyframe = false);
 	void SyncClearance();
 	// Editing
 	bool DropFile(const char *szFilename, int32_t iX, int32_t iY);
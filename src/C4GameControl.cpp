@@ -121,14 +121,28 @@ void C4GameControl::ChangeToLocal()
 	ControlRate = 1;
 }
 
-void C4GameControl::OnGameSynchronizing()
+void C4GameControl::OnGameSynchronizing(bool fKeyframe)
 {
 	// start record if desired
-	if (fRecordNeeded)
+	// not on keyframes, since a record starts with a reset random sequence
+	if (fRecordNeeded && !fKeyframe)
 	{
 		fRecordNeeded = false;
 		StartRecord(false, false);
 	}
+	// save keyframe if desired
+	else if (pRecord && fKeyframe)
+		pRecord->SaveKeyframe();
+}
+
+void C4GameControl::OnKeyframeSkipped()
+{
+	if (pRecord) pRecord->SkipKeyframe();
+}
+
+bool C4GameControl::RestoreKeyframeRandom()
+{
+	return pPlayback && pPlayback->RestoreKeyframeRandom();
 }
 
 bool C4GameControl::StartRecord(bool fInitial, bool fStreaming)
@@ -223,6 +237,7 @@ void C4GameControl::Default()
 	DoSync = false;
 	fRecordNeeded = false;
 	pExecutingControl = nullptr;
+	DebugRecTypes = GetDebugRecTypeMask(Config.Developer.DebugRecTypes);
 }
 
 bool C4GameControl::Prepare()
@@ -311,6 +326,14 @@ void C4GameControl::Execute()
 	Control.Clear();
 	pExecutingControl = nullptr;
 
+	// Record: keyframes are saved on synchronization, so request one periodically
+	// keyframe synchronizations keep the random sequence and are skipped while coroutines run, see C4Game::Synchronize
+	if (pRecord && fHost && pRecord->IsKeyframeDue(Game.FrameCounter) && !pRecord->IsKeyframeRequested())
+	{
+		pRecord->SetKeyframeRequested();
+		DoInput(CID_Synchronize, new C4ControlSynchronize(false, true, true), CDT_Queue);
+	}
+
 	// statistics record
 	if (Game.pNetworkStatistics) Game.pNetworkStatistics->ExecuteControlFrame();
 }
@@ -411,11 +434,10 @@ void C4GameControl::DbgRec(C4RecordChunkType eType, const uint8_t *pData, size_t
 {
 #ifdef DEBUGREC
 	if (DoNoDebugRec > 0) return;
+	if (!DebugRecTypes.test(eType & 0x7f)) return;
 	// record data
 	if (pRecord)
-		pRecord->Rec(Game.FrameCounter,
-			DecompileToBuf<StdCompilerBinWrite>(C4PktDebugRec(eType, StdBuf(pData, iSize))),
-			eType);
+		pRecord->RecDebug(Game.FrameCounter, eType, pData, iSize);
 	// check against playback
 	if (pPlayback)
 		pPlayback->Check(eType, pData, iSize);
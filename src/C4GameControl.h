@@ -61,6 +61,7 @@ protected:
 
 	C4Record *pRecord;
 	C4Playback *pPlayback;
+	C4DebugRecTypeMask DebugRecTypes; // debug record types to record and check
 
 	C4Control SyncChecks;
 
@@ -135,7 +136,9 @@ public:
 	// execute and record control (by self or C4GameControlNetwork)
 	void ExecControl(const C4Control &rCtrl);
 	void ExecControlPacket(C4PacketType eCtrlType, class C4ControlPacket *pPkt);
-	void OnGameSynchronizing(); // start record if desired
+	void OnGameSynchronizing(bool fKeyframe); // start record or save keyframe if desired
+	void OnKeyframeSkipped(); // keyframe synchronization could not be done
+	bool RestoreKeyframeRandom(); // playback started from a keyframe: continue its random sequence instead of resetting it
 
 protected:
 	// sync checks
@@ -28,6 +28,9 @@
 #include <C4Game.h>
 #include <C4Wrappers.h>
 
+#include <algorithm>
+#include <unordered_set>
+
 C4GameObjects::C4GameObjects()
 {
 	Default();
@@ -53,6 +56,8 @@ void C4GameObjects::Init(int32_t iWidth, int32_t iHeight)
 
 bool C4GameObjects::Add(C4Object *nObj)
 {
+	// lists change: number lookups fall back to scanning
+	if (fNumberTable) ClearNumberTable();
 	// add inactive objects to the inactive list only
 	if (nObj->Status == C4OS_INACTIVE)
 		return InactiveObjects.Add(nObj, C4ObjectList::stMain);
@@ -72,6 +77,7 @@ bool C4GameObjects::Add(C4Object *nObj)
 
 bool C4GameObjects::Remove(C4Object *pObj)
 {
+	if (fNumberTable) ClearNumberTable();
 	// if it's an inactive object, simply remove from the inactiv elist
 	if (pObj->Status == C4OS_INACTIVE) return InactiveObjects.Remove(pObj);
 	// remove from sectors
@@ -94,6 +100,10 @@ void C4GameObjects::CrossCheck() // Every Tick1 by ExecObjects
 	C4Object *obj1, *obj2;
 	uint32_t ocf1, ocf2, focf, tocf;
 
+	// sectors without any object of the target OCF are skipped, so the counts must be exact
+	assert(Sectors.CheckOCFCounts());
+	assert(CheckReferrers());
+
 	// AtObject-Check: Checks for first match of obj1 at obj2
 
 	// Checks for this frame
@@ -114,6 +124,8 @@ void C4GameObjects::CrossCheck() // Every Tick1 by ExecObjects
 			if (obj1->Status && !obj1->Contained)
 				if (obj1->OCF & focf)
 				{
+					// AtObject cannot find anything if no object in the sector has any of the target flags
+					if (!Sectors.SectorAt(obj1->x, obj1->y)->ObjectShapesOCF.May(tocf)) continue;
 					ocf1 = obj1->OCF; ocf2 = tocf;
 					if (obj2 = AtObject(obj1->x, obj1->y, ocf2, obj1))
 					{
@@ -154,45 +166,46 @@ void C4GameObjects::CrossCheck() // Every Tick1 by ExecObjects
 				uint32_t Marker = GetNextMarker();
 				C4LSector *pSct;
 				for (C4ObjectList *pLst = obj1->Area.FirstObjects(&pSct); pLst; pLst = obj1->Area.NextObjects(pLst, &pSct))
-					for (C4ObjectList::iterator iter2 = pLst->begin(); iter2 != pLst->end() && (obj2 = *iter2); ++iter2)
-						if (obj2->Status && !obj2->Contained && (obj2 != obj1) && (obj2->OCF & tocf))
-							if (Inside<int32_t>(obj2->x - (obj1->x + obj1->Shape.x), 0, obj1->Shape.Wdt - 1))
-								if (Inside<int32_t>(obj2->y - (obj1->y + obj1->Shape.y), 0, obj1->Shape.Hgt - 1))
-									if (obj1->pLayer == obj2->pLayer)
-									{
-										// handle collision only once
-										if (obj2->Marker == Marker) continue;
-										obj2->Marker = Marker;
-										// Hit
-										if ((obj2->OCF & OCF_HitSpeed2) && (obj1->OCF & OCF_Alive) && (obj2->Category & C4D_Object))
-											if (!obj1->Call(PSF_QueryCatchBlow, {C4VObj(obj2)}))
-											{
-												// "realistic" hit energy
-												C4Fixed dXDir = obj2->xdir - obj1->xdir, dYDir = obj2->ydir - obj1->ydir;
-												int32_t iHitEnergy = fixtoi((dXDir * dXDir + dYDir * dYDir) * obj2->Mass / 5);
-												iHitEnergy = std::max<int32_t>(iHitEnergy / 3, !!iHitEnergy); // hit energy reduced to 1/3rd, but do not drop to zero because of this division
-												obj1->DoEnergy(-iHitEnergy / 5, false, C4FxCall_EngObjHit, obj2->Controller);
-												int tmass = std::max<int32_t>(obj1->Mass, 50);
-												if (!Tick3 || (obj1->Action.Act >= 0 && obj1->Def->ActMap[obj1->Action.Act].Procedure != DFA_FLIGHT))
-													obj1->Fling(obj2->xdir * 50 / tmass, -Abs(obj2->ydir / 2) * 50 / tmass, false, obj2->Controller);
-												obj1->Call(PSF_CatchBlow, {C4VInt(-iHitEnergy / 5),
-													C4VObj(obj2)});
-												// obj1 might have been tampered with
-												if (!obj1->Status || obj1->Contained || !(obj1->OCF & focf))
-													goto out1;
-												continue;
-											}
-										// Collection
-										if ((obj1->OCF & OCF_Collection) && (obj2->OCF & OCF_Carryable))
-											if (Inside<int32_t>(obj2->x - (obj1->x + obj1->Def->Collection.x), 0, obj1->Def->Collection.Wdt - 1))
-												if (Inside<int32_t>(obj2->y - (obj1->y + obj1->Def->Collection.y), 0, obj1->Def->Collection.Hgt - 1))
+					if (pSct->ObjectsOCF.May(tocf))
+						for (C4ObjectList::iterator iter2 = pLst->begin(); iter2 != pLst->end() && (obj2 = *iter2); ++iter2)
+							if (obj2->Status && !obj2->Contained && (obj2 != obj1) && (obj2->OCF & tocf))
+								if (Inside<int32_t>(obj2->x - (obj1->x + obj1->Shape.x), 0, obj1->Shape.Wdt - 1))
+									if (Inside<int32_t>(obj2->y - (obj1->y + obj1->Shape.y), 0, obj1->Shape.Hgt - 1))
+										if (obj1->pLayer == obj2->pLayer)
+										{
+											// handle collision only once
+											if (obj2->Marker == Marker) continue;
+											obj2->Marker = Marker;
+											// Hit
+											if ((obj2->OCF & OCF_HitSpeed2) && (obj1->OCF & OCF_Alive) && (obj2->Category & C4D_Object))
+												if (!obj1->Call(PSF_QueryCatchBlow, {C4VObj(obj2)}))
 												{
-													obj1->Collect(obj2);
+													// "realistic" hit energy
+													C4Fixed dXDir = obj2->xdir - obj1->xdir, dYDir = obj2->ydir - obj1->ydir;
+													int32_t iHitEnergy = fixtoi((dXDir * dXDir + dYDir * dYDir) * obj2->Mass / 5);
+													iHitEnergy = std::max<int32_t>(iHitEnergy / 3, !!iHitEnergy); // hit energy reduced to 1/3rd, but do not drop to zero because of this division
+													obj1->DoEnergy(-iHitEnergy / 5, false, C4FxCall_EngObjHit, obj2->Controller);
+													int tmass = std::max<int32_t>(obj1->Mass, 50);
+													if (!Tick3 || (obj1->Action.Act >= 0 && obj1->Def->ActMap[obj1->Action.Act].Procedure != DFA_FLIGHT))
+														obj1->Fling(obj2->xdir * 50 / tmass, -Abs(obj2->ydir / 2) * 50 / tmass, false, obj2->Controller);
+													obj1->Call(PSF_CatchBlow, {C4VInt(-iHitEnergy / 5),
+														C4VObj(obj2)});
 													// obj1 might have been tampered with
 													if (!obj1->Status || obj1->Contained || !(obj1->OCF & focf))
 														goto out1;
+													continue;
 												}
-									}
+											// Collection
+											if ((obj1->OCF & OCF_Collection) && (obj2->OCF & OCF_Carryable))
+												if (Inside<int32_t>(obj2->x - (obj1->x + obj1->Def->Collection.x), 0, obj1->Def->Collection.Wdt - 1))
+													if (Inside<int32_t>(obj2->y - (obj1->y + obj1->Def->Collection.y), 0, obj1->Def->Collection.Hgt - 1))
+													{
+														obj1->Collect(obj2);
+														// obj1 might have been tampered with
+														if (!obj1->Status || obj1->Contained || !(obj1->OCF & focf))
+															goto out1;
+													}
+										}
 			out1:;
 			}
 
@@ -269,6 +282,12 @@ C4Object *C4GameObjects::FindInternal(C4ID id)
 
 C4Object *C4GameObjects::ObjectPointer(int32_t iNumber)
 {
+	// whole section being (de)numerated?
+	if (fNumberTable)
+	{
+		const auto it = NumberTable.find(iNumber);
+		return it != NumberTable.end() ? it->second : nullptr;
+	}
 	// search own list
 	C4Object *pObj = C4ObjectList::ObjectPointer(iNumber);
 	if (pObj) return pObj;
@@ -278,6 +297,11 @@ C4Object *C4GameObjects::ObjectPointer(int32_t iNumber)
 
 std::int32_t C4GameObjects::ObjectNumber(C4Object *pObj)
 {
+	if (fNumberTable)
+	{
+		return pObj && PointerTable.count(pObj) ? pObj->Number : 0;
+	}
+
 	// search own list
 	if (const std::int32_t number{C4ObjectList::ObjectNumber(pObj)}; number)
 	{
@@ -288,6 +312,27 @@ std::int32_t C4GameObjects::ObjectNumber(C4Object *pObj)
 	return InactiveObjects.ObjectNumber(pObj);
 }
 
+void C4GameObjects::BuildNumberTable()
+{
+	NumberTable.clear();
+	PointerTable.clear();
+	// first match wins, main list before inactive objects - just like the list scans
+	for (C4ObjectList *pList : {static_cast<C4ObjectList *>(this), &InactiveObjects})
+		for (C4ObjectLink *pLnk = pList->First; pLnk; pLnk = pLnk->Next)
+		{
+			NumberTable.emplace(pLnk->Obj->Number, pLnk->Obj);
+			PointerTable.insert(pLnk->Obj);
+		}
+	fNumberTable = true;
+}
+
+void C4GameObjects::ClearNumberTable()
+{
+	NumberTable.clear();
+	PointerTable.clear();
+	fNumberTable = false;
+}
+
 C4ObjectList &C4GameObjects::ObjectsInt()
 {
 	return *this;
@@ -327,7 +372,10 @@ void C4GameObjects::Clear(bool fClearInactive)
 {
 	DeleteObjects();
 	if (fClearInactive)
+	{
 		InactiveObjects.Clear();
+		Referrers.clear();
+	}
 	ResortProc = nullptr;
 	LastUsedMarker = 0;
 }
@@ -503,6 +551,7 @@ void C4ObjResort::Sort(C4ObjectLink *pFirst, C4ObjectLink *pLast)
 				// so there's something to be reordered: swap the links
 				// FIXME: Inform C4ObjectList about this reorder
 				C4Object *pObj = pCurr->Obj; pCurr->Obj = pCurr2->Obj; pCurr2->Obj = pObj;
+				std::swap(pCurr->Obj->ListOrder, pCurr2->Obj->ListOrder);
 				// and readd to sector lists
 				pCurr->Obj->Unsorted = pCurr2->Obj->Unsorted = true;
 				// grow list section to scan next
@@ -534,33 +583,52 @@ void C4ObjResort::Sort(C4ObjectLink *pFirst, C4ObjectLink *pLast)
 
 int C4GameObjects::Load(C4Group &hGroup, bool fKeepInactive)
 {
-	// Load data component
-	StdStrBuf Source;
-	if (!hGroup.LoadEntryString(C4CFN_ScenarioObjects, Source))
-		return 0;
+	const uint32_t tLoadStart = timeGetTime();
 
-	// Compile
-	StdStrBuf Name = hGroup.GetFullName() + DirSep C4CFN_ScenarioObjects;
-	if (!CompileFromBuf_LogWarn<StdCompilerINIRead>(
-		mkParAdapt(*this, false),
-		Source,
-		Name.getData()))
-		return 0;
+	// Load data component - a binary object section takes precedence
+	const bool fBinary = hGroup.FindEntry(C4CFN_ScenarioObjectsBin);
+	StdStrBuf Name = hGroup.GetFullName() + (fBinary ? DirSep C4CFN_ScenarioObjectsBin : DirSep C4CFN_ScenarioObjects);
+	if (fBinary)
+	{
+		StdBuf Source;
+		if (!hGroup.LoadEntry(C4CFN_ScenarioObjectsBin, Source))
+			return 0;
+
+		// Compile
+		if (!CompileFromBuf_LogWarn<StdCompilerBinRead>(
+			mkParAdapt(*this, false),
+			Source,
+			Name.getData()))
+			return 0;
+	}
+	else
+	{
+		StdStrBuf Source;
+		if (!hGroup.LoadEntryString(C4CFN_ScenarioObjects, Source))
+			return 0;
+
+		// Compile
+		if (!CompileFromBuf_LogWarn<StdCompilerINIRead>(
+			mkParAdapt(*this, false),
+			Source,
+			Name.getData()))
+			return 0;
+	}
 
 	// Process objects
 	C4ObjectLink *cLnk;
 	C4Object *pObj;
 	bool fObjectNumberCollision = false;
 	int32_t iMaxObjectNumber = 0;
+	std::unordered_set<int32_t> InactiveNumbers;
+	if (fKeepInactive)
+		for (cLnk = InactiveObjects.First; cLnk; cLnk = cLnk->Next)
+			InactiveNumbers.insert(cLnk->Obj->Number);
 	for (cLnk = Last; cLnk; cLnk = cLnk->Prev)
 	{
 		C4Object *pObj = cLnk->Obj;
 		// check object number collision with inactive list
-		if (fKeepInactive)
-		{
-			for (C4ObjectLink *clnk = InactiveObjects.First; clnk; clnk = clnk->Next)
-				if (clnk->Obj->Number == pObj->Number) fObjectNumberCollision = true;
-		}
+		if (InactiveNumbers.count(pObj->Number)) fObjectNumberCollision = true;
 		// keep track of numbers
 		iMaxObjectNumber = std::max<long>(iMaxObjectNumber, pObj->Number);
 		// add to list of backobjects
@@ -578,7 +646,9 @@ int C4GameObjects::Load(C4Group &hGroup, bool fKeepInactive)
 	C4ObjectLink *pInFirst;
 	if (fObjectNumberCollision) { pInFirst = InactiveObjects.First; InactiveObjects.First = nullptr; }
 	// denumerate pointers
+	BuildNumberTable();
 	Denumerate();
+	ClearNumberTable();
 	// update object enumeration index now, because calls like UpdateTransferZone might create objects
 	Game.ObjectEnumerationIndex = (std::max)(Game.ObjectEnumerationIndex, iMaxObjectNumber);
 	// end faking and adjust object numbers
@@ -645,6 +715,7 @@ int C4GameObjects::Load(C4Group &hGroup, bool fKeepInactive)
 			else
 				InactiveObjects.First = cLnk;
 			InactiveObjects.Last = cLnk; cLnk->Next = nullptr;
+			cLnk->Obj->ListOrder = 0;
 			Mass -= pObj->Mass;
 		}
 	}
@@ -673,51 +744,98 @@ int C4GameObjects::Load(C4Group &hGroup, bool fKeepInactive)
 			pObj->UpdateFlipDir();
 		}
 	// Done
-	return ObjectCount();
+	const int iObjCount = ObjectCount();
+	LogSilentF("Objects: %d loaded from %s in %u ms", iObjCount, GetFilename(Name.getData()), timeGetTime() - tLoadStart);
+	return iObjCount;
 }
 
-bool C4GameObjects::Save(C4Group &hGroup, bool fSaveGame, bool fSaveInactive)
+// Binary object section: Active and inactive objects under one object count, so it reads back
+// through C4ObjectList::CompileFunc just like the concatenated INI sections do
+struct C4BinaryObjectSectionAdapt
+{
+	C4ObjectList &Objects; C4ObjectList *pInactiveObjects; bool fSkipPlayerObjects;
+
+	void CompileFunc(StdCompiler *pComp) const
+	{
+		assert(pComp->isDecompiler() && !pComp->hasNaming());
+		const auto fSaved = [this](C4Object *pObj) { return pObj->Status && (!fSkipPlayerObjects || !pObj->IsUserPlayerObject()); };
+		// Put object count
+		int32_t iObjCnt = 0;
+		for (C4ObjectList *pList : {&Objects, pInactiveObjects})
+			if (pList)
+				for (C4ObjectLink *pPos = pList->First; pPos; pPos = pPos->Next)
+					if (fSaved(pPos->Obj)) ++iObjCnt;
+		pComp->Value(mkNamingCountAdapt(iObjCnt, "Object"));
+		// Decompile all objects in reverse order, list by list
+		for (C4ObjectList *pList : {&Objects, pInactiveObjects})
+			if (pList)
+				for (C4ObjectLink *pPos = pList->Last; pPos; pPos = pPos->Prev)
+					if (fSaved(pPos->Obj))
+						pComp->Value(*pPos->Obj);
+	}
+};
+
+bool C4GameObjects::Save(C4Group &hGroup, bool fSaveGame, bool fSaveInactive, bool fBinary)
 {
 	// Save to temp file
-	char szFilename[_MAX_PATH + 1]; SCopy(Config.AtTempPath(C4CFN_ScenarioObjects), szFilename);
-	if (!Save(szFilename, fSaveGame, fSaveInactive)) return false;
+	char szFilename[_MAX_PATH + 1]; SCopy(Config.AtTempPath(fBinary ? C4CFN_ScenarioObjectsBin : C4CFN_ScenarioObjects), szFilename);
+	if (!Save(szFilename, fSaveGame, fSaveInactive, fBinary)) return false;
 
+	// Drop an object section of the other format, it would shadow or be shadowed by this one
+	hGroup.Delete(fBinary ? C4CFN_ScenarioObjects : C4CFN_ScenarioObjectsBin);
 	// Move temp file to group
 	hGroup.Move(szFilename, nullptr); // check?
 	// Success
 	return true;
 }
 
-bool C4GameObjects::Save(const char *szFilename, bool fSaveGame, bool fSaveInactive)
+bool C4GameObjects::Save(const char *szFilename, bool fSaveGame, bool fSaveInactive, bool fBinary)
 {
+	const uint32_t tSaveStart = timeGetTime();
+
 	// Enumerate
+	BuildNumberTable();
 	Enumerate();
 	InactiveObjects.Enumerate();
 	Game.ScriptEngine.Strings.EnumStrings();
 
-	// Decompile objects to buffer
+	bool fSuccess;
+	StdBuf BinBuffer;
 	StdStrBuf Buffer;
-	bool fSuccess = DecompileToBuf_Log<StdCompilerINIWrite>(mkParAdapt(*this, false, !fSaveGame), &Buffer, szFilename);
-
-	// Decompile inactives
-	if (fSaveInactive)
+	if (fBinary)
 	{
-		StdStrBuf InactiveBuffer;
-		fSuccess &= DecompileToBuf_Log<StdCompilerINIWrite>(mkParAdapt(InactiveObjects, false, !fSaveGame), &InactiveBuffer, szFilename);
-		Buffer.Append("\r\n");
-		Buffer.Append(InactiveBuffer);
+		// Decompile objects and inactives to buffer
+		fSuccess = DecompileToBuf_Log<StdCompilerBinWrite>(C4BinaryObjectSectionAdapt{*this, fSaveInactive ? &InactiveObjects : nullptr, !fSaveGame}, &BinBuffer, szFilename);
+	}
+	else
+	{
+		// Decompile objects to buffer
+		fSuccess = DecompileToBuf_Log<StdCompilerINIWrite>(mkParAdapt(*this, false, !fSaveGame), &Buffer, szFilename);
+
+		// Decompile inactives
+		if (fSaveInactive)
+		{
+			StdStrBuf InactiveBuffer;
+			fSuccess &= DecompileToBuf_Log<StdCompilerINIWrite>(mkParAdapt(InactiveObjects, false, !fSaveGame), &InactiveBuffer, szFilename);
+			Buffer.Append("\r\n");
+			Buffer.Append(InactiveBuffer);
+		}
 	}
 
 	// Denumerate
 	InactiveObjects.Denumerate();
 	Denumerate();
+	ClearNumberTable();
 
 	// Error?
 	if (!fSuccess)
 		return false;
 
 	// Write
-	return Buffer.SaveToFile(szFilename);
+	if (!(fBinary ? BinBuffer.SaveToFile(szFilename) : Buffer.SaveToFile(szFilename)))
+		return false;
+	LogSilentF("Objects: Saved %s in %u ms", GetFilename(szFilename), timeGetTime() - tSaveStart);
+	return true;
 }
 
 void C4GameObjects::UpdateScriptPointers()
@@ -742,6 +860,43 @@ void C4GameObjects::UpdatePosResort(C4Object *pObj)
 	Sectors.Add(pObj, this);
 }
 
+// Keys are spread out by this gap, so most insertions don't have to touch other objects
+static constexpr uint64_t ListOrderGap = uint64_t{1} << 20;
+
+void C4GameObjects::InsertLinkBefore(C4ObjectLink *pLink, C4ObjectLink *pBefore)
+{
+	C4NotifyingObjectList::InsertLinkBefore(pLink, pBefore);
+	UpdateListOrder(pLink);
+}
+
+void C4GameObjects::InsertLink(C4ObjectLink *pLink, C4ObjectLink *pAfter)
+{
+	C4NotifyingObjectList::InsertLink(pLink, pAfter);
+	UpdateListOrder(pLink);
+}
+
+void C4GameObjects::RemoveLink(C4ObjectLink *pLnk)
+{
+	C4NotifyingObjectList::RemoveLink(pLnk);
+	pLnk->Obj->ListOrder = 0;
+}
+
+void C4GameObjects::UpdateListOrder(C4ObjectLink *pLnk)
+{
+	const uint64_t iPrev = pLnk->Prev ? pLnk->Prev->Obj->ListOrder : 0;
+	const uint64_t iNext = pLnk->Next ? pLnk->Next->Obj->ListOrder : UINT64_MAX;
+	// no room left between the neighbours?
+	if (iNext - iPrev < 2) { RenumberListOrder(); return; }
+	pLnk->Obj->ListOrder = iPrev + std::min<uint64_t>((iNext - iPrev) / 2, ListOrderGap);
+}
+
+void C4GameObjects::RenumberListOrder()
+{
+	uint64_t iOrder = 0;
+	for (C4ObjectLink *cLnk = First; cLnk; cLnk = cLnk->Next)
+		cLnk->Obj->ListOrder = (iOrder += ListOrderGap);
+}
+
 bool C4GameObjects::OrderObjectBefore(C4Object *pObj1, C4Object *pObj2)
 {
 	// check that this won't screw the category sort
@@ -750,6 +905,7 @@ bool C4GameObjects::OrderObjectBefore(C4Object *pObj1, C4Object *pObj2)
 	// reorder
 	if (!C4ObjectList::OrderObjectBefore(pObj1, pObj2))
 		return false;
+	UpdateListOrder(GetLink(pObj1));
 	// update area lists
 	UpdatePosResort(pObj1);
 	// done, success
@@ -764,6 +920,7 @@ bool C4GameObjects::OrderObjectAfter(C4Object *pObj1, C4Object *pObj2)
 	// reorder
 	if (!C4ObjectList::OrderObjectAfter(pObj1, pObj2))
 		return false;
+	UpdateListOrder(GetLink(pObj1));
 	// update area lists
 	UpdatePosResort(pObj1);
 	// done, success
@@ -917,3 +1074,60 @@ uint32_t C4GameObjects::GetNextMarker()
 	}
 	return marker;
 }
+
+void C4GameObjects::AddReferrer(C4Object *pTarget, C4Object *pHolder)
+{
+	Referrers[pTarget].push_back(pHolder);
+}
+
+void C4GameObjects::RemoveReferrer(C4Object *pTarget, C4Object *pHolder)
+{
+	const auto it = Referrers.find(pTarget);
+	if (it == Referrers.end()) return;
+	auto &Holders = it->second;
+	const auto pos = std::find(Holders.begin(), Holders.end(), pHolder);
+	if (pos == Holders.end()) return;
+	*pos = Holders.back();
+	Holders.pop_back();
+	if (Holders.empty()) Referrers.erase(it);
+}
+
+const std::vector<C4Object *> *C4GameObjects::GetReferrers(C4Object *pTarget) const
+{
+	const auto it = Referrers.find(pTarget);
+	return it != Referrers.end() ? &it->second : nullptr;
+}
+
+bool C4GameObjects::CheckReferrers()
+{
+	// collect all targets of active and inactive objects
+	std::unordered_map<C4Object *, std::vector<C4Object *>> Expected;
+	const auto AddTarget = [&Expected](const C4TargetObjectPtr &Target)
+	{
+		if (Target && Target.Holder()) Expected[Target].push_back(Target.Holder());
+	};
+	for (C4ObjectList *pLst : {static_cast<C4ObjectList *>(this), &InactiveObjects})
+		for (C4ObjectLink *cLnk = pLst->First; cLnk; cLnk = cLnk->Next)
+		{
+			C4Object *cObj = cLnk->Obj;
+			AddTarget(cObj->Action.Target);
+			AddTarget(cObj->Action.Target2);
+			for (C4Command *pCom = cObj->Command; pCom; pCom = pCom->Next)
+			{
+				AddTarget(pCom->Target);
+				AddTarget(pCom->Target2);
+			}
+		}
+	// compare regardless of order
+	if (Expected.size() != Referrers.size()) return false;
+	for (auto &[pTarget, Holders] : Expected)
+	{
+		const auto it = Referrers.find(pTarget);
+		if (it == Referrers.end()) return false;
+		std::vector<C4Object *> Indexed = it->second;
+		std::sort(Holders.begin(), Holders.end());
+		std::sort(Indexed.begin(), Indexed.end());
+		if (Holders != Indexed) return false;
+	}
+	return true;
+}
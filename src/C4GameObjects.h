@@ -23,6 +23,10 @@
 #include <C4FindObject.h>
 #include <C4Sector.h>
 
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 class C4ObjResort;
 
 // main object list class
@@ -37,6 +41,20 @@ public:
 
 private:
 	uint32_t LastUsedMarker; // last used value for C4Object::Marker
+	std::unordered_map<C4Object *, std::vector<C4Object *>> Referrers; // action and command targets: holders, once per pointer
+	std::unordered_map<int32_t, C4Object *> NumberTable; // number lookup while the whole object section is (de)numerated
+	std::unordered_set<C4Object *> PointerTable; // objects of both lists, valid along with NumberTable
+	bool fNumberTable{false};
+
+	void BuildNumberTable();
+	void ClearNumberTable();
+	void UpdateListOrder(C4ObjectLink *pLnk); // give the object of pLnk a key between its neighbours
+	void RenumberListOrder(); // spread out the keys of all objects again
+
+protected:
+	virtual void InsertLinkBefore(C4ObjectLink *pLink, C4ObjectLink *pBefore) override;
+	virtual void InsertLink(C4ObjectLink *pLink, C4ObjectLink *pAfter) override;
+	virtual void RemoveLink(C4ObjectLink *pLnk) override;
 
 public:
 	C4LSectors Sectors; // section object lists
@@ -53,6 +71,11 @@ public:
 	void Synchronize(); // network synchronization
 	uint32_t GetNextMarker();
 
+	void AddReferrer(C4Object *pTarget, C4Object *pHolder);
+	void RemoveReferrer(C4Object *pTarget, C4Object *pHolder);
+	const std::vector<C4Object *> *GetReferrers(C4Object *pTarget) const; // objects whose action or commands may target pTarget; unordered, may contain duplicates
+	bool CheckReferrers(); // check referrer index against all action and command targets
+
 	C4Object *FindInternal(C4ID id); // find object in first sector
 	virtual C4Object *ObjectPointer(int32_t iNumber) override; // object pointer by number
 	std::int32_t ObjectNumber(C4Object *pObj); // object number by pointer
@@ -63,8 +86,8 @@ public:
 	void RemoveSolidMasks();
 
 	int Load(C4Group &hGroup, bool fKeepInactive);
-	bool Save(const char *szFilename, bool fSaveGame, bool fSaveInactive);
-	bool Save(C4Group &hGroup, bool fSaveGame, bool fSaveInactive);
+	bool Save(const char *szFilename, bool fSaveGame, bool fSaveInactive, bool fBinary = false);
+	bool Save(C4Group &hGroup, bool fSaveGame, bool fSaveInactive, bool fBinary = false); // binary object sections can only be read by the same engine version
 
 	void UpdateScriptPointers(); // update pointers to C4AulScript *
 
@@ -81,6 +104,8 @@ public:
 
 	bool ValidateOwners();
 	bool AssignInfo();
+
+	friend class C4ObjResort;
 };
 
 class C4AulFunc;
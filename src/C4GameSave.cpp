@@ -200,7 +200,7 @@ bool C4GameSave::SaveRuntimeData()
 		Log(LoadResStr("IDS_ERR_SAVE_SCRIPTSTRINGS")); return false;
 	}
 	// Objects
-	if (!Game.Objects.Save((*pSaveGroup), IsExact(), true))
+	if (!Game.Objects.Save((*pSaveGroup), IsExact(), true, GetSaveObjectsBinary()))
 	{
 		Log(LoadResStr("IDS_ERR_SAVE_OBJECTS")); return false;
 	}
@@ -583,6 +583,8 @@ void C4GameSaveRecord::AdjustCore(C4Scenario &rC4S)
 	// specific recording flags
 	rC4S.Head.Replay = true;
 	rC4S.Head.Icon = 29;
+	// the recorded control packets depend on the engine build
+	rC4S.Head.C4XVer[4] = C4XVERBUILD;
 	// default record title
 	char buf[1024 + 1];
 	sprintf(buf, "%03i %s [%d]", iNum, Game.Parameters.ScenarioTitle.getData(), static_cast<int>(C4XVERBUILD));
@@ -62,6 +62,7 @@ protected:
 	virtual bool GetCopyScenario() { return true; } // return whether the savegame depends on the game scenario file
 	virtual const char *GetSortOrder() { return C4FLS_Scenario; } // return nullptr to prevent sorting
 	virtual bool GetCreateSmallFile() { return false; } // return whether file size should be minimized
+	virtual bool GetSaveObjectsBinary() { return false; } // return whether objects shall be saved in the binary format, which only the same engine version can read
 	virtual bool GetForceExactLandscape() { return GetSaveRuntimeData() && IsExact(); } // whether exact landscape shall be saved
 	virtual bool GetSaveOrigin()  { return false; }            // return whether C4S.Head.Origin shall be set
 	virtual bool GetClearOrigin() { return !GetSaveOrigin(); } // return whether C4S.Head.Origin shall be cleared if it's set
@@ -181,6 +182,7 @@ protected:
 	virtual bool GetKeepTitle() override { return false; } // always delete title files (not used in dynamics)
 	virtual bool GetSaveDesc() override { return false; } // no desc in dynamics
 	virtual bool GetCreateSmallFile() override { return true; } // return whether file size should be minimized
+	virtual bool GetSaveObjectsBinary() override { return true; } // dynamics are only loaded by clients of the same engine version
 
 	virtual bool GetCopyScenario() override { return false; } // network dynamics do not base on normal scenario
 	// savegame specializations
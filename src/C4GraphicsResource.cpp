@@ -131,6 +131,17 @@ void C4GraphicsResource::Clear()
 	fctBuild.Clear();
 	fctEnergyBars.Clear();
 
+	// report font layout cache usage
+	int32_t iLayoutHits = 0, iLayoutMisses = 0;
+	for (const CStdFont *pFont : { &FontTiny, &FontRegular, &FontCaption, &FontTitle, &FontTooltip })
+	{
+		int32_t iHits, iMisses;
+		pFont->GetLayoutCacheStats(iHits, iMisses);
+		iLayoutHits += iHits; iLayoutMisses += iMisses;
+	}
+	if (iLayoutHits + iLayoutMisses)
+		LogSilentF("Font layout cache: %d hits, %d misses", iLayoutHits, iLayoutMisses);
+
 	// unhook deflist from font
 	FontRegular.SetCustomImages(nullptr);
 
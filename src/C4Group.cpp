@@ -40,7 +40,12 @@
 #include <StdSha1.h>
 #include <fcntl.h>
 
+#include <atomic>
 #include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
 
 // File Sort Lists
 
@@ -64,7 +69,7 @@ const char *C4CFN_FLS[] =
 };
 
 #ifndef NDEBUG
-char *szCurrAccessedEntry = nullptr;
+thread_local char *szCurrAccessedEntry = nullptr;
 int iC4GroupRewindFilePtrNoWarn = 0;
 #endif
 
@@ -83,12 +88,43 @@ char C4Group_Ignore[_MAX_PATH + 1] = "cvs;Thumbs.db";
 const char **C4Group_SortList = nullptr;
 time_t C4Group_AssumeTimeOffset = 0;
 bool(*C4Group_ProcessCallback)(const char *, int) = nullptr;
+std::atomic<int32_t> C4Group_FreeWorkers{0}; // additional threads that may still be started
+std::atomic<uint32_t> C4Group_TempCounter{0};
 
 void C4Group_SetProcessCallback(bool(*fnCallback)(const char *, int))
 {
 	C4Group_ProcessCallback = fnCallback;
 }
 
+void C4Group_SetWorkerThreads(int32_t iThreads)
+{
+	if (iThreads <= 0) iThreads = std::max<int32_t>(std::thread::hardware_concurrency(), 1);
+	C4Group_FreeWorkers = iThreads - 1;
+}
+
+// Runs all tasks, each on an additional thread while worker threads are free and on the calling thread otherwise
+// Tasks may run tasks themselves; the total number of threads stays bounded
+static bool C4Group_RunTasks(const std::vector<std::function<bool()>> &tasks)
+{
+	std::atomic<bool> fSuccess{true};
+	std::vector<std::thread> threads;
+	for (const auto &task : tasks)
+	{
+		int32_t iFree = C4Group_FreeWorkers;
+		while (iFree > 0 && !C4Group_FreeWorkers.compare_exchange_weak(iFree, iFree - 1)) {}
+		if (iFree > 0)
+			threads.emplace_back([&task, &fSuccess]
+			{
+				if (!task()) fSuccess = false;
+				++C4Group_FreeWorkers;
+			});
+		else if (!task())
+			fSuccess = false;
+	}
+	for (auto &thread : threads) thread.join();
+	return fSuccess;
+}
+
 void C4Group_SetSortList(const char **ppSortList)
 {
 	C4Group_SortList = ppSortList;
@@ -250,7 +286,7 @@ bool C4Group_DeleteItem(const char *szItem, bool fRecycle)
 	return true;
 }
 
-bool C4Group_PackDirectoryTo(const char *szFilename, const char *szFilenameTo)
+bool C4Group_PackDirectoryTo(const char *szFilename, const char *szFilenameTo, bool fStagingOnly)
 {
 	// Check file type
 	if (!DirectoryExists(szFilename)) return false;
@@ -266,45 +302,63 @@ bool C4Group_PackDirectoryTo(const char *szFilename, const char *szFilenameTo)
 	C4Group hGroup;
 	if (!hGroup.Open(szFilenameTo, true))
 		return false;
-	// Add folder contents to group
-	DirectoryIterator i(szFilename);
-	for (; *i; i++)
-	{
-		// Ignore
-		if (C4Group_TestIgnore(*i))
-			continue;
-		// Must pack?
-		if (DirectoryExists(*i))
+	hGroup.SetStagingOnly(fStagingOnly);
+	// Collect folder contents
+	struct Item
+	{
+		std::string Filename;
+		std::string TempFilename; // packed subfolder
+	};
+	std::vector<Item> items;
+	for (DirectoryIterator i(szFilename); *i; i++)
+		if (!C4Group_TestIgnore(*i))
+			items.push_back({*i, {}});
+	// Pack subfolders to temporary files first, so they can be packed in parallel
+	// They are moved into this group and unpacked again, so they are not compressed
+	std::vector<std::function<bool()>> tasks;
+	for (auto &item : items)
+		if (DirectoryExists(item.Filename.c_str()))
 		{
-			// Find temporary filename
+			// Find temporary filename at C4Group temp path
+			// Numbered, so equally named folders packed at the same time don't collide
 			char szTempFilename[_MAX_PATH + 1];
-			// At C4Group temp path
 			SCopy(C4Group_TempPath, szTempFilename, _MAX_PATH);
-			SAppend(GetFilename(*i), szTempFilename, _MAX_PATH);
-			// Make temporary filename
+			SAppend(FormatString("%u-%s", ++C4Group_TempCounter, GetFilename(item.Filename.c_str())).getData(), szTempFilename, _MAX_PATH);
 			MakeTempFilename(szTempFilename);
-			// Pack and move into group
-			if (!C4Group_PackDirectoryTo(*i, szTempFilename)) break;
-			if (!hGroup.Move(szTempFilename, GetFilename(*i)))
+			item.TempFilename = szTempFilename;
+			tasks.emplace_back([&item] { return C4Group_PackDirectoryTo(item.Filename.c_str(), item.TempFilename.c_str(), true); });
+		}
+	bool fSuccess = C4Group_RunTasks(tasks);
+	// Add folder contents to group
+	size_t iItem = 0;
+	if (fSuccess)
+		for (; iItem < items.size(); ++iItem)
+		{
+			const auto &item = items[iItem];
+			if (!item.TempFilename.empty())
 			{
-				EraseFile(szTempFilename);
-				break;
+				// Move into group; it has been sorted by its own name already
+				hGroup.SetNoSort(true);
+				fSuccess = hGroup.Move(item.TempFilename.c_str(), GetFilename(item.Filename.c_str()));
+				hGroup.SetNoSort(false);
 			}
+			// Add normally otherwise
+			else
+				fSuccess = hGroup.Add(item.Filename.c_str(), nullptr);
+			if (!fSuccess) break;
 		}
-		// Add normally otherwise
-		else if (!hGroup.Add(*i, nullptr))
-			break;
-	}
 	// Something went wrong?
-	if (*i)
+	if (!fSuccess)
 	{
+		// Remove temporary files that have not been moved
+		for (; iItem < items.size(); ++iItem)
+			if (!items[iItem].TempFilename.empty())
+				EraseItem(items[iItem].TempFilename.c_str());
 		// Close group and remove temporary file
 		hGroup.Close();
 		EraseItem(szFilenameTo);
 		return false;
 	}
-	// Reset iterator
-	i.Reset();
 	// Close group
 	hGroup.SortByList(C4Group_SortList, szFilename);
 	if (!hGroup.Close())
@@ -335,7 +389,17 @@ bool C4Group_PackDirectory(const char *szFilename)
 	return EraseDirectory(szTempFilename2);
 }
 
-bool C4Group_UnpackDirectory(const char *szFilename)
+// Temporary filename next to szFilename
+// Numbered, so groups of the same name stem unpacked at the same time don't collide
+static void C4Group_MakeUniqueTempFilename(const char *szFilename, char *szTempFilename)
+{
+	SCopy(szFilename, szTempFilename, _MAX_PATH);
+	szTempFilename[GetFilename(szFilename) - szFilename] = 0;
+	SAppend(FormatString("%u-%s", ++C4Group_TempCounter, GetFilename(szFilename)).getData(), szTempFilename, _MAX_PATH);
+	MakeTempFilename(szTempFilename);
+}
+
+bool C4Group_UnpackDirectory(const char *szFilename, bool fStagingOnly)
 {
 	// Already unpacked: success
 	if (DirectoryExists(szFilename)) return true;
@@ -350,6 +414,7 @@ bool C4Group_UnpackDirectory(const char *szFilename)
 	// Open group
 	C4Group hGroup;
 	if (!hGroup.Open(szFilename)) return false;
+	hGroup.SetStagingOnly(fStagingOnly);
 
 	// Process message
 	if (C4Group_ProcessCallback)
@@ -357,8 +422,7 @@ bool C4Group_UnpackDirectory(const char *szFilename)
 
 	// Create target directory
 	char szFoldername[_MAX_PATH + 1];
-	SCopy(szFilename, szFoldername, _MAX_PATH);
-	MakeTempFilename(szFoldername);
+	C4Group_MakeUniqueTempFilename(szFilename, szFoldername);
 	if (!CreateDirectory(szFoldername, nullptr)) { hGroup.Close(); return false; }
 
 	// Extract files to folder
@@ -369,8 +433,7 @@ bool C4Group_UnpackDirectory(const char *szFilename)
 
 	// Rename group file
 	char szTempFilename[_MAX_PATH + 1];
-	SCopy(szFilename, szTempFilename, _MAX_PATH);
-	MakeTempFilename(szTempFilename);
+	C4Group_MakeUniqueTempFilename(szFilename, szTempFilename);
 	if (!RenameFile(szFilename, szTempFilename)) return false;
 
 	// Rename target directory
@@ -386,13 +449,22 @@ bool C4Group_ExplodeDirectory(const char *szFilename)
 	if (C4Group_TestIgnore(szFilename)) return true;
 
 	// Unpack this directory
-	if (!C4Group_UnpackDirectory(szFilename)) return false;
+	// Child groups are exploded right after, so they are extracted without compression
+	if (!C4Group_UnpackDirectory(szFilename, true)) return false;
 
 	// Explode all children
-	ForEachFile(szFilename, C4Group_ExplodeDirectory);
-
-	// Success
-	return true;
+	std::vector<std::string> children;
+	for (DirectoryIterator i(szFilename); *i; i++)
+		children.emplace_back(*i);
+	std::vector<std::function<bool()>> tasks;
+	for (const auto &child : children)
+		tasks.emplace_back([&child]
+		{
+			// plain files stay as they are
+			if (!DirectoryExists(child.c_str()) && !C4Group_IsGroup(child.c_str())) return true;
+			return C4Group_ExplodeDirectory(child.c_str());
+		});
+	return C4Group_RunTasks(tasks);
 }
 
 bool C4Group_ReadFile(const char *szFile, char **pData, size_t *iSize)
@@ -595,6 +667,7 @@ C4Group::C4Group()
 	fnProcessCallback = nullptr;
 	MadeOriginal = false;
 	NoSort = false;
+	StagingOnly = false;
 }
 
 void C4Group::Init()
@@ -971,7 +1044,7 @@ bool C4Group::Save(bool fReOpen)
 
 	// Create the new (temp) group file
 	CStdFile tfile;
-	if (!tfile.Create(szTempFileName, true))
+	if (!tfile.Create(szTempFileName, true, false, StagingOnly ? Z_NO_COMPRESSION : Z_BEST_COMPRESSION))
 	{
 		delete[] save_core; return Error("Close: ...");
 	}
@@ -1027,6 +1100,59 @@ bool C4Group::Save(bool fReOpen)
 	return true;
 }
 
+bool C4Group::HoldEntriesInMemory()
+{
+	// folders write added entries right away
+	if (Status != GRPF_File) return true;
+	// checksums of child groups can only be calculated from disk
+	EntryCRC32(nullptr);
+	for (C4GroupEntry *centry = FirstEntry; centry; centry = centry->Next)
+	{
+		if (centry->Status == C4GRES_InMemory && !centry->HoldBuffer)
+		{
+			uint8_t *pBuf = new uint8_t[centry->Size];
+			if (centry->Size) std::memcpy(pBuf, centry->bpMemBuf, centry->Size);
+			centry->bpMemBuf = pBuf;
+			centry->HoldBuffer = true; centry->BufferIsStdbuf = false;
+		}
+		else if (centry->Status == C4GRES_OnDisk)
+		{
+			char szFileSource[_MAX_FNAME + 1];
+			SCopy(centry->DiskPath, szFileSource, _MAX_FNAME);
+			if (DirectoryExists(szFileSource))
+				return Error("HEIM: Cannot add directory to group file");
+			// renamed child groups are resorted like in AppendEntry2StdFile
+			bool fTempFile = false;
+			if (centry->ChildGroup && !centry->NoSort && !SEqual(GetFilename(szFileSource), centry->FileName))
+			{
+				MakeTempFilename(szFileSource);
+				if (!CopyItem(centry->DiskPath, szFileSource))
+					return Error("HEIM: Cannot copy item");
+				C4Group SortGrp;
+				if (!SortGrp.Open(szFileSource))
+					return Error("HEIM: Cannot open group");
+				if (!SortGrp.SortByList(C4Group_SortList, centry->FileName))
+					return Error("HEIM: Cannot resort group");
+				fTempFile = true;
+				SortGrp.Close();
+			}
+			// load contents
+			std::unique_ptr<uint8_t[]> pBuf{new uint8_t[centry->Size]};
+			CStdFile hSource;
+			const bool fLoaded = hSource.Open(szFileSource, !!centry->ChildGroup) && (!centry->Size || hSource.Read(pBuf.get(), centry->Size));
+			hSource.Close();
+			if (fTempFile) EraseItem(szFileSource);
+			if (!fLoaded) return Error("HEIM: Cannot read on-disk file");
+			if (centry->DeleteOnDisk) EraseItem(centry->DiskPath);
+			centry->Status = C4GRES_InMemory;
+			centry->bpMemBuf = pBuf.release();
+			centry->HoldBuffer = true; centry->BufferIsStdbuf = false;
+			centry->DeleteOnDisk = false;
+		}
+	}
+	return true;
+}
+
 void C4Group::Default()
 {
 	FirstEntry = nullptr;
@@ -1061,19 +1187,22 @@ void C4Group::Clear()
 bool C4Group::AppendEntry2StdFile(C4GroupEntry *centry, CStdFile &hTarget)
 {
 	CStdFile hSource;
-	long csize;
-	uint8_t fbuf;
+	size_t csize, cchunk;
+	// copy in chunks of up to the compression buffer size
+	const size_t iBufSize = std::clamp<size_t>(centry->Size, 1, StdGzCompressedFile::ChunkSize);
+	const std::unique_ptr<uint8_t[]> fbuf{new uint8_t[iBufSize]};
 
 	switch (centry->Status)
 	{
 	case C4GRES_InGroup: // Copy from group to std file
 		if (!SetFilePtr(centry->Offset))
 			return Error("AE2S: Cannot set file pointer");
-		for (csize = centry->Size; csize > 0; csize--)
+		for (csize = centry->Size; csize > 0; csize -= cchunk)
 		{
-			if (!Read(&fbuf, 1))
+			cchunk = std::min(csize, iBufSize);
+			if (!Read(fbuf.get(), cchunk))
 				return Error("AE2S: Cannot read entry from group file");
-			if (!hTarget.Write(&fbuf, 1))
+			if (!hTarget.Write(fbuf.get(), cchunk))
 				return Error("AE2S: Cannot write to target file");
 		}
 		break;
@@ -1112,13 +1241,14 @@ bool C4Group::AppendEntry2StdFile(C4GroupEntry *centry, CStdFile &hTarget)
 		// Append disk source to target file
 		if (!hSource.Open(szFileSource, !!centry->ChildGroup))
 			return Error("AE2S: Cannot open on-disk file");
-		for (csize = centry->Size; csize > 0; csize--)
+		for (csize = centry->Size; csize > 0; csize -= cchunk)
 		{
-			if (!hSource.Read(&fbuf, 1))
+			cchunk = std::min(csize, iBufSize);
+			if (!hSource.Read(fbuf.get(), cchunk))
 			{
 				hSource.Close(); return Error("AE2S: Cannot read on-disk file");
 			}
-			if (!hTarget.Write(&fbuf, 1))
+			if (!hTarget.Write(fbuf.get(), cchunk))
 			{
 				hSource.Close(); return Error("AE2S: Cannot write to target file");
 			}
@@ -1734,7 +1864,9 @@ bool C4Group::ExtractEntry(const char *szFilename, const char *szExtractTo)
 		SCopy(szTargetFName, szTempFName, _MAX_FNAME);
 		MakeTempFilename(szTempFName);
 		// Create temp target file
-		if (!tfile.Create(szTempFName, !!pEntry->ChildGroup, !!pEntry->Executable))
+		// (ignored child groups are not unpacked any further, so they are always compressed)
+		if (!tfile.Create(szTempFName, !!pEntry->ChildGroup, !!pEntry->Executable,
+			StagingOnly && !C4Group_TestIgnore(szFilename) ? Z_NO_COMPRESSION : Z_BEST_COMPRESSION))
 			return Error("Extract: Cannot create target file");
 		// Write entry file to temp target file
 		if (!AppendEntry2StdFile(pEntry, tfile))
@@ -62,13 +62,14 @@ void C4Group_SetTempPath(const char *szPath);
 const char *C4Group_GetTempPath();
 void C4Group_SetSortList(const char **ppSortList);
 void C4Group_SetProcessCallback(bool(*fnCallback)(const char *, int));
+void C4Group_SetWorkerThreads(int32_t iThreads); // threads for packing and exploding directories; 0 = automatic, 1 = no additional threads
 bool C4Group_IsGroup(const char *szFilename);
 bool C4Group_CopyItem(const char *szSource, const char *szTarget, bool fNoSort = false, bool fResetAttributes = false);
 bool C4Group_MoveItem(const char *szSource, const char *szTarget, bool fNoSort = false);
 bool C4Group_DeleteItem(const char *szItem, bool fRecycle = false);
-bool C4Group_PackDirectoryTo(const char *szFilename, const char *szFilenameTo);
+bool C4Group_PackDirectoryTo(const char *szFilename, const char *szFilenameTo, bool fStagingOnly = false);
 bool C4Group_PackDirectory(const char *szFilename);
-bool C4Group_UnpackDirectory(const char *szFilename);
+bool C4Group_UnpackDirectory(const char *szFilename, bool fStagingOnly = false);
 bool C4Group_ExplodeDirectory(const char *szFilename);
 bool C4Group_ReadFile(const char *szFilename, char **pData, size_t *iSize);
 bool C4Group_GetFileCRC(const char *szFilename, uint32_t *pCRC32);
@@ -179,11 +180,13 @@ protected:
 	bool MadeOriginal;
 
 	bool NoSort; // If this flag is set, all entries will be marked NoSort in AddEntry
+	bool StagingOnly; // If this flag is set, the group file and extracted child groups are written without compression, because they are unpacked again right away
 
 public:
 	bool Open(const char *szGroupName, bool fCreate = false);
 	bool Close();
 	bool Save(bool fReOpen);
+	bool HoldEntriesInMemory(); // load entries added from disk or unheld buffers into owned memory, so the group can be saved after their sources changed
 	bool OpenAsChild(C4Group *pMother, const char *szEntryName, bool fExclusive = false);
 	bool OpenChild(const char *strEntry);
 	bool OpenMother();
@@ -246,6 +249,7 @@ public:
 	inline bool IsPacked() { return Status == GRPF_File; }
 	inline bool HasPackedMother() { if (!Mother) return false; return Mother->IsPacked(); }
 	inline bool SetNoSort(bool fNoSort) { NoSort = fNoSort; return true; }
+	inline void SetStagingOnly(bool fStagingOnly) { StagingOnly = fStagingOnly; }
 #ifndef NDEBUG
 	void PrintInternals(const char *szIndent = nullptr);
 #endif
@@ -20,9 +20,14 @@
 #include <C4Include.h>
 #include <C4KeyboardInput.h>
 
+#include <C4Config.h>
 #include <C4Game.h>
+#include <C4Log.h>
 #include <C4Wrappers.h>
 
+#include <algorithm>
+#include <chrono>
+
 #ifdef USE_X11
 #include <X11/Xlib.h>
 #endif
@@ -583,6 +588,26 @@ void C4KeyboardInput::Clear()
 	// clear maps
 	KeysByCode.clear();
 	KeysByName.clear();
+	fDispatchTableDirty = true;
+}
+
+void C4KeyboardInput::AddKeyCode(const C4KeyCodeEx &Code, C4CustomKey *pKey)
+{
+	KeysByCode[Code].push_back(pKey);
+	fDispatchTableDirty = true;
+}
+
+void C4KeyboardInput::RemoveKeyCode(const C4KeyCodeEx &Code, C4CustomKey *pKey)
+{
+	KeyCodeMap::iterator i = KeysByCode.find(Code);
+	if (i == KeysByCode.end()) return;
+	KeyList &Keys = i->second;
+	KeyList::iterator iKey = std::find(Keys.begin(), Keys.end(), pKey);
+	if (iKey == Keys.end()) return;
+	// erase keeps the registration order of the remaining keys
+	Keys.erase(iKey);
+	if (Keys.empty()) KeysByCode.erase(i);
+	fDispatchTableDirty = true;
 }
 
 void C4KeyboardInput::UpdateKeyCodes(C4CustomKey *pKey, const C4CustomKey::CodeList &rOldCodes, const C4CustomKey::CodeList &rNewCodes)
@@ -595,20 +620,14 @@ void C4KeyboardInput::UpdateKeyCodes(C4CustomKey *pKey, const C4CustomKey::CodeL
 	{
 		// no need to kill if code stayed
 		if (std::find(rNewCodes.begin(), rNewCodes.end(), *iCode) != rNewCodes.end()) continue;
-		std::pair<KeyCodeMap::iterator, KeyCodeMap::iterator> KeyRange = KeysByCode.equal_range(*iCode);
-		for (KeyCodeMap::iterator i = KeyRange.first; i != KeyRange.second; ++i)
-			if (i->second == pKey)
-			{
-				KeysByCode.erase(i);
-				break;
-			}
+		RemoveKeyCode(*iCode, pKey);
 	}
 	// readd new codes
 	for (iCode = rNewCodes.begin(); iCode != rNewCodes.end(); ++iCode)
 	{
 		// no double-add if it was in old list already
 		if (std::find(rOldCodes.begin(), rOldCodes.end(), *iCode) != rOldCodes.end()) continue;
-		KeysByCode.insert(std::make_pair(*iCode, pKey));
+		AddKeyCode(*iCode, pKey);
 	}
 }
 
@@ -618,7 +637,8 @@ void C4KeyboardInput::RegisterKey(C4CustomKey *pRegKey)
 	// key will be added: ref it
 	pRegKey->Ref();
 	// search key of same name first
-	C4CustomKey *pDupKey = KeysByName[pRegKey->GetName().getData()];
+	const StdStrBuf &rsName = pRegKey->GetName();
+	C4CustomKey *&pDupKey = KeysByName[std::string(rsName.getData(), rsName.getLength())];
 	if (pDupKey)
 	{
 		// key of this name exists: Merge them (old codes copied cuz they'll be overwritten)
@@ -627,36 +647,30 @@ void C4KeyboardInput::RegisterKey(C4CustomKey *pRegKey)
 		pDupKey->Update(pRegKey);
 		// update access map if key changed
 		if (!(OldCodes == rNewCodes)) UpdateKeyCodes(pDupKey, OldCodes, rNewCodes);
+		// priority may have changed as well
+		fDispatchTableDirty = true;
 		// key to be registered no longer used
 		pRegKey->Deref();
 	}
 	else
 	{
 		// new unique key: Insert into both maps
-		KeysByName[pRegKey->GetName().getData()] = pRegKey;
+		pDupKey = pRegKey;
 		for (C4CustomKey::CodeList::const_iterator i = pRegKey->GetCodes().begin(); i != pRegKey->GetCodes().end(); ++i)
-			KeysByCode.insert(std::make_pair(*i, pRegKey));
+			AddKeyCode(*i, pRegKey);
 	}
 }
 
 void C4KeyboardInput::UnregisterKey(const StdStrBuf &rsName)
 {
 	// kill from name map
-	KeyNameMap::iterator in = KeysByName.find(rsName.getData());
+	KeyNameMap::iterator in = KeysByName.find(std::string(rsName.getData(), rsName.getLength()));
 	if (in == KeysByName.end()) return;
 	C4CustomKey *pKey = in->second;
 	KeysByName.erase(in);
 	// kill all key bindings from key map
 	for (C4CustomKey::CodeList::const_iterator iCode = pKey->GetCodes().begin(); iCode != pKey->GetCodes().end(); ++iCode)
-	{
-		std::pair<KeyCodeMap::iterator, KeyCodeMap::iterator> KeyRange = KeysByCode.equal_range(*iCode);
-		for (KeyCodeMap::iterator i = KeyRange.first; i != KeyRange.second; ++i)
-			if (i->second == pKey)
-			{
-				KeysByCode.erase(i);
-				break;
-			}
-	}
+		RemoveKeyCode(*iCode, pKey);
 	// release reference to key
 	pKey->Deref();
 }
@@ -664,7 +678,8 @@ void C4KeyboardInput::UnregisterKey(const StdStrBuf &rsName)
 void C4KeyboardInput::UnregisterKeyBinding(C4CustomKey *pUnregKey)
 {
 	// find key in name map
-	KeyNameMap::iterator in = KeysByName.find(pUnregKey->GetName().getData());
+	const StdStrBuf &rsName = pUnregKey->GetName();
+	KeyNameMap::iterator in = KeysByName.find(std::string(rsName.getData(), rsName.getLength()));
 	if (in == KeysByName.end()) return;
 	C4CustomKey *pKey = in->second;
 	// is this key in the map?
@@ -683,25 +698,61 @@ void C4KeyboardInput::UnregisterKeyBinding(C4CustomKey *pUnregKey)
 	RegisterKey(pNewKey);
 }
 
+void C4KeyboardInput::BuildDispatchTable()
+{
+	DispatchTable.clear();
+	for (KeyCodeMap::const_iterator i = KeysByCode.begin(); i != KeysByCode.end(); ++i)
+	{
+		KeyList Keys;
+		// keys without priority or above PRIO_MoreThanMax are never executed
+		for (C4CustomKey *pKey : i->second)
+			if (pKey->GetPriority() > C4CustomKey::PRIO_None && pKey->GetPriority() < C4CustomKey::PRIO_MoreThanMax)
+				Keys.push_back(pKey);
+		if (Keys.empty()) continue;
+		// highest priority first; keys of equal priority stay in registration order
+		std::stable_sort(Keys.begin(), Keys.end(),
+			[](const C4CustomKey *pKey1, const C4CustomKey *pKey2) { return pKey1->GetPriority() > pKey2->GetPriority(); });
+		DispatchTable.emplace(i->first, std::move(Keys));
+	}
+	fDispatchTableDirty = false;
+	++iDispatchTableBuilds;
+}
+
+const C4KeyboardInput::KeyList *C4KeyboardInput::GetDispatchList(const C4KeyCodeEx &Code) const
+{
+	KeyCodeMap::const_iterator i = DispatchTable.find(Code);
+	return i == DispatchTable.end() ? nullptr : &i->second;
+}
+
 bool C4KeyboardInput::DoInput(const C4KeyCodeEx &InKey, C4KeyEventType InEvent, uint32_t InScope)
+{
+	if (!Config.Developer.KeyDispatchStats) return DispatchInput(InKey, InEvent, InScope);
+	const auto tStart = std::chrono::steady_clock::now();
+	const bool fResult = DispatchInput(InKey, InEvent, InScope);
+	iDispatchTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tStart).count();
+	++iDispatchCount;
+	return fResult;
+}
+
+bool C4KeyboardInput::DispatchInput(const C4KeyCodeEx &InKey, C4KeyEventType InEvent, uint32_t InScope)
 {
 	// check all key events generated by this key: First the keycode itself, then any more generic key events like KEY_Any
 	const int32_t iKeyRangeMax = 5;
 	int32_t iKeyRangeCnt = 0, j;
-	std::pair<KeyCodeMap::iterator, KeyCodeMap::iterator> KeyRanges[iKeyRangeMax];
-	KeyRanges[iKeyRangeCnt++] = KeysByCode.equal_range(InKey);
+	C4KeyCodeEx KeyRangeCodes[iKeyRangeMax];
+	KeyRangeCodes[iKeyRangeCnt++] = InKey;
 	if (Key_IsGamepadButton(InKey.Key))
 	{
 		uint8_t byGamepad = Key_GetGamepad(InKey.Key);
 		uint8_t byBtnIndex = Key_GetGamepadButtonIndex(InKey.Key);
 		// even/odd button events: Add even button indices as odd events, because byBtnIndex is zero-based and the event naming scheme is for one-based button indices
-		if (byBtnIndex % 2) KeyRanges[iKeyRangeCnt++] = KeysByCode.equal_range(C4KeyCodeEx(KEY_Gamepad(byGamepad, KEY_JOY_AnyEvenButton)));
-		else KeyRanges[iKeyRangeCnt++] = KeysByCode.equal_range(C4KeyCodeEx(KEY_Gamepad(byGamepad, KEY_JOY_AnyOddButton)));
+		if (byBtnIndex % 2) KeyRangeCodes[iKeyRangeCnt++] = C4KeyCodeEx(KEY_Gamepad(byGamepad, KEY_JOY_AnyEvenButton));
+		else KeyRangeCodes[iKeyRangeCnt++] = C4KeyCodeEx(KEY_Gamepad(byGamepad, KEY_JOY_AnyOddButton));
 		// high/low button events
-		if (byBtnIndex < 4) KeyRanges[iKeyRangeCnt++] = KeysByCode.equal_range(C4KeyCodeEx(KEY_Gamepad(byGamepad, KEY_JOY_AnyLowButton)));
-		else KeyRanges[iKeyRangeCnt++] = KeysByCode.equal_range(C4KeyCodeEx(KEY_Gamepad(byGamepad, KEY_JOY_AnyHighButton)));
+		if (byBtnIndex < 4) KeyRangeCodes[iKeyRangeCnt++] = C4KeyCodeEx(KEY_Gamepad(byGamepad, KEY_JOY_AnyLowButton));
+		else KeyRangeCodes[iKeyRangeCnt++] = C4KeyCodeEx(KEY_Gamepad(byGamepad, KEY_JOY_AnyHighButton));
 		// "any gamepad button"-event
-		KeyRanges[iKeyRangeCnt++] = KeysByCode.equal_range(C4KeyCodeEx(KEY_Gamepad(byGamepad, KEY_JOY_AnyButton)));
+		KeyRangeCodes[iKeyRangeCnt++] = C4KeyCodeEx(KEY_Gamepad(byGamepad, KEY_JOY_AnyButton));
 	}
 	else if (Key_IsGamepadAxis(InKey.Key))
 	{
@@ -713,40 +764,65 @@ bool C4KeyboardInput::DoInput(const C4KeyCodeEx &InKey, C4KeyEventType InEvent,
 		if (byAxis % 2)
 			if (fHigh) keyAxisDir = KEY_JOY_Down; else keyAxisDir = KEY_JOY_Up;
 		else if (fHigh) keyAxisDir = KEY_JOY_Right; else keyAxisDir = KEY_JOY_Left;
-		KeyRanges[iKeyRangeCnt++] = KeysByCode.equal_range(C4KeyCodeEx(KEY_Gamepad(byGamepad, static_cast<uint8_t>(keyAxisDir))));
+		KeyRangeCodes[iKeyRangeCnt++] = C4KeyCodeEx(KEY_Gamepad(byGamepad, static_cast<uint8_t>(keyAxisDir)));
 	}
-	if (InKey.Key != KEY_Any) KeyRanges[iKeyRangeCnt++] = KeysByCode.equal_range(C4KeyCodeEx(KEY_Any, C4KeyShiftState(InKey.dwShift)));
+	if (InKey.Key != KEY_Any) KeyRangeCodes[iKeyRangeCnt++] = C4KeyCodeEx(KEY_Any, C4KeyShiftState(InKey.dwShift));
 	assert(iKeyRangeCnt <= iKeyRangeMax);
-	// check all assigned keys
+	// get the keys of all ranges, each sorted by descending priority
+	if (fDispatchTableDirty) BuildDispatchTable();
+	const KeyList *KeyRanges[iKeyRangeMax];
+	size_t KeyRangePos[iKeyRangeMax];
+	uint32_t iTableBuild = iDispatchTableBuilds;
+	for (j = 0; j < iKeyRangeCnt; ++j)
+	{
+		KeyRanges[j] = GetDispatchList(KeyRangeCodes[j]);
+		KeyRangePos[j] = 0;
+	}
 	// exec from highest to lowest priority
 	unsigned int uiLastPrio = C4CustomKey::PRIO_MoreThanMax;
 	for (;;)
 	{
-		KeyCodeMap::const_iterator i;
-		// get priority to exec
+		// get priority to exec: skip anything not below the last priority, then the head of each range is its highest priority left
 		unsigned int uiExecPrio = C4CustomKey::PRIO_None, uiCurr;
 		for (j = 0; j < iKeyRangeCnt; ++j)
-			for (i = KeyRanges[j].first; i != KeyRanges[j].second; ++i)
-			{
-				uiCurr = i->second->GetPriority();
-				if (uiCurr > uiExecPrio && uiCurr < uiLastPrio) uiExecPrio = uiCurr;
-			}
+		{
+			if (!KeyRanges[j]) continue;
+			const KeyList &Keys = *KeyRanges[j];
+			while (KeyRangePos[j] < Keys.size() && Keys[KeyRangePos[j]]->GetPriority() >= uiLastPrio) ++KeyRangePos[j];
+			if (KeyRangePos[j] < Keys.size() && (uiCurr = Keys[KeyRangePos[j]]->GetPriority()) > uiExecPrio) uiExecPrio = uiCurr;
+		}
 		// nothing with correct priority set left?
 		if (uiExecPrio == C4CustomKey::PRIO_None) break;
 		// exec all of this priority
-		for (j = 0; j < iKeyRangeCnt; ++j)
-			for (i = KeyRanges[j].first; i != KeyRanges[j].second; ++i)
+		for (j = 0; j < iKeyRangeCnt && iTableBuild == iDispatchTableBuilds; ++j)
+		{
+			if (!KeyRanges[j]) continue;
+			const KeyList &Keys = *KeyRanges[j];
+			for (; KeyRangePos[j] < Keys.size() && Keys[KeyRangePos[j]]->GetPriority() == uiExecPrio; ++KeyRangePos[j])
 			{
-				C4CustomKey *pKey = i->second;
+				C4CustomKey *pKey = Keys[KeyRangePos[j]];
 				assert(pKey);
-				// check priority
-				if (pKey->GetPriority() == uiExecPrio)
-					// check scope
-					if (pKey->GetScope() & InScope)
-						// exec it
-						if (pKey->Execute(InEvent, InKey))
-							return true;
+				// check scope
+				if (pKey->GetScope() & InScope)
+				{
+					// exec it
+					if (pKey->Execute(InEvent, InKey))
+						return true;
+					// the callback (un)registered keys: continue with the next priority in the new table, because the old one might refer to deleted keys
+					if (fDispatchTableDirty) BuildDispatchTable();
+					if (iTableBuild != iDispatchTableBuilds) break;
+				}
+			}
+		}
+		if (iTableBuild != iDispatchTableBuilds)
+		{
+			iTableBuild = iDispatchTableBuilds;
+			for (j = 0; j < iKeyRangeCnt; ++j)
+			{
+				KeyRanges[j] = GetDispatchList(KeyRangeCodes[j]);
+				KeyRangePos[j] = 0;
 			}
+		}
 		// nothing found in this priority: exec next
 		uiLastPrio = uiExecPrio;
 	}
@@ -754,6 +830,13 @@ bool C4KeyboardInput::DoInput(const C4KeyCodeEx &InKey, C4KeyEventType InEvent,
 	return false;
 }
 
+void C4KeyboardInput::LogDispatchStats()
+{
+	if (!Config.Developer.KeyDispatchStats || !iDispatchCount) return;
+	LogSilentF("Keyboard: %u key events, %u ns per event, %u dispatch table builds for %u keys", iDispatchCount,
+		static_cast<unsigned int>(iDispatchTime / iDispatchCount), iDispatchTableBuilds, static_cast<unsigned int>(KeysByName.size()));
+}
+
 void C4KeyboardInput::CompileFunc(StdCompiler *pComp)
 {
 	// compile all keys that are already defined
@@ -761,7 +844,13 @@ void C4KeyboardInput::CompileFunc(StdCompiler *pComp)
 	pComp->Name("Keys");
 	try
 	{
+		// in name order, so written key configurations stay sorted
+		std::vector<KeyNameMap::const_iterator> Keys;
+		Keys.reserve(KeysByName.size());
 		for (KeyNameMap::const_iterator i = KeysByName.begin(); i != KeysByName.end(); ++i)
+			Keys.push_back(i);
+		std::sort(Keys.begin(), Keys.end(), [](KeyNameMap::const_iterator i1, KeyNameMap::const_iterator i2) { return i1->first < i2->first; });
+		for (KeyNameMap::const_iterator i : Keys)
 		{
 			// naming done in C4CustomKey, because default is determined by key only
 			C4CustomKey::CodeList OldCodes = i->second->GetCodes();
@@ -797,6 +886,7 @@ bool C4KeyboardInput::LoadCustomConfig()
 
 C4CustomKey *C4KeyboardInput::GetKeyByName(const char *szKeyName)
 {
+	if (!szKeyName) return nullptr;
 	KeyNameMap::const_iterator i = KeysByName.find(szKeyName);
 	if (i == KeysByName.end()) return nullptr; else return (*i).second;
 }
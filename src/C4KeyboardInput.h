@@ -24,7 +24,10 @@
 #include "StdBuf.h"
 
 #include <cassert>
+#include <cstdint>
 #include <map>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 // key context classifications
@@ -391,17 +394,26 @@ public:
 class C4KeyboardInput
 {
 private:
-	// comparison fn for map
-	struct szLess
+	// hash fn for code maps
+	struct KeyCodeHash
 	{
-		bool operator()(const char *p, const char *q) const { return p && q && (strcmp(p, q) < 0); }
+		size_t operator()(const C4KeyCodeEx &key) const { return std::hash<uint64_t>()((static_cast<uint64_t>(key.Key) << 32) ^ key.dwShift); }
 	};
 
-	typedef std::multimap<C4KeyCodeEx, C4CustomKey *> KeyCodeMap;
-	typedef std::map<const char *, C4CustomKey *, szLess> KeyNameMap;
-	// mapping of all keys by code and name
+	typedef std::vector<C4CustomKey *> KeyList;
+	typedef std::unordered_map<C4KeyCodeEx, KeyList, KeyCodeHash> KeyCodeMap;
+	typedef std::unordered_map<std::string, C4CustomKey *> KeyNameMap;
+	// mapping of all keys by code (in registration order) and name
 	KeyCodeMap KeysByCode;
 	KeyNameMap KeysByName;
+	// keys by code ordered by descending priority for DoInput; rebuilt from KeysByCode after registration changes
+	KeyCodeMap DispatchTable;
+	bool fDispatchTableDirty{false};
+
+	// dispatch statistics, logged by LogDispatchStats if Config.Developer.KeyDispatchStats is set
+	uint32_t iDispatchCount{0};
+	uint32_t iDispatchTableBuilds{0}; // also identifies the current table, so DispatchInput notices rebuilds caused by callbacks. Never reset
+	uint64_t iDispatchTime{0}; // nanoseconds
 
 public:
 	static bool IsValid; // global var to fix any deinitialization orders of key map and static keys
@@ -414,6 +426,11 @@ public:
 private:
 	// assign keycodes changed for a key: Update codemap
 	void UpdateKeyCodes(C4CustomKey *pKey, const C4CustomKey::CodeList &rOldCodes, const C4CustomKey::CodeList &rNewCodes);
+	void AddKeyCode(const C4KeyCodeEx &Code, C4CustomKey *pKey);
+	void RemoveKeyCode(const C4KeyCodeEx &Code, C4CustomKey *pKey);
+	void BuildDispatchTable();
+	const KeyList *GetDispatchList(const C4KeyCodeEx &Code) const;
+	bool DispatchInput(const C4KeyCodeEx &InKey, C4KeyEventType InEvent, uint32_t InScope);
 
 public:
 	void RegisterKey(C4CustomKey *pRegKey); // register key into code and name maps, or update specific key
@@ -421,6 +438,7 @@ public:
 	void UnregisterKeyBinding(C4CustomKey *pKey); // just remove callbacks from a key
 
 	bool DoInput(const C4KeyCodeEx &InKey, C4KeyEventType InEvent, uint32_t InScope);
+	void LogDispatchStats();
 
 	void CompileFunc(StdCompiler *pComp);
 	bool LoadCustomConfig(); // load keyboard customization file
@@ -255,6 +255,9 @@ void C4Landscape::Clear(bool fClearMapCreator, bool fClearSky)
 	// clear pixel count
 	delete[] PixCnt;         PixCnt           = nullptr;
 	PixCntPitch = 0;
+	// clear change stamps; ChangeStamp keeps counting, so stamps of old caches stay outdated
+	RegionChangeStamps.clear();
+	ChangeRegionsWdt = ChangeRegionsHgt = 0;
 }
 
 void C4Landscape::Draw(C4FacetEx &cgo, int32_t iPlayer)
@@ -733,6 +736,11 @@ bool C4Landscape::Init(C4Group &hGroup, bool fOverloadCurrent, bool fLoadSky, bo
 	// and not creating the map
 	Game.FixRandom(Game.Parameters.RandomSeed);
 
+	// Hash the final landscape once; changes are tracked from here on
+	PixHash = 0;
+	UpdatePixHash(C4Rect(0, 0, Width, Height), true);
+	ResetChangeStamps();
+
 	// Success
 	rfLoaded = true;
 	return true;
@@ -775,6 +783,16 @@ bool C4Landscape::SetPixDw(int32_t x, int32_t y, uint32_t dwPix)
 	return ret;
 }
 
+// hash of a single landscape pixel; order independent, so the sum can be updated per pixel
+static inline uint32_t PixHashOf(int32_t x, int32_t y, uint8_t pix)
+{
+	if (!pix) return 0;
+	uint32_t h = (static_cast<uint32_t>(x) * 0x9e3779b1u) ^ (static_cast<uint32_t>(y) * 0x85ebca77u) ^ (pix * 0xc2b2ae3du);
+	h ^= h >> 15; h *= 0x2c1b3c6du;
+	h ^= h >> 12; h *= 0x297a2d39u;
+	return h ^ (h >> 15);
+}
+
 bool C4Landscape::_SetPix(int32_t x, int32_t y, uint8_t npix)
 {
 #ifdef DEBUGREC
@@ -786,6 +804,11 @@ bool C4Landscape::_SetPix(int32_t x, int32_t y, uint8_t npix)
 	// get and check pixel
 	uint8_t opix = _GetPix(x, y);
 	if (npix == opix) return true;
+	// sync hash
+	PixHash += PixHashOf(x, y, npix) - PixHashOf(x, y, opix);
+	NotifyChange(x, y);
+	// cached paths might be affected
+	if (Pix2Dens[npix] != Pix2Dens[opix]) Game.PathFinder.NotifyLandscapeChange(x, y);
 	// count pixels
 	if (Pix2Dens[npix])
 	{
@@ -1647,6 +1670,9 @@ void C4Landscape::Default()
 	AnimationSurface = nullptr;
 	Map = nullptr;
 	Width = Height = 0;
+	PixHash = 0;
+	RegionChangeStamps.clear();
+	ChangeRegionsWdt = ChangeRegionsHgt = 0;
 	MapWidth = MapHeight = MapZoom = 0;
 	ClearMatCount();
 	ClearBlastMatCount();
@@ -2504,17 +2530,10 @@ bool C4Landscape::DoRelights()
 		C4Rect SolidMaskRect = Relights[i];
 		SolidMaskRect.x -= 2 * C4LS_MaxLightDistX; SolidMaskRect.y -= 2 * C4LS_MaxLightDistY;
 		SolidMaskRect.Wdt += 4 * C4LS_MaxLightDistX; SolidMaskRect.Hgt += 4 * C4LS_MaxLightDistY;
-		C4SolidMask *pSolid;
-		for (pSolid = C4SolidMask::Last; pSolid; pSolid = pSolid->Prev)
-		{
-			pSolid->RemoveTemporary(SolidMaskRect);
-		}
+		C4SolidMask::RemoveTemporaryAll(SolidMaskRect);
 		Relight(Relights[i]);
 		// Restore Solidmasks
-		for (pSolid = C4SolidMask::First; pSolid; pSolid = pSolid->Next)
-		{
-			pSolid->PutTemporary(SolidMaskRect);
-		}
+		C4SolidMask::PutTemporaryAll(SolidMaskRect);
 		Relights[i].Default();
 		C4SolidMask::CheckConsistency();
 	}
@@ -2827,6 +2846,9 @@ void C4Landscape::UpdatePixMaps()
 	for (i = 0; i < 256; i++) Pix2Dens[i] = MatDensity(Pix2Mat[i]);
 	for (i = 0; i < 256; i++) Pix2Place[i] = MatValid(Pix2Mat[i]) ? Game.Material.Map[Pix2Mat[i]].Placement : 0;
 	Pix2Place[0] = 0;
+	// densities might have changed
+	Game.PathFinder.ClearCache();
+	if (!RegionChangeStamps.empty()) ResetChangeStamps();
 }
 
 bool C4Landscape::Mat2Pal()
@@ -2858,26 +2880,30 @@ void C4Landscape::PrepareChange(C4Rect BoundingBox, const bool updateMatCnt)
 	C4Rect SolidMaskRect = BoundingBox;
 	SolidMaskRect.x -= 2 * C4LS_MaxLightDistX; SolidMaskRect.y -= 2 * C4LS_MaxLightDistY;
 	SolidMaskRect.Wdt += 4 * C4LS_MaxLightDistX; SolidMaskRect.Hgt += 4 * C4LS_MaxLightDistY;
-	for (C4SolidMask *pSolid = C4SolidMask::Last; pSolid; pSolid = pSolid->Prev)
+	C4SolidMask::RemoveTemporaryAll(SolidMaskRect);
+	if (updateMatCnt)
 	{
-		pSolid->RemoveTemporary(SolidMaskRect);
+		UpdateMatCnt(BoundingBox, false);
+		UpdatePixHash(BoundingBox, false);
 	}
-	if (updateMatCnt) UpdateMatCnt(BoundingBox, false);
 }
 
 void C4Landscape::FinishChange(C4Rect BoundingBox, const bool updateMatAndPixCnt)
 {
 	// relight
 	Relight(BoundingBox);
-	if (updateMatAndPixCnt) UpdateMatCnt(BoundingBox, true);
+	if (updateMatAndPixCnt)
+	{
+		UpdateMatCnt(BoundingBox, true);
+		UpdatePixHash(BoundingBox, true);
+	}
+	Game.PathFinder.NotifyLandscapeChange(BoundingBox);
+	NotifyChange(BoundingBox);
 	// Restore Solidmasks
 	C4Rect SolidMaskRect = BoundingBox;
 	SolidMaskRect.x -= 2 * C4LS_MaxLightDistX; SolidMaskRect.y -= 2 * C4LS_MaxLightDistY;
 	SolidMaskRect.Wdt += 4 * C4LS_MaxLightDistX; SolidMaskRect.Hgt += 4 * C4LS_MaxLightDistY;
-	for (C4SolidMask *pSolid = C4SolidMask::First; pSolid; pSolid = pSolid->Next)
-	{
-		pSolid->Repair(SolidMaskRect);
-	}
+	C4SolidMask::RepairAll(SolidMaskRect);
 	if (updateMatAndPixCnt) UpdatePixCnt(BoundingBox);
 	C4SolidMask::CheckConsistency();
 }
@@ -2899,6 +2925,47 @@ void C4Landscape::UpdatePixCnt(const C4Rect &Rect, bool fCheck)
 		}
 }
 
+void C4Landscape::UpdatePixHash(C4Rect Rect, bool fPlus)
+{
+	Rect.Intersect(C4Rect(0, 0, Width, Height));
+	uint32_t dwHash = 0;
+	for (int32_t y = Rect.y; y < Rect.y + Rect.Hgt; y++)
+		for (int32_t x = Rect.x; x < Rect.x + Rect.Wdt; x++)
+			dwHash += PixHashOf(x, y, _GetPix(x, y));
+	if (fPlus) PixHash += dwHash; else PixHash -= dwHash;
+}
+
+void C4Landscape::ResetChangeStamps()
+{
+	ChangeRegionsWdt = (Width >> ChangeRegionShift) + 1;
+	ChangeRegionsHgt = (Height >> ChangeRegionShift) + 1;
+	RegionChangeStamps.assign(ChangeRegionsWdt * ChangeRegionsHgt, ++ChangeStamp);
+}
+
+void C4Landscape::NotifyChange(const C4Rect &rect)
+{
+	const int32_t iX1 = std::max<int32_t>(rect.x >> ChangeRegionShift, 0), iY1 = std::max<int32_t>(rect.y >> ChangeRegionShift, 0);
+	const int32_t iX2 = std::min<int32_t>((rect.x + rect.Wdt) >> ChangeRegionShift, ChangeRegionsWdt - 1), iY2 = std::min<int32_t>((rect.y + rect.Hgt) >> ChangeRegionShift, ChangeRegionsHgt - 1);
+	if (iX1 > iX2 || iY1 > iY2) return;
+	++ChangeStamp;
+	for (int32_t y = iY1; y <= iY2; y++)
+		for (int32_t x = iX1; x <= iX2; x++)
+			RegionChangeStamps[y * ChangeRegionsWdt + x] = ChangeStamp;
+}
+
+bool C4Landscape::HasChangedSince(const C4Rect &rect, uint64_t iStamp) const
+{
+	// outside the landscape (or without any landscape), pixels depend on the side openings
+	if (rect.x < 0 || rect.y < 0 || rect.x + rect.Wdt > Width || rect.y + rect.Hgt > Height || RegionChangeStamps.empty()) return true;
+	const int32_t iX1 = rect.x >> ChangeRegionShift, iY1 = rect.y >> ChangeRegionShift;
+	const int32_t iX2 = (rect.x + rect.Wdt - 1) >> ChangeRegionShift, iY2 = (rect.y + rect.Hgt - 1) >> ChangeRegionShift;
+	for (int32_t y = iY1; y <= iY2; y++)
+		for (int32_t x = iX1; x <= iX2; x++)
+			if (RegionChangeStamps[y * ChangeRegionsWdt + x] > iStamp)
+				return true;
+	return false;
+}
+
 void C4Landscape::UpdateMatCnt(C4Rect Rect, bool fPlus)
 {
 	Rect.Intersect(C4Rect(0, 0, Width, Height));
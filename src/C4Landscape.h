@@ -25,6 +25,7 @@
 #include <StdSurface8.h>
 
 #include <cstdint>
+#include <vector>
 
 const uint8_t GBM        = 128,
               GBM_ColNum = 64,
@@ -79,6 +80,11 @@ protected:
 	int32_t Pix2Mat[256], Pix2Dens[256], Pix2Place[256];
 	int32_t PixCntPitch;
 	uint8_t *PixCnt;
+	uint32_t PixHash; // sum of all pixel hashes, kept up to date by _SetPix and PrepareChange/FinishChange - NoSave //
+	// stamps of the last change in each region, for caches of landscape-derived data - NoSave //
+	uint64_t ChangeStamp{0};
+	std::vector<uint64_t> RegionChangeStamps;
+	int32_t ChangeRegionsWdt, ChangeRegionsHgt;
 	C4Rect Relights[C4LS_MaxRelights];
 
 public:
@@ -130,6 +136,11 @@ public:
 	bool DrawChunks(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, int32_t icntx, int32_t icnty, const char *szMaterial, const char *szTexture, bool bIFT);
 	bool DrawQuad(int32_t iX1, int32_t iY1, int32_t iX2, int32_t iY2, int32_t iX3, int32_t iY3, int32_t iX4, int32_t iY4, const char *szMaterial, bool bIFT);
 	CStdPalette *GetPal() const { return Surface8 ? Surface8->pPal : nullptr; }
+	uint32_t GetPixHash() const { return PixHash; } // for sync checks
+
+	static constexpr int32_t ChangeRegionShift = 4;
+	uint64_t GetChangeStamp() const { return ChangeStamp; }
+	bool HasChangedSince(const C4Rect &rect, uint64_t iStamp) const; // whether any pixel in rect might have changed after GetChangeStamp returned iStamp
 
 	inline uint8_t _GetPix(int32_t x, int32_t y) // get landscape pixel (bounds not checked)
 	{
@@ -241,6 +252,14 @@ protected:
 
 	void UpdatePixCnt(const class C4Rect &Rect, bool fCheck = false);
 	void UpdateMatCnt(C4Rect Rect, bool fPlus);
+	void UpdatePixHash(C4Rect Rect, bool fPlus);
+	void ResetChangeStamps(); // mark everything as changed
+	void NotifyChange(int32_t x, int32_t y)
+	{
+		const auto index = static_cast<size_t>((y >> ChangeRegionShift) * ChangeRegionsWdt + (x >> ChangeRegionShift));
+		if (index < RegionChangeStamps.size()) RegionChangeStamps[index] = ++ChangeStamp;
+	}
+	void NotifyChange(const C4Rect &rect);
 	void PrepareChange(C4Rect BoundingBox, bool updateMatCnt = true);
 	void FinishChange(C4Rect BoundingBox, bool updateMatAndPixCnt = true);
 	static bool DrawLineLandscape(int32_t iX, int32_t iY, int32_t iGrade);
@@ -24,14 +24,143 @@
 #include <C4LogBuf.h>
 #include <C4Language.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+
 #ifdef _WIN32
+#include <io.h>
 #include <share.h>
+#else
+#include <unistd.h>
 #endif
 
+// Writes log lines on a separate thread, so disk latency does not stall the caller.
+// Lines are passed through a lock-free ring buffer with a single producer (the main thread,
+// which all logging is funneled to) and a single consumer (the writer thread).
+class C4LogWriter
+{
+public:
+	C4LogWriter(FILE *pFile);
+	~C4LogWriter(); // writes all pending lines
+
+	void Write(const char *szLine, size_t iLength);
+	void Flush(); // wait until all pending lines are written
+	void WriteOnCrash(); // write pending lines directly from the crashing thread
+	uint32_t GetStallCount() const { return iStallCount; }
+
+private:
+	static constexpr size_t BufferSize = 1 << 18;
+
+	FILE *pFile;
+	int iFD; // of pFile, for WriteOnCrash
+	std::unique_ptr<char[]> Buffer;
+	// total bytes written to and read from the buffer; positions are taken modulo BufferSize
+	std::atomic<size_t> ReadPos{0}, WritePos{0};
+	std::atomic<uint32_t> Signal{0}; // bumped to wake up the writer thread
+	std::atomic<bool> fStop{false};
+	uint32_t iStallCount{0}; // number of times the buffer was full
+	std::thread Thread;
+
+	void Wake();
+	void Execute();
+};
+
+C4LogWriter::C4LogWriter(FILE *pFile) : pFile(pFile), iFD(fileno(pFile)), Buffer(std::make_unique<char[]>(BufferSize)), Thread(&C4LogWriter::Execute, this) {}
+
+C4LogWriter::~C4LogWriter()
+{
+	fStop.store(true, std::memory_order_release);
+	Wake();
+	Thread.join();
+}
+
+void C4LogWriter::Wake()
+{
+	Signal.fetch_add(1, std::memory_order_release);
+	Signal.notify_one();
+}
+
+void C4LogWriter::Write(const char *szLine, size_t iLength)
+{
+	while (iLength)
+	{
+		const size_t iWritePos = WritePos.load(std::memory_order_relaxed);
+		const size_t iReadPos = ReadPos.load(std::memory_order_acquire);
+		const size_t iFree = BufferSize - (iWritePos - iReadPos);
+		if (!iFree)
+		{
+			// buffer full: wait for the writer instead of dropping lines
+			++iStallCount;
+			Wake();
+			ReadPos.wait(iReadPos, std::memory_order_acquire);
+			continue;
+		}
+		const size_t iChunk = std::min({iLength, iFree, BufferSize - iWritePos % BufferSize});
+		std::memcpy(Buffer.get() + iWritePos % BufferSize, szLine, iChunk);
+		WritePos.store(iWritePos + iChunk, std::memory_order_release);
+		szLine += iChunk; iLength -= iChunk;
+	}
+	Wake();
+}
+
+void C4LogWriter::Flush()
+{
+	Wake();
+	for (;;)
+	{
+		const size_t iReadPos = ReadPos.load(std::memory_order_acquire);
+		if (iReadPos == WritePos.load(std::memory_order_acquire)) break;
+		ReadPos.wait(iReadPos, std::memory_order_acquire);
+	}
+}
+
+void C4LogWriter::WriteOnCrash()
+{
+	// the writer thread might be writing the same data right now; duplicate lines are better than lost ones
+	// no stdio calls: the crashed writer thread may hold the lock of pFile. Lines it has written but
+	// not flushed yet are still in the ring buffer, because ReadPos only advances after fflush
+	const size_t iReadPos = ReadPos.load(std::memory_order_acquire), iWritePos = WritePos.load(std::memory_order_acquire);
+	for (size_t iPos = iReadPos; iPos < iWritePos;)
+	{
+		const size_t iChunk = std::min(iWritePos - iPos, BufferSize - iPos % BufferSize);
+		if (write(iFD, Buffer.get() + iPos % BufferSize, static_cast<unsigned int>(iChunk)) <= 0) break;
+		iPos += iChunk;
+	}
+}
+
+void C4LogWriter::Execute()
+{
+	for (;;)
+	{
+		const uint32_t iSignal = Signal.load(std::memory_order_acquire);
+		const size_t iReadPos = ReadPos.load(std::memory_order_relaxed);
+		const size_t iWritePos = WritePos.load(std::memory_order_acquire);
+		if (iReadPos == iWritePos)
+		{
+			if (fStop.load(std::memory_order_acquire)) break;
+			Signal.wait(iSignal, std::memory_order_acquire);
+			continue;
+		}
+		// write everything that has piled up and flush once
+		const size_t iStart = iReadPos % BufferSize, iLength = iWritePos - iReadPos;
+		const size_t iFirst = std::min(iLength, BufferSize - iStart);
+		fwrite(Buffer.get() + iStart, 1, iFirst, pFile);
+		if (iFirst < iLength) fwrite(Buffer.get(), 1, iLength - iFirst, pFile);
+		fflush(pFile);
+		ReadPos.store(iWritePos, std::memory_order_release);
+		ReadPos.notify_all();
+	}
+}
+
 FILE *C4LogFile = nullptr;
 time_t C4LogStartTime;
 StdStrBuf sLogFileName;
 
+std::unique_ptr<C4LogWriter> LogFileWriter, ConsoleWriter;
+
 StdStrBuf sFatalError;
 
 void OpenLog()
@@ -63,10 +192,21 @@ void OpenLog()
 	}
 	// save start time
 	time(&C4LogStartTime);
+	// start writer threads
+	if (Config.Developer.AsyncLog)
+	{
+		LogFileWriter = std::make_unique<C4LogWriter>(C4LogFile);
+		ConsoleWriter = std::make_unique<C4LogWriter>(stdout);
+	}
 }
 
 bool CloseLog()
 {
+	// write pending lines
+	if (LogFileWriter && LogFileWriter->GetStallCount())
+		LogSilentF("Log: Writer could not keep up %u times", LogFileWriter->GetStallCount());
+	LogFileWriter.reset();
+	ConsoleWriter.reset();
 	// close
 	if (C4LogFile) fclose(C4LogFile); C4LogFile = nullptr;
 	// ok
@@ -81,6 +221,12 @@ int GetLogFD()
 		return -1;
 }
 
+void FlushLogOnCrash()
+{
+	if (LogFileWriter) LogFileWriter->WriteOnCrash();
+	if (ConsoleWriter) ConsoleWriter->WriteOnCrash();
+}
+
 bool LogSilent(const char *szMessage, bool fConsole)
 {
 	// security
@@ -131,7 +277,9 @@ bool LogSilent(const char *szMessage, bool fConsole)
 #endif
 
 		// Save into log file
-		if (C4LogFile)
+		if (LogFileWriter)
+			LogFileWriter->Write(Line.getData(), std::strlen(Line.getData()));
+		else if (C4LogFile)
 		{
 			fputs(Line.getData(), C4LogFile);
 			fflush(C4LogFile);
@@ -144,8 +292,13 @@ bool LogSilent(const char *szMessage, bool fConsole)
 			// debug: output to VC console
 			OutputDebugString(Line.getData());
 #endif
-			fputs(Line.getData(), stdout);
-			fflush(stdout);
+			if (ConsoleWriter)
+				ConsoleWriter->Write(Line.getData(), std::strlen(Line.getData()));
+			else
+			{
+				fputs(Line.getData(), stdout);
+				fflush(stdout);
+			}
 		}
 	} while (*pSrc);
 
@@ -226,6 +379,8 @@ bool DebugLog(const char *strMessage)
 
 size_t GetLogPos()
 {
+	// pending lines are not in the file yet
+	if (LogFileWriter) LogFileWriter->Flush();
 	// get current log position
 	return FileSize(sLogFileName.getData());
 }
@@ -233,6 +388,7 @@ size_t GetLogPos()
 bool GetLogSection(size_t iStart, size_t iLength, StdStrBuf &rsOut)
 {
 	if (!iLength) { rsOut.Clear(); return true; }
+	if (LogFileWriter) LogFileWriter->Flush();
 	// read section from log file
 	CStdFile LogFileRead;
 	char *szBuf, *szBufOrig; size_t iSize; // size exclusing terminator
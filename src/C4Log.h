@@ -53,3 +53,4 @@ bool GetLogSection(size_t iStart, size_t iLength, StdStrBuf &rsOut); // re-read
 
 // Used to print a backtrace after a crash
 int GetLogFD();
+void FlushLogOnCrash(); // write out pending log lines without locking or allocating
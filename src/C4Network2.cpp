@@ -41,6 +41,7 @@
 #endif
 
 #include <cassert>
+#include <memory>
 
 // *** C4Network2Status
 
@@ -189,6 +190,7 @@ C4Network2::C4Network2()
 	: Clients(&NetIO),
 	fAllowJoin(false),
 	iDynamicTick(-1), fDynamicNeeded(false),
+	fDynamicSaveDone(false), fDynamicSaveSuccess(false), iDynamicSaveTick(-1), fDynamicSaveSync(false),
 	fStatusAck(false), fStatusReached(false),
 	fChasing(false),
 	pLobby(nullptr), fLobbyRunning(false), pLobbyCountdown(nullptr),
@@ -675,8 +677,11 @@ void C4Network2::Execute()
 
 	if (isHost())
 	{
+		// background save finished?
+		if (isDynamicSavePending())
+			CheckDynamicSave();
 		// remove dynamic
-		if (!ResDynamic.isNull() && Game.Control.ControlTick > iDynamicTick)
+		else if (!ResDynamic.isNull() && Game.Control.ControlTick > iDynamicTick)
 			RemoveDynamic();
 		// Set chase target
 		UpdateChaseTarget();
@@ -756,13 +761,15 @@ void C4Network2::Clear()
 	Clients.Clear();
 	// close net classes
 	NetIO.Clear();
+	// stop background save
+	AbortDynamicSave();
 	// clear ressources
 	ResList.Clear();
 	// clear password
 	sPassword.Clear();
 	// stuff
 	fAllowJoin = false;
-	iDynamicTick = -1; fDynamicNeeded = false;
+	iDynamicTick = -1; fDynamicNeeded = false; fDynamicSaveSync = false;
 	iLastActivateRequest = iLastChaseTargetUpdate = iLastReferenceUpdate = iLastLeagueUpdate = 0;
 	fDelayedActivateReq = false;
 	if (Game.pGUI) delete pVoteDialog; pVoteDialog = nullptr;
@@ -1083,23 +1090,30 @@ void C4Network2::InitPuncher()
 void C4Network2::OnGameSynchronized()
 {
 	// savegame needed?
-	if (fDynamicNeeded)
+	if (fDynamicNeeded && !isDynamicSavePending())
 	{
 		// create dynamic
 		bool fSuccess = CreateDynamic(false);
-		// check for clients that still need join-data
-		C4Network2Client *pClient = nullptr;
-		while (pClient = Clients.GetNextClient(pClient))
-			if (!pClient->hasJoinData())
-				if (fSuccess)
-					// now we can provide join data: send it
-					SendJoinData(pClient);
-				else
-					// join data could not be created: emergency kick
-					Game.Clients.CtrlRemove(pClient->getClient(), LoadResStr("IDS_ERR_ERRORWHILECREATINGJOINDAT"));
+		// join data will be sent once the background save has finished
+		if (fSuccess && isDynamicSavePending()) return;
+		SendPendingJoinData(fSuccess);
 	}
 }
 
+void C4Network2::SendPendingJoinData(bool fDynamicCreated)
+{
+	// check for clients that still need join-data
+	C4Network2Client *pClient = nullptr;
+	while (pClient = Clients.GetNextClient(pClient))
+		if (!pClient->hasJoinData())
+			if (fDynamicCreated)
+				// now we can provide join data: send it
+				SendJoinData(pClient);
+			else
+				// join data could not be created: emergency kick
+				Game.Clients.CtrlRemove(pClient->getClient(), LoadResStr("IDS_ERR_ERRORWHILECREATINGJOINDAT"));
+}
+
 void C4Network2::DrawStatus(C4FacetEx &cgo)
 {
 	if (!isEnabled()) return;
@@ -1787,6 +1801,8 @@ void C4Network2::SendJoinData(C4Network2Client *pClient)
 	if (pClient->hasJoinData()) return;
 	// host only, scenario must be available
 	assert(isHost());
+	// dynamic is being saved in the background? Will be sent when done
+	if (isDynamicSavePending()) return;
 	// dynamic available?
 	if (ResDynamic.isNull() || iDynamicTick < Game.Control.ControlTick)
 	{
@@ -1919,6 +1935,15 @@ bool C4Network2::CreateDynamic(bool fInit)
 	ssprintf(szDynamicBase, Config.AtNetworkPath("Dyn%s"), GetFilename(Game.ScenarioFilename), _MAX_PATH);
 	if (!ResList.FindTempResFileName(szDynamicBase, szDynamicFilename))
 		Log(LoadResStr("IDS_NET_SAVE_ERR_CREATEDYNFILE"));
+	// save in the background if possible: the game state is collected into
+	// the group right away, but compressing and writing it is left to a thread
+	const bool fSync = fDynamicSaveSync;
+	fDynamicSaveSync = false;
+	if (!fInit && !fSync && Config.Network.BackgroundDynamicSave && StartDynamicSave(szDynamicFilename))
+	{
+		fDynamicNeeded = false;
+		return true;
+	}
 	// save dynamic data
 	C4GameSaveNetwork SaveGame(fInit);
 	if (!SaveGame.Save(szDynamicFilename) || !SaveGame.Close())
@@ -1926,16 +1951,103 @@ bool C4Network2::CreateDynamic(bool fInit)
 		Log(LoadResStr("IDS_NET_SAVE_ERR_SAVEDYNFILE")); return false;
 	}
 	// add ressource
-	C4Network2Res::Ref pRes = ResList.AddByFile(szDynamicFilename, true, NRT_Dynamic);
+	return AddDynamic(szDynamicFilename, Game.Control.getNextControlTick());
+}
+
+bool C4Network2::AddDynamic(const char *szFilename, int32_t iTick)
+{
+	// add ressource
+	C4Network2Res::Ref pRes = ResList.AddByFile(szFilename, true, NRT_Dynamic);
 	if (!pRes) { Log(LoadResStr("IDS_NET_SAVE_ERR_ADDDYNDATARES")); return false; }
 	// save
+	SetDynamic(pRes, iTick);
+	// ok
+	return true;
+}
+
+void C4Network2::SetDynamic(C4Network2Res *pRes, int32_t iTick)
+{
 	ResDynamic = pRes->getCore();
-	iDynamicTick = Game.Control.getNextControlTick();
+	iDynamicTick = iTick;
 	fDynamicNeeded = false;
-	// ok
+}
+
+bool C4Network2::StartDynamicSave(const char *szFilename)
+{
+	// collect all data now; entries saved through temp files (landscape, objects) are
+	// loaded into memory, because other saves of the running game reuse those temp files
+	auto pGroup = std::make_unique<C4Group>();
+	EraseItem(szFilename);
+	if (!pGroup->Open(szFilename, true)) return false;
+	C4GameSaveNetwork SaveGame(false);
+	if (!SaveGame.Save(*pGroup, false) || !SaveGame.Close() || !pGroup->HoldEntriesInMemory())
+	{
+		LogSilentF("Network: Could not prepare background save (%s), saving synchronously", pGroup->GetError());
+		pGroup.reset();
+		EraseItem(szFilename);
+		return false;
+	}
+	// the group no longer refers to anything but its target file, which is unique for this dynamic
+	iDynamicSaveTick = Game.Control.getNextControlTick();
+	DynamicSaveFilename.Copy(szFilename);
+	fDynamicSaveDone = false;
+	// the ressource is reserved here, but hashing the written file is left to the thread as well
+	const int32_t iResID = ResList.nextResID();
+	StdStrBuf ResName; ResName.Copy(Config.AtExeRelativePath(szFilename));
+	DynamicSaveRes = new C4Network2Res(&ResList);
+	DynamicSaveThread = std::thread([this, pGroup = std::move(pGroup), iResID, ResName = std::move(ResName)]
+	{
+		fDynamicSaveSuccess = pGroup->Close()
+			&& DynamicSaveRes->SetByFile(DynamicSaveFilename.getData(), true, NRT_Dynamic, iResID, ResName.getData(), true)
+			&& DynamicSaveRes->GetStandalone(nullptr, 0, true, false, true);
+		fDynamicSaveDone = true;
+	});
 	return true;
 }
 
+void C4Network2::CheckDynamicSave()
+{
+	if (!isDynamicSavePending() || !fDynamicSaveDone) return;
+	DynamicSaveThread.join();
+	bool fSuccess = fDynamicSaveSuccess;
+	if (!fSuccess)
+		Log(LoadResStr("IDS_NET_SAVE_ERR_SAVEDYNFILE"));
+	// joining clients have to chase from the snapshot tick on, so the
+	// control for it must still be available
+	else if (Game.Control.ControlTick - iDynamicSaveTick >= C4ControlBacklog / 2)
+	{
+		LogSilentF("Network: Background save took too long (tick %d, now %d), saving again", iDynamicSaveTick, Game.Control.ControlTick);
+		DynamicSaveRes.Clear();
+		EraseItem(DynamicSaveFilename.getData());
+		DynamicSaveFilename.Clear();
+		// the next attempt is done synchronously
+		fDynamicSaveSync = fDynamicNeeded = true;
+		Game.Control.DoInput(CID_Synchronize, new C4ControlSynchronize(false, true), CDT_Sync);
+		return;
+	}
+	else
+	{
+		// the core is complete already, so the ressource only needs to be listed
+		ResList.Add(DynamicSaveRes);
+		SetDynamic(DynamicSaveRes, iDynamicSaveTick);
+	}
+	DynamicSaveRes.Clear();
+	if (!fSuccess)
+		EraseItem(DynamicSaveFilename.getData());
+	DynamicSaveFilename.Clear();
+	SendPendingJoinData(fSuccess);
+}
+
+void C4Network2::AbortDynamicSave()
+{
+	if (!isDynamicSavePending()) return;
+	// writing the file cannot be interrupted
+	DynamicSaveThread.join();
+	DynamicSaveRes.Clear();
+	EraseItem(DynamicSaveFilename.getData());
+	DynamicSaveFilename.Clear();
+}
+
 void C4Network2::RemoveDynamic()
 {
 	C4Network2Res::Ref pRes = ResList.getRefRes(ResDynamic.getID());
@@ -35,8 +35,10 @@
 #include "C4Toast.h"
 #endif
 
+#include <atomic>
 #include <cstdint>
 #include <optional>
+#include <thread>
 
 // lobby predef - no need to include lobby in header just for the class ptr
 namespace C4GameLobby { class MainDlg; class Countdown; }
@@ -178,6 +180,14 @@ protected:
 	int32_t iDynamicTick;
 	bool fDynamicNeeded;
 
+	// background dynamic save (thread writing the collected group, not joinable if none running)
+	std::thread DynamicSaveThread;
+	std::atomic<bool> fDynamicSaveDone, fDynamicSaveSuccess;
+	int32_t iDynamicSaveTick;
+	StdStrBuf DynamicSaveFilename;
+	C4Network2Res::Ref DynamicSaveRes; // not listed yet, the thread sets it up by the written file
+	bool fDynamicSaveSync; // background save was too slow: save synchronously next time
+
 	// game status flags
 	bool fStatusAck, fStatusReached;
 	bool fChasing;
@@ -379,6 +389,13 @@ protected:
 	// ressource list
 	bool CreateDynamic(bool fInit);
 	void RemoveDynamic();
+	bool AddDynamic(const char *szFilename, int32_t iTick);
+	void SetDynamic(C4Network2Res *pRes, int32_t iTick);
+	bool StartDynamicSave(const char *szFilename);
+	void CheckDynamicSave();
+	void AbortDynamicSave();
+	bool isDynamicSavePending() const { return DynamicSaveThread.joinable(); }
+	void SendPendingJoinData(bool fDynamicCreated);
 
 	// status changes
 	bool ChangeGameStatus(C4NetGameState enState, int32_t iTargetCtrlTick, int32_t iCtrlMode = -1);
@@ -33,6 +33,8 @@
 #endif
 #include <errno.h>
 
+#include <algorithm>
+
 // compile debug options
 // #define C4NET2RES_LOAD_ALL
 // #define C4NET2RES_DEBUG_LOG
@@ -157,48 +159,22 @@ bool C4Network2ResLoad::CheckTimeout()
 // *** C4Network2ResChunkData
 
 C4Network2ResChunkData::C4Network2ResChunkData()
-	: iChunkCnt(0), iPresentChunkCnt(0),
-	pChunkRanges(nullptr), iChunkRangeCnt(0) {}
-
-C4Network2ResChunkData::C4Network2ResChunkData(const C4Network2ResChunkData &Data2)
-	: C4PacketBase(Data2),
-	iChunkCnt(Data2.getChunkCnt()), iPresentChunkCnt(0),
-	pChunkRanges(nullptr), iChunkRangeCnt(0)
-{
-	// add ranges
-	Merge(Data2);
-}
-
-C4Network2ResChunkData::~C4Network2ResChunkData()
-{
-	Clear();
-}
-
-C4Network2ResChunkData &C4Network2ResChunkData::operator=(const C4Network2ResChunkData &Data2)
-{
-	// clear, merge
-	SetIncomplete(Data2.getChunkCnt());
-	Merge(Data2);
-	return *this;
-}
+	: iChunkCnt(0), iPresentChunkCnt(0) {}
 
 void C4Network2ResChunkData::SetIncomplete(int32_t inChunkCnt)
 {
 	Clear();
 	// just set total chunk count
 	iChunkCnt = inChunkCnt;
+	PresentChunks.resize(iChunkCnt, false);
 }
 
 void C4Network2ResChunkData::SetComplete(int32_t inChunkCnt)
 {
 	Clear();
-	// set total chunk count
+	// set total chunk count, all present
 	iPresentChunkCnt = iChunkCnt = inChunkCnt;
-	// create one range
-	ChunkRange *pRange = new ChunkRange;
-	pRange->Start = 0; pRange->Length = iChunkCnt;
-	pRange->Next = nullptr;
-	pChunkRanges = pRange;
+	PresentChunks.resize(iChunkCnt, true);
 }
 
 void C4Network2ResChunkData::AddChunk(int32_t iChunk)
@@ -209,113 +185,67 @@ void C4Network2ResChunkData::AddChunk(int32_t iChunk)
 void C4Network2ResChunkData::AddChunkRange(int32_t iStart, int32_t iLength)
 {
 	// security
-	if (iStart < 0 || iStart + iLength > iChunkCnt || iLength <= 0) return;
-	// find position
-	ChunkRange *pRange, *pPrev;
-	for (pRange = pChunkRanges, pPrev = nullptr; pRange; pPrev = pRange, pRange = pRange->Next)
-		if (pRange->Start >= iStart)
-			break;
-	// create new
-	ChunkRange *pNew = new ChunkRange;
-	pNew->Start = iStart; pNew->Length = iLength;
-	// add to list
-	pNew->Next = pRange;
-	(pPrev ? pPrev->Next : pChunkRanges) = pNew;
-	// counts
-	iPresentChunkCnt += iLength; iChunkRangeCnt++;
-	// check merges
-	if (pPrev && MergeRanges(pPrev))
-		while (MergeRanges(pPrev));
-	else
-		while (MergeRanges(pNew));
+	if (iStart < 0 || iLength <= 0 || iLength > iChunkCnt - iStart) return;
+	// set bits, count new ones
+	for (int32_t i = iStart; i < iStart + iLength; i++)
+		if (!PresentChunks[i])
+		{
+			PresentChunks[i] = true;
+			iPresentChunkCnt++;
+		}
 }
 
 void C4Network2ResChunkData::Merge(const C4Network2ResChunkData &Data2)
 {
 	// must have same basis chunk count
 	assert(iChunkCnt == Data2.getChunkCnt());
-	// add ranges
-	for (ChunkRange *pRange = Data2.pChunkRanges; pRange; pRange = pRange->Next)
-		AddChunkRange(pRange->Start, pRange->Length);
+	if (iChunkCnt != Data2.getChunkCnt()) return;
+	for (int32_t i = 0; i < iChunkCnt; i++)
+		if (Data2.PresentChunks[i] && !PresentChunks[i])
+		{
+			PresentChunks[i] = true;
+			iPresentChunkCnt++;
+		}
 }
 
 void C4Network2ResChunkData::Clear()
 {
-	iChunkCnt = iPresentChunkCnt = iChunkRangeCnt = 0;
-	// remove all ranges
-	while (pChunkRanges)
-	{
-		ChunkRange *pDelete = pChunkRanges;
-		pChunkRanges = pDelete->Next;
-		delete pDelete;
-	}
+	iChunkCnt = iPresentChunkCnt = 0;
+	PresentChunks.clear();
 }
 
-int32_t C4Network2ResChunkData::GetChunkToRetrieve(const C4Network2ResChunkData &Available, int32_t iLoadingCnt, int32_t *pLoading) const
-{
-	// (this version is highly calculation-intensitive, yet the most satisfactory
-	//  solution I could find)
-
-	// find everything that should not be retrieved
-	C4Network2ResChunkData ChData; Available.GetNegative(ChData);
-	ChData.Merge(*this);
-	for (int32_t i = 0; i < iLoadingCnt; i++)
-		ChData.AddChunk(pLoading[i]);
-	// nothing to retrieve?
-	if (ChData.isComplete()) return -1;
-	// invert to get everything that should be retrieved
-	C4Network2ResChunkData ChData2; ChData.GetNegative(ChData2);
-	// select chunk (random)
-	int32_t iRetrieveChunk = SafeRandom(ChData2.getPresentChunkCnt());
-	// return
-	return ChData2.getPresentChunk(iRetrieveChunk);
-}
-
-bool C4Network2ResChunkData::MergeRanges(ChunkRange *pRange)
-{
-	// no next entry?
-	if (!pRange || !pRange->Next) return false;
-	// do merge?
-	ChunkRange *pNext = pRange->Next;
-	if (pRange->Start + pRange->Length < pNext->Start) return false;
-	// get overlap
-	int32_t iOverlap = (std::min)((pRange->Start + pRange->Length) - pNext->Start, pNext->Length);
-	// set new chunk range
-	pRange->Length += pNext->Length - iOverlap;
-	// remove range
-	pRange->Next = pNext->Next;
-	delete pNext;
-	// counts
-	iChunkRangeCnt--; iPresentChunkCnt -= iOverlap;
-	// ok
-	return true;
-}
-
-void C4Network2ResChunkData::GetNegative(C4Network2ResChunkData &Target) const
+int32_t C4Network2ResChunkData::GetChunkToRetrieve(const C4Network2ResChunkData &Available, int32_t iLoadingCnt, int32_t *pLoading, const std::vector<int32_t> *pSourceCnts) const
 {
-	// clear target
-	Target.SetIncomplete(iChunkCnt);
-	// add all ranges that are missing
-	int32_t iFreeStart = 0;
-	for (ChunkRange *pRange = pChunkRanges; pRange; pRange = pRange->Next)
+	if (Available.getChunkCnt() != iChunkCnt) return -1;
+	const bool fRarest = pSourceCnts && pSourceCnts->size() == static_cast<size_t>(iChunkCnt);
+	// of all chunks that are there but not here and not being loaded, take the rarest
+	// (random among equally rare ones, so parallel loads spread over the file)
+	int32_t iRetrieveChunk = -1, iMinSources = 0, iCandidateCnt = 0;
+	for (int32_t i = 0; i < iChunkCnt; i++)
 	{
-		// add range
-		Target.AddChunkRange(iFreeStart, pRange->Start - iFreeStart);
-		// safe new start
-		iFreeStart = pRange->Start + pRange->Length;
+		if (PresentChunks[i] || !Available.PresentChunks[i]) continue;
+		if (std::find(pLoading, pLoading + iLoadingCnt, i) != pLoading + iLoadingCnt) continue;
+		const int32_t iSources = fRarest ? (*pSourceCnts)[i] : 0;
+		if (!iCandidateCnt || iSources < iMinSources)
+		{
+			iMinSources = iSources;
+			iCandidateCnt = 0;
+		}
+		else if (iSources > iMinSources)
+			continue;
+		if (!SafeRandom(++iCandidateCnt))
+			iRetrieveChunk = i;
 	}
-	// add last range
-	Target.AddChunkRange(iFreeStart, iChunkCnt - iFreeStart);
+	return iRetrieveChunk;
 }
 
-int32_t C4Network2ResChunkData::getPresentChunk(int32_t iNr) const
+int32_t C4Network2ResChunkData::getChunkRangeCnt() const
 {
-	for (ChunkRange *pRange = pChunkRanges; pRange; pRange = pRange->Next)
-		if (iNr < pRange->Length)
-			return iNr + pRange->Start;
-		else
-			iNr -= pRange->Length;
-	return -1;
+	int32_t iRangeCnt = 0;
+	for (int32_t i = 0; i < iChunkCnt; i++)
+		if (PresentChunks[i] && (!i || !PresentChunks[i - 1]))
+			iRangeCnt++;
+	return iRangeCnt;
 }
 
 void C4Network2ResChunkData::CompileFunc(StdCompiler *pComp)
@@ -323,29 +253,38 @@ void C4Network2ResChunkData::CompileFunc(StdCompiler *pComp)
 	bool fCompiler = pComp->isCompiler();
 	if (fCompiler) Clear();
 	// Data
+	int32_t iChunkRangeCnt = fCompiler ? 0 : getChunkRangeCnt();
 	pComp->Value(mkNamingAdapt(mkIntPackAdapt(iChunkCnt),      "ChunkCnt",      0));
 	pComp->Value(mkNamingAdapt(mkIntPackAdapt(iChunkRangeCnt), "ChunkRangeCnt", 0));
+	if (fCompiler)
+	{
+		if (iChunkCnt < 0 || iChunkCnt > C4NetResMaxChunkCnt)
+			pComp->excCorrupt("ResChunk count out of range!");
+		PresentChunks.resize(iChunkCnt, false);
+	}
 	// Ranges
 	if (!pComp->Name("Ranges"))
 		pComp->excCorrupt("ResChunk ranges expected!");
-	ChunkRange *pRange = nullptr;
-	for (int32_t i = 0; i < iChunkRangeCnt; i++)
+	for (int32_t i = 0, iPos = 0; i < iChunkRangeCnt; i++)
 	{
-		// Create new range / go to next range
-		if (fCompiler)
-			pRange = (pRange ? pRange->Next : pChunkRanges) = new ChunkRange;
-		else
-			pRange = pRange ? pRange->Next : pChunkRanges;
+		int32_t iStart = 0, iLength = 0;
+		if (!fCompiler)
+		{
+			// find next range
+			while (!PresentChunks[iPos]) iPos++;
+			iStart = iPos;
+			while (iPos < iChunkCnt && PresentChunks[iPos]) iPos++;
+			iLength = iPos - iStart;
+		}
 		// Separate
 		if (i) pComp->Separator();
 		// Compile range
-		pComp->Value(mkIntPackAdapt(pRange->Start));
+		pComp->Value(mkIntPackAdapt(iStart));
 		pComp->Separator(StdCompiler::SEP_PART2);
-		pComp->Value(mkIntPackAdapt(pRange->Length));
+		pComp->Value(mkIntPackAdapt(iLength));
+		if (fCompiler)
+			AddChunkRange(iStart, iLength);
 	}
-	// Terminate list
-	if (fCompiler)
-		(pRange ? pRange->Next : pChunkRanges) = nullptr;
 	pComp->NameEnd();
 }
 
@@ -357,9 +296,10 @@ C4Network2Res::C4Network2Res(C4Network2ResList *pnParent)
 	iRefCnt(0), fRemoved(false),
 	iLastReqTime(0),
 	fLoading(false),
-	pCChunks(nullptr), iDiscoverStartTime(0), pLoads(nullptr), iLoadCnt(0),
+	pCChunks(nullptr), iDiscoverStartTime(0), iLoadStartTime(0), pLoads(nullptr), iLoadCnt(0),
 	pNext(nullptr),
-	pParent(pnParent)
+	pParent(pnParent),
+	iListSeq(0), iIndexedID(0)
 {
 	szFile[0] = szStandalone[0] = '\0';
 }
@@ -518,6 +458,7 @@ bool C4Network2Res::SetLoad(const C4Network2ResCore &nCore) // by main thread
 	fRemoved = false;
 	iLastReqTime = time(nullptr);
 	fLoading = true;
+	iLoadStartTime = timeGetTime();
 	// No discovery yet
 	iDiscoverStartTime = 0;
 	return true;
@@ -548,6 +489,7 @@ bool C4Network2Res::SetDerived(const char *strName, const char *strFilePath, boo
 void C4Network2Res::ChangeID(int32_t inID)
 {
 	Core.SetID(inID);
+	pParent->IndexRes(this);
 }
 
 bool C4Network2Res::IsBinaryCompatible()
@@ -756,6 +698,8 @@ C4Network2Res::Ref C4Network2Res::Derive()
 		fTempFile = true;
 	}
 
+	pParent->IndexRes(this);
+
 	Application.InteractiveThread.ThreadLogSF("Network: Ressource: deriving from %d:%s, original at %s", getResID(), Core.getFileName(), szFile);
 
 	// (note: should remove temp file if something fails after this point)
@@ -788,7 +732,9 @@ bool C4Network2Res::FinishDerive() // by main thread
 	char szName[_MAX_PATH + 1]; SCopy(Core.getFileName(), szName, _MAX_PATH);
 	char szFileC[_MAX_PATH + 1]; SCopy(szFile, szFileC, _MAX_PATH);
 	// Set by file
-	if (!SetByFile(szFileC, fTempFile, getType(), pParent->nextResID(), szName))
+	const bool fSet = SetByFile(szFileC, fTempFile, getType(), pParent->nextResID(), szName);
+	pParent->IndexRes(this);
+	if (!fSet)
 		return false;
 	// create standalone
 	if (!GetStandalone(nullptr, 0, true))
@@ -809,6 +755,7 @@ bool C4Network2Res::FinishDerive(const C4Network2ResCore &nCore)
 	if (!isAnonymous()) return false;
 	// Set core
 	Core = nCore;
+	pParent->IndexRes(this);
 	// Set chunks (assume the ressource is complete)
 	Chunks.SetComplete(Core.getChunkCnt());
 
@@ -902,8 +849,11 @@ void C4Network2Res::OnStatus(const C4Network2ResChunkData &rChunkData, C4Network
 		pChunks->Next = pCChunks;
 		pCChunks = pChunks;
 	}
+	else
+		CountSources(pChunks->Chunks, -1);
 	pChunks->ClientID = pBy->getClientID();
 	pChunks->Chunks = rChunkData;
+	CountSources(pChunks->Chunks, +1);
 	// load?
 	if (fLoading) StartLoad(pChunks->ClientID, pChunks->Chunks);
 }
@@ -1039,24 +989,20 @@ void C4Network2Res::StartNewLoads()
 				break;
 			}
 	}
-	// start new load until maximum count reached
+	// start new loads until maximum count reached, one per client and round
+	// so the loads are spread over all clients that have something to offer
 	while (iLoadCnt + 1 <= C4NetResMaxLoad)
 	{
 		int32_t ioLoadCnt = iLoadCnt;
-		// search someone
-		for (i = 0; i < iCChunkCnt; i++)
+		for (i = 0; i < iCChunkCnt && iLoadCnt + 1 <= C4NetResMaxLoad; i++)
 			if (pC[i])
 			{
 				// try to start load
 				if (!StartLoad(pC[i]->ClientID, pC[i]->Chunks))
-				{
-					pC[i] = nullptr; continue;
-				}
-				// success?
-				if (iLoadCnt > ioLoadCnt) break;
+					pC[i] = nullptr;
 			}
-		// not found?
-		if (i >= iCChunkCnt)
+		// nothing started this round?
+		if (iLoadCnt <= ioLoadCnt)
 			break;
 	}
 	// clear up
@@ -1082,7 +1028,7 @@ bool C4Network2Res::StartLoad(int32_t iFromClient, const C4Network2ResChunkData
 	int32_t iLoads[C4NetResMaxLoad]; int32_t i = 0;
 	for (C4Network2ResLoad *pLoad = pLoads; pLoad; pLoad = pLoad->Next())
 		iLoads[i++] = pLoad->getChunk();
-	int32_t iRetrieveChunk = Chunks.GetChunkToRetrieve(Available, i, iLoads);
+	int32_t iRetrieveChunk = Chunks.GetChunkToRetrieve(Available, i, iLoads, &ChunkSourceCnts);
 	// nothing? ignore
 	if (iRetrieveChunk < 0 || static_cast<uint32_t>(iRetrieveChunk) >= Core.getChunkCnt())
 		return true;
@@ -1127,6 +1073,7 @@ void C4Network2Res::ClearLoad()
 	fLoading = false;
 	while (pCChunks) RemoveCChunks(pCChunks);
 	while (pLoads) RemoveLoad(pLoads);
+	ChunkSourceCnts.clear();
 	iDiscoverStartTime = iLoadCnt = 0;
 }
 
@@ -1161,10 +1108,20 @@ void C4Network2Res::RemoveCChunks(ClientChunks *pChunks)
 		if (pPrev)
 			pPrev->Next = pChunks->Next;
 	}
+	CountSources(pChunks->Chunks, -1);
 	// delete
 	delete pChunks;
 }
 
+void C4Network2Res::CountSources(const C4Network2ResChunkData &Available, int32_t iChange)
+{
+	if (Available.getChunkCnt() != Chunks.getChunkCnt()) return;
+	ChunkSourceCnts.resize(Chunks.getChunkCnt(), 0);
+	for (int32_t i = 0; i < Available.getChunkCnt(); i++)
+		if (Available.isPresent(i))
+			ChunkSourceCnts[i] += iChange;
+}
+
 bool C4Network2Res::OptimizeStandalone(bool fSilent)
 {
 	CStdLock FileLock(&FileCSec);
@@ -1330,6 +1287,7 @@ C4Network2ResList::C4Network2ResList()
 	iNextResID((-1) << 16),
 	pFirst(nullptr),
 	ResListCSec(this),
+	iListSeq(0),
 	iLastDiscover(0), iLastStatus(0),
 	pIO(nullptr) {}
 
@@ -1383,20 +1341,21 @@ int32_t C4Network2ResList::nextResID() // by main thread
 C4Network2Res *C4Network2ResList::getRes(int32_t iResID)
 {
 	CStdShareLock ResListLock(&ResListCSec);
-	for (C4Network2Res *pCur = pFirst; pCur; pCur = pCur->pNext)
-		if (pCur->getResID() == iResID)
-			return pCur;
-	return nullptr;
+	CStdLock ResIndexLock(&ResIndexCSec);
+	const auto it = ResByID.find(iResID);
+	return it != ResByID.end() ? it->second.front() : nullptr;
 }
 
 C4Network2Res *C4Network2ResList::getRes(const char *szFile, bool fLocalOnly)
 {
 	CStdShareLock ResListLock(&ResListCSec);
-	for (C4Network2Res *pCur = pFirst; pCur; pCur = pCur->pNext)
+	CStdLock ResIndexLock(&ResIndexCSec);
+	const auto it = ResByFile.find(szFile);
+	if (it == ResByFile.end()) return nullptr;
+	for (C4Network2Res *pCur : it->second)
 		if (!pCur->isAnonymous())
-			if (SEqual(pCur->getFile(), szFile))
-				if (!fLocalOnly || pCur->getResClient() == iClientID)
-					return pCur;
+			if (!fLocalOnly || pCur->getResClient() == iClientID)
+				return pCur;
 	return nullptr;
 }
 
@@ -1433,6 +1392,43 @@ void C4Network2ResList::Add(C4Network2Res *pRes)
 	// add
 	pRes->pNext = pFirst;
 	pFirst = pRes;
+	// index
+	{
+		CStdLock ResIndexLock(&ResIndexCSec);
+		pRes->iListSeq = ++iListSeq;
+	}
+	IndexRes(pRes);
+}
+
+void C4Network2ResList::IndexRes(C4Network2Res *pRes)
+{
+	CStdLock ResIndexLock(&ResIndexCSec);
+	// not listed?
+	if (!pRes->iListSeq) return;
+	UnindexRes(pRes);
+	// insert by list position: newest first, as the list would be searched
+	const auto insert = [pRes](std::vector<C4Network2Res *> &bucket)
+	{
+		bucket.insert(std::find_if(bucket.begin(), bucket.end(), [pRes](C4Network2Res *pCur) { return pCur->iListSeq < pRes->iListSeq; }), pRes);
+	};
+	pRes->iIndexedID = pRes->getResID();
+	pRes->IndexedFile = pRes->getFile();
+	insert(ResByID[pRes->iIndexedID]);
+	insert(ResByFile[pRes->IndexedFile]);
+}
+
+void C4Network2ResList::UnindexRes(C4Network2Res *pRes)
+{
+	CStdLock ResIndexLock(&ResIndexCSec);
+	const auto remove = [pRes](auto &map, const auto &key)
+	{
+		const auto it = map.find(key);
+		if (it == map.end()) return;
+		std::erase(it->second, pRes);
+		if (it->second.empty()) map.erase(it);
+	};
+	remove(ResByID, pRes->iIndexedID);
+	remove(ResByFile, pRes->IndexedFile);
 }
 
 C4Network2Res::Ref C4Network2ResList::AddByFile(const char *strFilePath, bool fTemp, C4Network2ResType eType, int32_t iResID, const char *szResName, bool fAllowUnloadable)
@@ -1654,6 +1650,8 @@ void C4Network2ResList::OnShareFree(CStdCSecEx *pCSec)
 			{
 				// unlink
 				(pPrev ? pPrev->pNext : pFirst) = pNext;
+				UnindexRes(pRes);
+				pRes->iListSeq = 0;
 				// remove
 				pRes->pNext = nullptr;
 				pRes->DelRef();
@@ -1691,7 +1689,7 @@ bool C4Network2ResList::SendDiscover(C4Network2IOConnection *pTo) // by both
 void C4Network2ResList::OnResComplete(C4Network2Res *pRes)
 {
 	// log (network thread -> ThreadLog)
-	Application.InteractiveThread.ThreadLogSF("Network: %s received.", pRes->getCore().getFileName());
+	Application.InteractiveThread.ThreadLogSF("Network: %s received (%u KB in %u ms).", pRes->getCore().getFileName(), pRes->getCore().getFileSize() / 1024, timeGetTime() - pRes->iLoadStartTime);
 	// call handler (ctrl might wait for this ressource)
 	Game.Control.Network.OnResComplete(pRes);
 }
@@ -23,8 +23,12 @@
 #include <StdSync.h>
 
 #include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 const uint32_t C4NetResChunkSize = 100U * 1024U;
+const int32_t C4NetResMaxChunkCnt = static_cast<int32_t>(UINT32_MAX / C4NetResChunkSize + 1); // chunks of the largest possible file
 
 const int32_t C4NetResDiscoverTimeout = 10, // (s)
               C4NetResDiscoverInterval = 1, // (s)
@@ -124,24 +128,19 @@ class C4Network2ResChunkData : public C4PacketBase
 {
 public:
 	C4Network2ResChunkData();
-	C4Network2ResChunkData(const C4Network2ResChunkData &Data2);
-	~C4Network2ResChunkData();
-
-	C4Network2ResChunkData &operator=(const C4Network2ResChunkData &Data2);
 
 protected:
 	int32_t iChunkCnt, iPresentChunkCnt;
 
-	// present chunk ranges
-	struct ChunkRange { int32_t Start, Length; ChunkRange *Next; };
-	ChunkRange *pChunkRanges;
-	int32_t iChunkRangeCnt;
+	// present chunks (sent as ranges)
+	std::vector<bool> PresentChunks;
 
 public:
 	int32_t getChunkCnt()        const { return iChunkCnt; }
 	int32_t getPresentChunkCnt() const { return iPresentChunkCnt; }
 	int32_t getPresentPercent()  const { return iPresentChunkCnt * 100 / iChunkCnt; }
 	bool    isComplete()         const { return iPresentChunkCnt == iChunkCnt; }
+	bool    isPresent(int32_t iChunk) const { return iChunk >= 0 && iChunk < iChunkCnt && PresentChunks[iChunk]; }
 
 	void SetIncomplete(int32_t iChunkCnt);
 	void SetComplete(int32_t iChunkCnt);
@@ -152,13 +151,12 @@ public:
 
 	void Clear();
 
-	int32_t GetChunkToRetrieve(const C4Network2ResChunkData &Available, int32_t iLoadingCnt, int32_t *pLoading) const;
+	// picks a chunk that is available, but neither present nor being loaded - the one with the fewest sources, if counts are given
+	int32_t GetChunkToRetrieve(const C4Network2ResChunkData &Available, int32_t iLoadingCnt, int32_t *pLoading, const std::vector<int32_t> *pSourceCnts = nullptr) const;
 
 protected:
 	// helpers
-	bool MergeRanges(ChunkRange *pRange);
-	void GetNegative(C4Network2ResChunkData &Target) const;
-	int32_t getPresentChunk(int32_t iNr) const;
+	int32_t getChunkRangeCnt() const;
 
 public:
 	virtual void CompileFunc(StdCompiler *pComp) override;
@@ -220,13 +218,17 @@ protected:
 	bool local{false};
 	struct ClientChunks { C4Network2ResChunkData Chunks; int32_t ClientID; ClientChunks *Next; }
 	*pCChunks;
+	std::vector<int32_t> ChunkSourceCnts; // number of clients having each chunk, for rarest-first loading
 	time_t iDiscoverStartTime;
+	uint32_t iLoadStartTime;
 	C4Network2ResLoad *pLoads;
 	int32_t iLoadCnt;
 
 	// list (C4Network2ResList)
 	C4Network2Res *pNext;
 	C4Network2ResList *pParent;
+	uint32_t iListSeq; // position in list, newest first; 0 if not listed
+	int32_t iIndexedID; std::string IndexedFile; // keys the list index holds this ressource under
 
 public:
 	C4Network2ResType getType()                  const { return Core.getType(); }
@@ -289,6 +291,7 @@ protected:
 
 	void RemoveLoad(C4Network2ResLoad *pLoad);
 	void RemoveCChunks(ClientChunks *pChunks);
+	void CountSources(const C4Network2ResChunkData &Available, int32_t iChange);
 
 	bool OptimizeStandalone(bool fSilent);
 };
@@ -328,6 +331,12 @@ protected:
 	CStdCSecEx ResListCSec;
 	CStdCSec ResListAddCSec;
 
+	// lookup index over the list: ressources by ID and by file, newest first in each bucket
+	std::unordered_map<int32_t, std::vector<C4Network2Res *>> ResByID;
+	std::unordered_map<std::string, std::vector<C4Network2Res *>> ResByFile;
+	uint32_t iListSeq;
+	CStdCSec ResIndexCSec;
+
 	int32_t iClientID, iNextResID;
 	CStdCSec ResIDCSec;
 
@@ -380,6 +389,10 @@ public:
 protected:
 	void OnResComplete(C4Network2Res *pRes);
 
+	// index
+	void IndexRes(C4Network2Res *pRes); // (re)index under current ID and file
+	void UnindexRes(C4Network2Res *pRes);
+
 	// misc
 	bool CreateNetworkFolder();
 	bool FindTempResFileName(const char *szFilename, char *pTarget);
@@ -71,6 +71,8 @@ void C4Action::GetBridgeData(int32_t &riBridgeTime, bool &rfMoveClonk, bool &rfW
 
 C4Object::C4Object()
 {
+	Action.Target.SetHolder(this);
+	Action.Target2.SetHolder(this);
 	Default();
 }
 
@@ -107,6 +109,7 @@ void C4Object::Default()
 	Mobile = 0;
 	Select = 0;
 	Unsorted = false;
+	ListOrder = 0;
 	Initializing = false;
 	OnFire = 0;
 	InLiquid = 0;
@@ -135,6 +138,7 @@ void C4Object::Default()
 	Visibility = VIS_All;
 	LocalNamed.Reset();
 	Marker = 0;
+	SectorOCF = 0;
 	ColorMod = BlitMode = 0;
 	CrewDisabled = false;
 	pLayer = nullptr;
@@ -657,6 +661,8 @@ void C4Object::SetOCF()
 	// OCF_Container
 	if ((Def->GrabPutGet & C4D_Grab_Put) || (Def->GrabPutGet & C4D_Grab_Get) || (OCF & OCF_Entrance))
 		OCF |= OCF_Container;
+	// keep sector OCF counts in sync
+	Game.Objects.Sectors.UpdateOCF(this);
 #ifdef DEBUGREC_OCF
 	assert(!dwOCFOld || ((dwOCFOld & OCF_Carryable) == (OCF & OCF_Carryable)));
 	C4RCOCF rc = { dwOCFOld, OCF, false };
@@ -749,6 +755,8 @@ void C4Object::UpdateOCF()
 	// OCF_Container
 	if ((Def->GrabPutGet & C4D_Grab_Put) || (Def->GrabPutGet & C4D_Grab_Get) || (OCF & OCF_Entrance))
 		OCF |= OCF_Container;
+	// keep sector OCF counts in sync
+	Game.Objects.Sectors.UpdateOCF(this);
 #ifdef DEBUGREC_OCF
 	C4RCOCF rc = { dwOCFOld, OCF, true };
 	AddDbgRec(RCT_OCF, &rc, sizeof(rc));
@@ -2719,13 +2727,12 @@ void C4Object::CompileFunc(StdCompiler *pComp)
 
 	// Write the name only if the object has an individual name, use def name as default for reading.
 	// (Info may overwrite later, see C4Player::MakeCrewMember)
-	if (pComp->isCompiler())
+	if (pComp->isCompiler() || !pComp->hasNaming())
 	{
 		pComp->Value(mkNamingAdapt(CustomName, "Name", std::string{}));
 	}
 	else if (!CustomName.empty())
 		// Write the name only if the object has an individual name
-		// 2do: And what about binary compilers?
 		pComp->Value(mkNamingAdapt(CustomName, "Name"));
 
 	pComp->Value(mkNamingAdapt(Number,                                  "Number",             -1));
@@ -2813,6 +2820,18 @@ void C4Object::CompileFunc(StdCompiler *pComp)
 				if (!pCmd)
 					break;
 				pCmd->cObj = this;
+				pCmd->Target.SetHolder(this);
+				pCmd->Target2.SetHolder(this);
+			}
+		}
+		else if (!pComp->hasNaming())
+		{
+			// No sections to run out of: Write the null flags the loop above reads, ending with a null command
+			for (C4Command *pCmd = Command; ; pCmd = pCmd->Next)
+			{
+				C4Command *pPos = pCmd;
+				pComp->Value(mkPtrAdapt(pPos));
+				if (!pCmd) break;
 			}
 		}
 		else
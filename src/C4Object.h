@@ -99,7 +99,7 @@ public:
 	int32_t Data;
 	int32_t Phase, PhaseDelay;
 	int32_t t_attach; // SyncClearance-NoSave //
-	C4EnumeratedObjectPtr Target, Target2;
+	C4TargetObjectPtr Target, Target2;
 	C4Facet Facet; // NoSave //
 	int32_t FacetX, FacetY; // NoSave //
 
@@ -158,6 +158,8 @@ public:
 	uint32_t OCF;
 	int32_t Visibility;
 	uint32_t Marker; // state var used by Objects::CrossCheck and C4FindObject - NoSave
+	uint64_t ListOrder; // position key in the main object list, ascending in list order; 0 if not in it - NoSave
+	uint32_t SectorOCF; // OCF as counted in Game.Objects.Sectors; zero if not counted - NoSave
 	C4EnumeratedObjectPtr pLayer; // layer-object containing this object
 	C4DrawTransform *pDrawTransform; // assigned drawing transformation
 
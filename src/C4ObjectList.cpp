@@ -526,6 +526,8 @@ void C4ObjectList::CompileFunc(StdCompiler *pComp, bool fSaveRefs, bool fSkipPla
 				}
 				catch (const StdCompiler::Exception &e)
 				{
+					// Binary data can't be resynchronized after a broken object
+					if (!pComp->hasNaming()) throw;
 					// Failsafe object loading: If an error occurs during object loading, just skip that object and load the next one
 					if (!e.Pos.getLength())
 						LogF("ERROR: Object loading: %s", e.what());
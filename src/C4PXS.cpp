@@ -239,6 +239,9 @@ void C4PXSSystem::Draw(C4FacetEx &cgo)
 	C4Rect VisibleRect(cgo.TargetX, cgo.TargetY, cgo.Wdt, cgo.Hgt);
 	VisibleRect.Enlarge(20);
 
+	// collect everything and draw it in as few calls as possible
+	Application.DDraw->BeginBatch(cgo.Surface);
+
 	// First pass: draw old-style PXS (lines/pixels)
 	int32_t cgox = cgo.X - cgo.TargetX, cgoy = cgo.Y - cgo.TargetY;
 	unsigned int cnt;
@@ -259,20 +262,23 @@ void C4PXSSystem::Draw(C4FacetEx &cgo)
 						// lines for stuff that goes whooosh!
 						int len = fixtoi(Abs(pxp->xdir) + Abs(pxp->ydir));
 						dwMatClr = uint32_t(std::max<int>(dwMatClr >> 24, 195 - (195 - (dwMatClr >> 24)) / len)) << 24 | (dwMatClr & 0xffffff);
-						Application.DDraw->DrawLineDw(cgo.Surface,
+						Application.DDraw->BatchLineDw(
 							fixtof(pxp->x - pxp->xdir) + cgox, fixtof(pxp->y - pxp->ydir) + cgoy,
 							fixtof(pxp->x) + cgox, fixtof(pxp->y) + cgoy,
 							dwMatClr);
 					}
 					else
 						// single pixels for slow stuff
-						Application.DDraw->DrawPix(cgo.Surface, fixtof(pxp->x) + cgox, fixtof(pxp->y) + cgoy, dwMatClr);
+						Application.DDraw->BatchPix(fixtof(pxp->x) + cgox, fixtof(pxp->y) + cgoy, dwMatClr);
 				}
 		}
 
 	// PXS graphics disabled?
 	if (!Config.Graphics.PXSGfx)
+	{
+		Application.DDraw->FlushBatch();
 		return;
+	}
 
 	// Second pass: draw new-style PXS (graphics)
 	for (cnt = 0; cnt < PXSMaxChunk; cnt++)
@@ -294,10 +300,12 @@ void C4PXSSystem::Draw(C4FacetEx &cgo)
 					pny = (cnt2 / pnx) % pny; pnx = cnt2 % pnx;
 					// draw
 					Application.DDraw->ActivateBlitModulation((std::min)((fcWdtH - z) * 16, 255) << 24 | 0xffffff);
-					pMat->PXSFace.DrawX(cgo.Surface, fixtoi(pxp->x) + cgox + z * pMat->PXSGfxRt.tx / fcWdt, fixtoi(pxp->y) + cgoy + z * pMat->PXSGfxRt.ty / fcWdt, z, z * pMat->PXSFace.Hgt / fcWdt, pnx, pny);
+					pMat->PXSFace.BatchX(fixtoi(pxp->x) + cgox + z * pMat->PXSGfxRt.tx / fcWdt, fixtoi(pxp->y) + cgoy + z * pMat->PXSGfxRt.ty / fcWdt, z, z * pMat->PXSFace.Hgt / fcWdt, pnx, pny);
 					Application.DDraw->DeactivateBlitModulation();
 				}
 		}
+
+	Application.DDraw->FlushBatch();
 }
 
 void C4PXSSystem::Cast(int32_t mat, int32_t num, int32_t tx, int32_t ty, int32_t level)
@@ -392,6 +400,29 @@ bool C4PXSSystem::Load(C4Group &hGroup)
 	return true;
 }
 
+uint32_t C4PXSSystem::GetSyncHash() const
+{
+	// sum up, so the order of PXS within the chunks does not matter
+	uint32_t dwHash = 0;
+	for (size_t cnt = 0; cnt < PXSMaxChunk; cnt++)
+		if (Chunk[cnt] && iChunkPXS[cnt])
+		{
+			const C4PXS *pxp = Chunk[cnt];
+			for (size_t cnt2 = 0; cnt2 < PXSChunkSize; cnt2++, pxp++)
+				if (pxp->Mat != MNone)
+				{
+					uint32_t dwPXSHash = 0;
+					SyncHashAdd(dwPXSHash, pxp->Mat);
+					SyncHashAdd(dwPXSHash, fixtoi(pxp->x, FIXED_FPF));
+					SyncHashAdd(dwPXSHash, fixtoi(pxp->y, FIXED_FPF));
+					SyncHashAdd(dwPXSHash, fixtoi(pxp->xdir, FIXED_FPF));
+					SyncHashAdd(dwPXSHash, fixtoi(pxp->ydir, FIXED_FPF));
+					dwHash += dwPXSHash;
+				}
+		}
+	return dwHash;
+}
+
 void C4PXSSystem::Synchronize()
 {
 	Count = 0;
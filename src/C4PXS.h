@@ -64,6 +64,7 @@ public:
 	bool Create(int32_t mat, C4Fixed ix, C4Fixed iy, C4Fixed ixdir = Fix0, C4Fixed iydir = Fix0);
 	bool Load(C4Group &hGroup);
 	bool Save(C4Group &hGroup);
+	uint32_t GetSyncHash() const; // independent of chunk layout
 
 protected:
 	C4PXS *New();
@@ -83,6 +83,7 @@ C4ParticleDef::C4ParticleDef() :
 	C4ParticleDefCore(),
 	InitProc(&fxStdInit),
 	ExecProc(&fxStdExec),
+	ExecParticleProc(nullptr),
 	DrawProc(&fxStdDraw),
 	CollisionProc(nullptr),
 	Count(0)
@@ -160,10 +161,16 @@ bool C4ParticleDef::Load(C4Group &rGrp)
 			DebugLogF("init proc for particle '%s' not found: '%s'", Name.getData(), InitFn.getData());
 			return false;
 		}
-		if (!(ExecProc = ParticleSystem.GetProc(ExecFn.getData())))
+		// exec procs work on whole batches; single particle procs are wrapped
+		ExecParticleProc = nullptr;
+		if (!(ExecProc = ParticleSystem.GetExecProc(ExecFn.getData())))
 		{
-			DebugLogF("exec proc for particle '%s' not found: '%s'", Name.getData(), ExecFn.getData());
-			return false;
+			if (!(ExecParticleProc = ParticleSystem.GetProc(ExecFn.getData())))
+			{
+				DebugLogF("exec proc for particle '%s' not found: '%s'", Name.getData(), ExecFn.getData());
+				return false;
+			}
+			ExecProc = &fxProcExec;
 		}
 		if (CollisionFn && CollisionFn[0]) if (!(CollisionProc = ParticleSystem.GetProc(CollisionFn.getData())))
 		{
@@ -204,111 +211,200 @@ bool C4ParticleDef::Reload()
 	return Load(hGroup);
 }
 
-void C4Particle::MoveList(C4ParticleList &rFrom, C4ParticleList &rTo)
+C4ParticleBatch::C4ParticleBatch(C4ParticleDef *pDef)
+	: pDef(pDef), pNext(nullptr), Count(0),
+	X(nullptr), Y(nullptr), XDir(nullptr), YDir(nullptr), A(nullptr),
+	Life(nullptr), B(nullptr), Keep(nullptr),
+	Capacity(0) {}
+
+void C4ParticleBatch::Grow()
+{
+	// all arrays share one buffer; the bool array goes last so all others stay aligned
+	const int32_t iNewCapacity = Capacity ? Capacity * 2 : C4Px_BufSize;
+	std::unique_ptr<uint8_t[]> NewBuffer(new uint8_t[iNewCapacity * (5 * sizeof(float) + 2 * sizeof(int32_t) + sizeof(bool))]);
+	float *pFloats = reinterpret_cast<float *>(NewBuffer.get());
+	float *pNewX = pFloats, *pNewY = pFloats + iNewCapacity, *pNewXDir = pFloats + 2 * iNewCapacity,
+		*pNewYDir = pFloats + 3 * iNewCapacity, *pNewA = pFloats + 4 * iNewCapacity;
+	int32_t *pNewLife = reinterpret_cast<int32_t *>(pFloats + 5 * iNewCapacity), *pNewB = pNewLife + iNewCapacity;
+	bool *pNewKeep = reinterpret_cast<bool *>(pNewB + iNewCapacity);
+	// copy existing particles
+	if (Count)
+	{
+		std::copy_n(X, Count, pNewX); std::copy_n(Y, Count, pNewY);
+		std::copy_n(XDir, Count, pNewXDir); std::copy_n(YDir, Count, pNewYDir);
+		std::copy_n(A, Count, pNewA); std::copy_n(Life, Count, pNewLife);
+		std::copy_n(B, Count, pNewB);
+	}
+	X = pNewX; Y = pNewY; XDir = pNewXDir; YDir = pNewYDir; A = pNewA;
+	Life = pNewLife; B = pNewB; Keep = pNewKeep;
+	Buffer = std::move(NewBuffer);
+	Capacity = iNewCapacity;
+}
+
+void C4ParticleBatch::Get(int32_t i, C4Particle &rPrt) const
 {
-	// remove from current list
-	if (pPrev)
-		pPrev->pNext = pNext;
-	else
-		// is it the first item in the list? then set this to the next one
-		if (rFrom.pFirst == this) rFrom.pFirst = pNext;
-	if (pNext) pNext->pPrev = pPrev;
-	// add to the other list - insert before first
-	if (pNext = rTo.pFirst) pNext->pPrev = this;
-	rTo.pFirst = this; pPrev = nullptr;
+	rPrt.pDef = pDef;
+	rPrt.x = X[i]; rPrt.y = Y[i];
+	rPrt.xdir = XDir[i]; rPrt.ydir = YDir[i];
+	rPrt.life = Life[i];
+	rPrt.a = A[i]; rPrt.b = B[i];
 }
 
-C4ParticleChunk::C4ParticleChunk()
+void C4ParticleBatch::Set(int32_t i, const C4Particle &rPrt)
 {
-	// zero linked list
-	pNext = nullptr;
-	// zero buffer
-	Clear();
+	X[i] = rPrt.x; Y[i] = rPrt.y;
+	XDir[i] = rPrt.xdir; YDir[i] = rPrt.ydir;
+	Life[i] = rPrt.life;
+	A[i] = rPrt.a; B[i] = rPrt.b;
 }
 
-C4ParticleChunk::~C4ParticleChunk()
+void C4ParticleBatch::Add(const C4Particle &rPrt)
 {
-	// list stuff done by C4ParticleSystem
+	if (Count >= Capacity) Grow();
+	Set(Count++, rPrt);
 }
 
-void C4ParticleChunk::Clear()
+int32_t C4ParticleBatch::Compact()
 {
-	// note that this method is called in ctor with uninitialized data!
-	// simply clear mem - this won't adjust any counts!
-	std::memset(Data, 0, sizeof(Data));
-	// init list
-	C4Particle *pPrt = Data;
-	for (int32_t i = 0; i < C4Px_BufSize; ++i)
-	{
-		pPrt->pPrev = pPrt - 1;
-		pPrt->pNext = pPrt + 1;
-		++pPrt;
-	}
-	Data[0].pPrev = Data[C4Px_BufSize - 1].pNext = nullptr;
+	// move all surviving particles to the front, keeping their order
+	int32_t iTo = 0;
+	for (int32_t i = 0; i < Count; ++i)
+		if (Keep[i])
+		{
+			if (i != iTo)
+			{
+				X[iTo] = X[i]; Y[iTo] = Y[i];
+				XDir[iTo] = XDir[i]; YDir[iTo] = YDir[i];
+				A[iTo] = A[i]; Life[iTo] = Life[i]; B[iTo] = B[i];
+			}
+			++iTo;
+		}
+	const int32_t iRemoved = Count - iTo;
+	Count = iTo;
+	return iRemoved;
 }
 
 void C4ParticleList::Exec(C4Object *pObj)
 {
-	// execute all particles
-	C4Particle *pPrtNext = pFirst, *pPrt;
-	while (pPrt = pPrtNext)
+	// execute all batches
+	C4ParticleBatch *pPrev = nullptr, *pNext;
+	for (C4ParticleBatch *pBatch = pFirst; pBatch; pBatch = pNext)
 	{
-		// get next now, because destruction could corrupt the list
-		pPrtNext = pPrt->pNext;
+		pNext = pBatch->pNext;
 		// execute it
-		if (!pPrt->pDef->ExecProc(pPrt, pObj))
+		pBatch->pDef->ExecProc(*pBatch, pObj);
+		// sorry, life is over for some of you :P
+		pBatch->pDef->Count -= pBatch->Compact();
+		// remove empty batches
+		if (!pBatch->Count)
 		{
-			// sorry, life is over for you :P
-			--pPrt->pDef->Count;
-			pPrt->MoveList(*this, Game.Particles.FreeParticles);
+			if (pPrev) pPrev->pNext = pNext; else pFirst = pNext;
+			delete pBatch;
 		}
+		else
+			pPrev = pBatch;
 	}
 	// done
 }
 
 void C4ParticleList::Draw(C4FacetEx &cgo, C4Object *pObj)
 {
-	// draw all particles
-	for (C4Particle *pPrt = pFirst; pPrt; pPrt = pPrt->pNext)
-		pPrt->pDef->DrawProc(pPrt, cgo, pObj);
+	// draw all particles; newest first
+	// draw procs may add to a draw batch, which is flushed once per particle batch
+	C4Particle Prt;
+	for (C4ParticleBatch *pBatch = pFirst; pBatch; pBatch = pBatch->pNext)
+	{
+		Application.DDraw->BeginBatch(cgo.Surface);
+		for (int32_t i = pBatch->Count - 1; i >= 0; --i)
+		{
+			pBatch->Get(i, Prt);
+			pBatch->pDef->DrawProc(&Prt, cgo, pObj);
+		}
+		Application.DDraw->FlushBatch();
+	}
 	// done
 }
 
+void C4ParticleList::Add(const C4Particle &rPrt)
+{
+	// find batch of def
+	C4ParticleBatch *pBatch;
+	for (pBatch = pFirst; pBatch; pBatch = pBatch->pNext)
+		if (pBatch->pDef == rPrt.pDef)
+			break;
+	// none yet? insert before first
+	if (!pBatch)
+	{
+		pBatch = new C4ParticleBatch(rPrt.pDef);
+		pBatch->pNext = pFirst;
+		pFirst = pBatch;
+	}
+	pBatch->Add(rPrt);
+}
+
 void C4ParticleList::Clear()
 {
+	// adjust counts
+	for (C4ParticleBatch *pBatch = pFirst; pBatch; pBatch = pBatch->pNext)
+		pBatch->pDef->Count -= pBatch->Count;
 	// remove all particles
-	C4Particle *pPrtNext = pFirst, *pPrt;
-	while (pPrt = pPrtNext)
+	Discard();
+}
+
+void C4ParticleList::Discard()
+{
+	C4ParticleBatch *pNext, *pBatch = pFirst;
+	while (pBatch)
 	{
-		// get next now, because destruction could corrupt the list
-		pPrtNext = pPrt->pNext;
-		// sorry, life is over for you :P
-		--pPrt->pDef->Count;
-		pPrt->MoveList(*this, Game.Particles.FreeParticles);
+		pNext = pBatch->pNext;
+		delete pBatch;
+		pBatch = pNext;
 	}
+	pFirst = nullptr;
 }
 
 int32_t C4ParticleList::Remove(C4ParticleDef *pOfDef)
 {
 	int32_t iNumRemoved = 0;
-	// check all particles for def
-	C4Particle *pPrtNext = pFirst, *pPrt;
-	while (pPrt = pPrtNext)
+	// check all batches for def
+	C4ParticleBatch *pPrev = nullptr, *pNext;
+	for (C4ParticleBatch *pBatch = pFirst; pBatch; pBatch = pNext)
 	{
-		// get next now, because destruction could corrupt the list
-		pPrtNext = pPrt->pNext;
-		// execute it
-		if (!pOfDef || pPrt->pDef == pOfDef)
+		pNext = pBatch->pNext;
+		if (!pOfDef || pBatch->pDef == pOfDef)
 		{
 			// sorry, life is over for you :P
-			--pPrt->pDef->Count;
-			pPrt->MoveList(*this, Game.Particles.FreeParticles);
+			pBatch->pDef->Count -= pBatch->Count;
+			iNumRemoved += pBatch->Count;
+			if (pPrev) pPrev->pNext = pNext; else pFirst = pNext;
+			delete pBatch;
 		}
+		else
+			pPrev = pBatch;
 	}
 	// done
 	return iNumRemoved;
 }
 
+int32_t C4ParticleList::Push(C4ParticleDef *pOfDef, float dxdir, float dydir)
+{
+	int32_t iNumPushed = 0;
+	for (C4ParticleBatch *pBatch = pFirst; pBatch; pBatch = pBatch->pNext)
+		if (!pOfDef || pBatch->pDef == pOfDef)
+		{
+			// push them!
+			for (int32_t i = 0; i < pBatch->Count; ++i)
+			{
+				pBatch->XDir[i] += dxdir;
+				pBatch->YDir[i] += dydir;
+			}
+			// count pushed
+			iNumPushed += pBatch->Count;
+		}
+	// done
+	return iNumPushed;
+}
+
 C4ParticleSystem::C4ParticleSystem()
 {
 	// zero fields
@@ -326,39 +422,19 @@ C4ParticleSystem::~C4ParticleSystem()
 	Clear();
 }
 
-C4ParticleChunk *C4ParticleSystem::AddChunk()
-{
-	// add another chunk
-	C4ParticleChunk *pNewChnk = new C4ParticleChunk();
-	pNewChnk->pNext = Chunk.pNext;
-	Chunk.pNext = pNewChnk;
-	// register into free-particle-list
-	if (pNewChnk->Data[C4Px_BufSize - 1].pNext = FreeParticles.pFirst)
-		FreeParticles.pFirst->pPrev = &pNewChnk->Data[C4Px_BufSize - 1];
-	FreeParticles.pFirst = &pNewChnk->Data[0];
-	// return it
-	return pNewChnk;
-}
-
 void C4ParticleSystem::ClearParticles()
 {
 	// clear particle lists
 	C4ObjectLink *pLnk;
 	for (pLnk = Game.Objects.First; pLnk; pLnk = pLnk->Next)
-		pLnk->Obj->FrontParticles.pFirst = pLnk->Obj->BackParticles.pFirst = nullptr;
+	{
+		pLnk->Obj->FrontParticles.Discard(); pLnk->Obj->BackParticles.Discard();
+	}
 	for (pLnk = Game.Objects.InactiveObjects.First; pLnk; pLnk = pLnk->Next)
-		pLnk->Obj->FrontParticles.pFirst = pLnk->Obj->BackParticles.pFirst = nullptr;
-	GlobalParticles.pFirst = nullptr;
-	// reset chunks
-	C4ParticleChunk *pNextChnk = Chunk.pNext, *pChnk;
-	while (pChnk = pNextChnk)
 	{
-		pNextChnk = pChnk->pNext;
-		delete pChnk;
+		pLnk->Obj->FrontParticles.Discard(); pLnk->Obj->BackParticles.Discard();
 	}
-	Chunk.pNext = nullptr;
-	Chunk.Clear();
-	FreeParticles.pFirst = Chunk.Data;
+	GlobalParticles.Discard();
 	// adjust counts
 	for (C4ParticleDef *pDef = pDef0; pDef; pDef = pDef->pNext)
 		pDef->Count = 0;
@@ -375,47 +451,44 @@ void C4ParticleSystem::Clear()
 	// done
 }
 
-C4Particle *C4ParticleSystem::Create(C4ParticleDef *pOfDef,
+bool C4ParticleSystem::Create(C4ParticleDef *pOfDef,
 	float x, float y,
 	float xdir, float ydir,
 	float a, int32_t b, C4ParticleList *pPxList,
 	C4Object *pObj)
 {
 	// safety
-	if (!pOfDef) return nullptr;
+	if (!pOfDef) return false;
 	// default to global list
 	if (!pPxList) pPxList = &GlobalParticles;
 	// check count
 	int32_t MaxCount = pOfDef->MaxCount * (Config.Graphics.SmokeLevel + 20) / 150;
 	int32_t iRoom = MaxCount - pOfDef->Count;
-	if (iRoom <= 0) return nullptr;
+	if (iRoom <= 0) return false;
 	// reduce creation if limit is nearly reached
 	if (iRoom < (MaxCount >> 1))
-		if (SafeRandom(iRoom) < SafeRandom(MaxCount)) return nullptr;
-	// get free particle
-	if (!FreeParticles.pFirst) AddChunk();
-	C4Particle *pPrt = FreeParticles.pFirst;
-	if (!pPrt) return nullptr;
+		if (SafeRandom(iRoom) < SafeRandom(MaxCount)) return false;
 	// set values
-	pPrt->x = x; pPrt->y = y;
-	pPrt->xdir = xdir; pPrt->ydir = ydir;
-	pPrt->a = a; pPrt->b = b;
-	pPrt->pDef = pOfDef;
-	if (pPrt->pDef->Attach && pObj != nullptr)
+	C4Particle Prt;
+	Prt.x = x; Prt.y = y;
+	Prt.xdir = xdir; Prt.ydir = ydir;
+	Prt.a = a; Prt.b = b;
+	Prt.life = 0;
+	Prt.pDef = pOfDef;
+	if (Prt.pDef->Attach && pObj != nullptr)
 	{
-		pPrt->x -= pObj->x;
-		pPrt->y -= pObj->y;
+		Prt.x -= pObj->x;
+		Prt.y -= pObj->y;
 	}
 	// call initialization
-	if (!pOfDef->InitProc(pPrt, pObj))
+	if (!pOfDef->InitProc(&Prt, pObj))
 		// failed :(
-		return nullptr;
+		return false;
 	// count particle
 	++pOfDef->Count;
-	// more to desired list
-	pPrt->MoveList(Game.Particles.FreeParticles, *pPxList);
-	// return newly created particle
-	return pPrt;
+	// add to desired list
+	pPxList->Add(Prt);
+	return true;
 }
 
 bool C4ParticleSystem::Cast(C4ParticleDef *pOfDef, int32_t iAmount,
@@ -452,6 +525,16 @@ C4ParticleProc C4ParticleSystem::GetProc(const char *szName)
 	return nullptr;
 }
 
+C4ParticleExecProc C4ParticleSystem::GetExecProc(const char *szName)
+{
+	// seek in map
+	for (int32_t i = 0; C4ParticleExecProcMap[i].Name[0]; ++i)
+		if (SEqual(C4ParticleExecProcMap[i].Name, szName))
+			return C4ParticleExecProcMap[i].Proc;
+	// nothing found...
+	return nullptr;
+}
+
 C4ParticleDrawProc C4ParticleSystem::GetDrawProc(const char *szName)
 {
 	// seek in map
@@ -493,31 +576,30 @@ void C4ParticleSystem::SetDefParticles()
 
 int32_t C4ParticleSystem::Push(C4ParticleDef *pOfDef, float dxdir, float dydir)
 {
-	int32_t iNumPushed = 0;
-	// go through all particle chunks
-	for (C4ParticleChunk *pChnk = &Chunk; pChnk; pChnk = pChnk->pNext)
-	{
-		// go through all particles
-		C4Particle *pPrt = pChnk->Data; int32_t i = C4Px_BufSize;
-		while (i--)
-		{
-			// def fits?
-			if (!pOfDef || pPrt->pDef == pOfDef)
-			{
-				// push it!
-				pPrt->xdir += dxdir;
-				pPrt->ydir += dydir;
-				// count pushed
-				++iNumPushed;
-			}
-			// next particle
-			++pPrt;
-		}
-	}
+	// go through all particle lists
+	int32_t iNumPushed = GlobalParticles.Push(pOfDef, dxdir, dydir);
+	C4ObjectLink *pLnk;
+	for (pLnk = Game.Objects.First; pLnk; pLnk = pLnk->Next)
+		iNumPushed += pLnk->Obj->FrontParticles.Push(pOfDef, dxdir, dydir) + pLnk->Obj->BackParticles.Push(pOfDef, dxdir, dydir);
+	for (pLnk = Game.Objects.InactiveObjects.First; pLnk; pLnk = pLnk->Next)
+		iNumPushed += pLnk->Obj->FrontParticles.Push(pOfDef, dxdir, dydir) + pLnk->Obj->BackParticles.Push(pOfDef, dxdir, dydir);
 	// done
 	return iNumPushed;
 }
 
+void fxProcExec(C4ParticleBatch &rBatch, C4Object *pTarget)
+{
+	// execute single particle proc for every particle
+	C4ParticleProc ExecParticleProc = rBatch.pDef->ExecParticleProc;
+	C4Particle Prt;
+	for (int32_t i = 0; i < rBatch.Count; ++i)
+	{
+		rBatch.Get(i, Prt);
+		rBatch.Keep[i] = ExecParticleProc(&Prt, pTarget);
+		rBatch.Set(i, Prt);
+	}
+}
+
 bool fxSmokeInit(C4Particle *pPrt, C4Object *pTarget)
 {
 	// init lifetime
@@ -534,45 +616,50 @@ bool fxSmokeInit(C4Particle *pPrt, C4Object *pTarget)
 	return true;
 }
 
-bool fxSmokeExec(C4Particle *pPrt, C4Object *pTarget)
+void fxSmokeExec(C4ParticleBatch &rBatch, C4Object *pTarget)
 {
-	// lifetime
-	if (!--pPrt->life) return false;
-	bool fBuilding = !!(pPrt->life & 0x7fff0000);
-	// still building?
-	if (fBuilding)
-	{
-		// decrease init-time
-		pPrt->life -= 0x010000;
-		// increase color value
-		pPrt->b -= 0x10000000;
-		// if full-grown, adjust to lifetime
-		if (!(pPrt->life & 0x7fff0000))
-			pPrt->b = (pPrt->b & 0xffffff) | ((255 - pPrt->life) << 24);
-	}
-	// color change
-	uint32_t dwClr = pPrt->b;
-	pPrt->b = (LightenClrBy(dwClr, 1) & 0xffffff) | std::min<int32_t>((dwClr >> 24) + 1, 255) << 24;
-	// wind to float
-	if (!(pPrt->b % 12) || fBuilding)
-	{
-		pPrt->xdir = 0.025f * Game.Weather.GetWind(int32_t(pPrt->x), int32_t(pPrt->y));
-		if (pPrt->xdir < -2.0f) pPrt->xdir = -2.0f; else if (pPrt->xdir > 2.0f) pPrt->xdir = 2.0f;
-		pPrt->xdir += 0.1f * SafeRandom(41) - 2.0f;
-	}
-	// float
-	if (GBackSolid(int32_t(pPrt->x), int32_t(pPrt->y - pPrt->a)))
+	for (int32_t i = 0; i < rBatch.Count; ++i)
 	{
-		// if stuck, decay; otherwise, move down
-		if (!GBackSolid(int32_t(pPrt->x), int32_t(pPrt->y))) pPrt->y += 0.4f; else pPrt->a -= 2;
+		int32_t &life = rBatch.Life[i];
+		uint32_t b = rBatch.B[i];
+		float &x = rBatch.X[i], &y = rBatch.Y[i], &xdir = rBatch.XDir[i], &a = rBatch.A[i];
+		// lifetime
+		if (!(rBatch.Keep[i] = !!--life)) continue;
+		bool fBuilding = !!(life & 0x7fff0000);
+		// still building?
+		if (fBuilding)
+		{
+			// decrease init-time
+			life -= 0x010000;
+			// increase color value
+			b -= 0x10000000;
+			// if full-grown, adjust to lifetime
+			if (!(life & 0x7fff0000))
+				b = (b & 0xffffff) | ((255 - life) << 24);
+		}
+		// color change
+		b = (LightenClrBy(b, 1) & 0xffffff) | std::min<int32_t>((b >> 24) + 1, 255) << 24;
+		rBatch.B[i] = b;
+		// wind to float
+		if (!(rBatch.B[i] % 12) || fBuilding)
+		{
+			xdir = 0.025f * Game.Weather.GetWind(int32_t(x), int32_t(y));
+			if (xdir < -2.0f) xdir = -2.0f; else if (xdir > 2.0f) xdir = 2.0f;
+			xdir += 0.1f * SafeRandom(41) - 2.0f;
+		}
+		// float
+		if (GBackSolid(int32_t(x), int32_t(y - a)))
+		{
+			// if stuck, decay; otherwise, move down
+			if (!GBackSolid(int32_t(x), int32_t(y))) y += 0.4f; else a -= 2;
+		}
+		else
+			--y;
+		x += xdir;
+		// increase in size
+		a *= 1.01f;
+		// done, keep
 	}
-	else
-		--pPrt->y;
-	pPrt->x += pPrt->xdir;
-	// increase in size
-	pPrt->a *= 1.01f;
-	// done, keep
-	return true;
 }
 
 void fxSmokeDraw(C4Particle *pPrt, C4FacetEx &cgo, C4Object *pTarget)
@@ -593,7 +680,7 @@ void fxSmokeDraw(C4Particle *pPrt, C4FacetEx &cgo, C4Object *pTarget)
 	int32_t ipy = i % 4;
 	// draw at pos
 	Application.DDraw->ActivateBlitModulation(pPrt->b);
-	pDef->Gfx.DrawX(cgo.Surface, int32_t(cx - pPrt->a), int32_t(cy - pPrt->a), int32_t(pPrt->a * 2), int32_t(pPrt->a * 2), ipx, ipy);
+	pDef->Gfx.BatchX(int32_t(cx - pPrt->a), int32_t(cy - pPrt->a), int32_t(pPrt->a * 2), int32_t(pPrt->a * 2), ipx, ipy);
 	Application.DDraw->DeactivateBlitModulation();
 }
 
@@ -611,89 +698,108 @@ bool fxStdInit(C4Particle *pPrt, C4Object *pTarget)
 	return true;
 }
 
-bool fxStdExec(C4Particle *pPrt, C4Object *pTarget)
+void fxStdExec(C4ParticleBatch &rBatch, C4Object *pTarget)
 {
-	float dx = pPrt->x, dy = pPrt->y;
-	float dxdir = pPrt->xdir, dydir = pPrt->ydir;
-	// rel. position & movement
-	if (pPrt->pDef->Attach && pTarget != nullptr)
+	C4ParticleDef *pDef = rBatch.pDef;
+	// rel. position & movement is the same for the whole batch
+	float ox = 0.0f, oy = 0.0f, oxdir = 0.0f, oydir = 0.0f;
+	if (pDef->Attach && pTarget != nullptr)
 	{
-		dx += pTarget->x;
-		dy += pTarget->y;
-		dxdir += fixtof(pTarget->xdir);
-		dydir += fixtof(pTarget->ydir);
+		ox = pTarget->x;
+		oy = pTarget->y;
+		oxdir = fixtof(pTarget->xdir);
+		oydir = fixtof(pTarget->ydir);
 	}
+	const float fGravity = pDef->GravityAcc ? fixtof(GravAccel * pDef->GravityAcc) / 100.0f : 0.0f;
+	// fade out
+	int32_t iFade = pDef->AlphaFade;
+	if (iFade < 0) if (Game.FrameCounter % -iFade == 0) iFade = 1; else iFade = 0;
 
-	// move
-	if (pPrt->xdir || pPrt->ydir)
+	for (int32_t i = 0; i < rBatch.Count; ++i)
 	{
-		if (pPrt->pDef->VertexCount && GBackSolid(int32_t(dx + pPrt->xdir), int32_t(dy + pPrt->ydir + pPrt->pDef->VertexY * pPrt->a / 100.0f)))
+		float &x = rBatch.X[i], &y = rBatch.Y[i], &xdir = rBatch.XDir[i], &ydir = rBatch.YDir[i];
+		int32_t &life = rBatch.Life[i];
+		const float a = rBatch.A[i];
+		bool &fKeep = rBatch.Keep[i];
+		float dx = x + ox, dy = y + oy;
+		float dxdir = xdir + oxdir, dydir = ydir + oydir;
+
+		// move
+		if (xdir || ydir)
 		{
-			// collision
-			if (pPrt->pDef->CollisionProc)
-				if (!pPrt->pDef->CollisionProc(pPrt, pTarget)) return false;
+			if (pDef->VertexCount && GBackSolid(int32_t(dx + xdir), int32_t(dy + ydir + pDef->VertexY * a / 100.0f)))
+			{
+				// collision
+				if (pDef->CollisionProc)
+				{
+					C4Particle Prt;
+					rBatch.Get(i, Prt);
+					fKeep = pDef->CollisionProc(&Prt, pTarget);
+					rBatch.Set(i, Prt);
+					if (!fKeep) continue;
+				}
+			}
+			else if (pDef->RByV != 2)
+			{
+				x += xdir;
+				y += ydir;
+			}
+			else
+			{
+				// With RByV=2, the V is only used for rotation, not for movement
+			}
 		}
-		else if (pPrt->pDef->RByV != 2)
+		// apply gravity
+		if (pDef->GravityAcc) ydir += fGravity;
+		// apply WindDrift
+		if (pDef->WindDrift && !GBackSolid(int32_t(dx), int32_t(dy)))
 		{
-			pPrt->x += pPrt->xdir;
-			pPrt->y += pPrt->ydir;
+			// Air speed: Wind plus some random
+			int32_t iWind = GBackWind(int32_t(dx), int32_t(dy));
+			float txdir = iWind / 15.0f;
+			float tydir = 0;
+
+			// Air friction, based on WindDrift.
+			int32_t iWindDrift = (std::max)(pDef->WindDrift - 20, 0);
+			xdir += ((txdir - dxdir) * iWindDrift) / 800;
+			ydir += ((tydir - dydir) * iWindDrift) / 800;
 		}
-		else
+		if (iFade)
 		{
-			// With RByV=2, the V is only used for rotation, not for movement
+			uint32_t dwClr = rBatch.B[i];
+			int32_t iAlpha = dwClr >> 24;
+			iAlpha += pDef->AlphaFade;
+			if (iAlpha >= 0xff) { fKeep = false; continue; }
+			rBatch.B[i] = (dwClr & 0xffffff) | (iAlpha << 24);
 		}
-	}
-	// apply gravity
-	if (pPrt->pDef->GravityAcc) pPrt->ydir += fixtof(GravAccel * pPrt->pDef->GravityAcc) / 100.0f;
-	// apply WindDrift
-	if (pPrt->pDef->WindDrift && !GBackSolid(int32_t(dx), int32_t(dy)))
-	{
-		// Air speed: Wind plus some random
-		int32_t iWind = GBackWind(int32_t(dx), int32_t(dy));
-		float txdir = iWind / 15.0f;
-		float tydir = 0;
-
-		// Air friction, based on WindDrift.
-		int32_t iWindDrift = (std::max)(pPrt->pDef->WindDrift - 20, 0);
-		pPrt->xdir += ((txdir - dxdir) * iWindDrift) / 800;
-		pPrt->ydir += ((tydir - dydir) * iWindDrift) / 800;
-	}
-	// fade out
-	int32_t iFade = pPrt->pDef->AlphaFade;
-	if (iFade < 0) if (Game.FrameCounter % -iFade == 0) iFade = 1; else iFade = 0;
-	if (iFade)
-	{
-		uint32_t dwClr = pPrt->b;
-		int32_t iAlpha = dwClr >> 24;
-		iAlpha += pPrt->pDef->AlphaFade;
-		if (iAlpha >= 0xff) return false;
-		pPrt->b = (dwClr & 0xffffff) | (iAlpha << 24);
-	}
-	// if delay is given, advance lifetime
-	if (pPrt->pDef->Delay)
-	{
-		if (pPrt->life < 0)
+		// if delay is given, advance lifetime
+		if (pDef->Delay)
 		{
-			// decay
-			return pPrt->life-- >= -pPrt->pDef->FadeOutLen * pPrt->pDef->FadeOutDelay;
-		}
-		++pPrt->life;
-		// check if still alive
-		int32_t iPhase = pPrt->life / pPrt->pDef->Delay;
-		int32_t length = pPrt->pDef->Length - pPrt->pDef->Reverse;
-		if (iPhase >= length * pPrt->pDef->Repeats + pPrt->pDef->Reverse)
-		{
-			// do fadeout, if assigned
-			if (!pPrt->pDef->FadeOutLen) return false;
-			pPrt->life = -1;
+			if (life < 0)
+			{
+				// decay
+				fKeep = life-- >= -pDef->FadeOutLen * pDef->FadeOutDelay;
+				continue;
+			}
+			++life;
+			// check if still alive
+			int32_t iPhase = life / pDef->Delay;
+			int32_t length = pDef->Length - pDef->Reverse;
+			fKeep = true;
+			if (iPhase >= length * pDef->Repeats + pDef->Reverse)
+			{
+				// do fadeout, if assigned
+				if (!pDef->FadeOutLen) fKeep = false;
+				else life = -1;
+			}
+			continue;
 		}
-		return true;
+		// outside landscape range?
+		bool kp;
+		if (dxdir > 0) kp =       (dx - a < GBackWdt); else kp =       (dx + a > 0);
+		if (dydir > 0) kp = kp && (dy - a < GBackHgt); else kp = kp && (dy + a > pDef->YOff);
+		fKeep = kp;
 	}
-	// outside landscape range?
-	bool kp;
-	if (dxdir > 0) kp =       (dx - pPrt->a < GBackWdt); else kp =       (dx + pPrt->a > 0);
-	if (dydir > 0) kp = kp && (dy - pPrt->a < GBackHgt); else kp = kp && (dy + pPrt->a > pPrt->pDef->YOff);
-	return kp;
 }
 
 bool fxBounce(C4Particle *pPrt, C4Object *pTarget)
@@ -790,9 +896,7 @@ void fxStdDraw(C4Particle *pPrt, C4FacetEx &cgo, C4Object *pTarget)
 C4ParticleProcRec C4ParticleProcMap[] =
 {
 	{ "SmokeInit", fxSmokeInit },
-	{ "SmokeExec", fxSmokeExec },
 	{ "StdInit",   fxStdInit },
-	{ "StdExec",   fxStdExec },
 	{ "Bounce",    fxBounce },
 	{ "BounceY",   fxBounceY },
 	{ "Stop",      fxStop },
@@ -800,6 +904,13 @@ C4ParticleProcRec C4ParticleProcMap[] =
 	{ "",          nullptr }
 };
 
+C4ParticleExecProcRec C4ParticleExecProcMap[] =
+{
+	{ "SmokeExec", fxSmokeExec },
+	{ "StdExec",   fxStdExec },
+	{ "",          nullptr }
+};
+
 C4ParticleDrawProcRec C4ParticleDrawProcMap[] =
 {
 	{ "Smoke", fxSmokeDraw },
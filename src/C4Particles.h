@@ -19,8 +19,8 @@
 // - everything, that is not sync-relevant
 // function pointers for drawing and executing are used
 // instead of virtual classes and a hierarchy, because
-// the latter ones couldn't be optimized using static
-// chunks
+// the latter ones couldn't be optimized using per-definition
+// batches
 // thus, more complex partivle behaviour should be solved via
 // objects
 // note: this particle system will always assume the owning def
@@ -33,18 +33,21 @@
 #include <C4Group.h>
 #include <C4Shape.h>
 
+#include <cstdint>
+#include <memory>
+
 // class predefs
 class C4ParticleDefCore;
 class C4ParticleDef;
 class C4Particle;
-class C4ParticleChunk;
+class C4ParticleBatch;
 class C4ParticleList;
 class C4ParticleSystem;
 
 typedef bool(*C4ParticleProc)(C4Particle *, C4Object *); // generic particle proc
 typedef C4ParticleProc C4ParticleInitProc; // particle init proc - init and return whether particle could be created
-typedef C4ParticleProc C4ParticleExecProc; // particle execution proc - returns whether particle died
 typedef C4ParticleProc C4ParticleCollisionProc; // particle collision proc - returns whether particle died
+typedef void(*C4ParticleExecProc)(C4ParticleBatch &, C4Object *); // particle execution proc - executes all particles of a batch and sets their Keep-flags
 typedef void(*C4ParticleDrawProc)(C4Particle *, C4FacetEx &, C4Object *); // particle drawing code
 
 #define ParticleSystem Game.Particles
@@ -97,7 +100,8 @@ public:
 	float Aspect; // height:width
 
 	C4ParticleInitProc      InitProc;      // procedure called once upon creation of the particle
-	C4ParticleExecProc      ExecProc;      // procedure used for execution of one particle
+	C4ParticleExecProc      ExecProc;      // procedure used for execution of all particles of this kind in one list
+	C4ParticleProc          ExecParticleProc; // single particle procedure executed by ExecProc, if ExecFn is no batch proc
 	C4ParticleCollisionProc CollisionProc; // procedure called upon collision with the landscape; may be nullptr
 	C4ParticleDrawProc      DrawProc;      // procedure used for drawing of one particle
 
@@ -113,55 +117,64 @@ public:
 };
 
 // one tiny little particle
-// note: list management done by the chunk, which spares one ptr here
-// the chunk initializes the values to zero here, too; so no ctors here...
+// particles are stored in batches; this is only used to pass single particles to init, collision and draw procs
 class C4Particle
 {
-protected:
-	C4Particle *pPrev, *pNext; // previous/next particle of the same list in the buffer
-
-	void MoveList(C4ParticleList &rFrom, C4ParticleList &rTo); // move from one list to another
-
 public:
 	C4ParticleDef *pDef; // kind of particle
 	float x, y, xdir, ydir; // position and movement
 	int32_t life; // lifetime remaining for this particle
 	float a; int32_t b; // all-purpose values
-
-	friend class C4ParticleChunk;
-	friend class C4ParticleList;
-	friend class C4ParticleSystem;
 };
 
-// one chunk of particles
-// linked list is managed by owner
-class C4ParticleChunk
+// all particles of one kind in one list
+// every value is stored in an array of its own, so exec procs can process all particles in one go
+class C4ParticleBatch
 {
-protected:
-	C4ParticleChunk *pNext; // single linked list
-	C4Particle Data[C4Px_BufSize]; // the particles
-
 public:
-	C4ParticleChunk();
-	~C4ParticleChunk();
+	C4ParticleDef *pDef; // kind of all particles in this batch
+	C4ParticleBatch *pNext; // next batch of the same list
+	int32_t Count; // number of particles
+
+	float *X, *Y, *XDir, *YDir, *A;
+	int32_t *Life, *B;
+	bool *Keep; // set by exec proc: particle is still alive
 
-	void Clear(); // clear all particles
+protected:
+	int32_t Capacity; // number of particles that fit into the buffer
+	std::unique_ptr<uint8_t[]> Buffer; // memory for all arrays
+
+	void Grow();
 
-	friend class C4ParticleSystem;
+public:
+	C4ParticleBatch(C4ParticleDef *pDef);
+	C4ParticleBatch(const C4ParticleBatch &) = delete;
+	C4ParticleBatch &operator=(const C4ParticleBatch &) = delete;
+
+	void Get(int32_t i, C4Particle &rPrt) const; // copy particle out of the arrays
+	void Set(int32_t i, const C4Particle &rPrt); // store particle into the arrays
+	void Add(const C4Particle &rPrt); // append particle
+	int32_t Compact(); // remove all particles whose Keep-flag isn't set; returns number of removed particles
 };
 
 // a subset of particles
 class C4ParticleList
 {
 public:
-	C4Particle *pFirst; // first particle in list - others follow in linked list
+	C4ParticleBatch *pFirst; // first batch in list - others follow in linked list
 
 	C4ParticleList() { pFirst = nullptr; }
+	~C4ParticleList() { Discard(); }
+	C4ParticleList(const C4ParticleList &) = delete;
+	C4ParticleList &operator=(const C4ParticleList &) = delete;
 
 	void Exec(C4Object *pObj = nullptr); // execute all particles
 	void Draw(C4FacetEx &cgo, C4Object *pObj = nullptr); // draw all particles
+	void Add(const C4Particle &rPrt); // add initialized particle to the batch of its def
 	void Clear(); // remove all particles
+	void Discard(); // free all particles without adjusting the def counts
 	int32_t Remove(C4ParticleDef *pOfDef); // remove all particles of def
+	int32_t Push(C4ParticleDef *pOfDef, float dxdir, float dydir); // add movement to all particles of def
 
 	operator bool() { return !!pFirst; } // checks whether list contains particles
 };
@@ -170,16 +183,13 @@ public:
 class C4ParticleSystem
 {
 protected:
-	C4ParticleChunk Chunk; // linked list for particle chunks
 	C4ParticleDef *pDef0, *pDefL; // linked list for particle defs
 
-	C4ParticleChunk *AddChunk(); // add a new chunk to the list
-
 	C4ParticleProc GetProc(const char *szName); // get init/exec proc for a particle type
+	C4ParticleExecProc GetExecProc(const char *szName); // get batch exec proc for a particle type
 	C4ParticleDrawProc GetDrawProc(const char *szName); // get draw proc for a particle type
 
 public:
-	C4ParticleList FreeParticles; // list of free particles
 	C4ParticleList GlobalParticles; // list of free particles
 
 	C4ParticleDef *pSmoke;  // default particle: smoke
@@ -194,7 +204,7 @@ public:
 	void ClearParticles(); // remove all particles
 	void Clear(); // remove all particle definitions and particles
 
-	C4Particle *Create(C4ParticleDef *pOfDef, // create one particle of given type
+	bool Create(C4ParticleDef *pOfDef, // create one particle of given type
 		float x, float y, float xdir = 0.0f, float ydir = 0.0f,
 		float a = 0.0f, int32_t b = 0, C4ParticleList *pPxList = nullptr, C4Object *pObj = nullptr);
 	bool Cast(C4ParticleDef *pOfDef, // create several particles with different speeds and params
@@ -211,13 +221,12 @@ public:
 	bool IsFireParticleLoaded() { return pFire1 && pFire2; }
 
 	friend class C4ParticleDef;
-	friend class C4Particle;
-	friend class C4ParticleChunk;
 };
 
 // default particle execution/drawing functions
 bool fxStdInit(C4Particle *pPrt, C4Object *pTarget);
-bool fxStdExec(C4Particle *pPrt, C4Object *pTarget);
+void fxStdExec(C4ParticleBatch &rBatch, C4Object *pTarget);
+void fxProcExec(C4ParticleBatch &rBatch, C4Object *pTarget); // executes ExecParticleProc of the def for every particle
 void fxStdDraw(C4Particle *pPrt, C4FacetEx &cgo, C4Object *pTarget);
 
 // structures used for static function maps
@@ -227,6 +236,12 @@ struct C4ParticleProcRec
 	C4ParticleProc Proc; // procedure
 };
 
+struct C4ParticleExecProcRec
+{
+	char Name[C4Px_MaxIDLen + 1]; // name of procedure
+	C4ParticleExecProc Proc; // procedure
+};
+
 struct C4ParticleDrawProcRec
 {
 	char Name[C4Px_MaxIDLen + 1]; // name of procedure
@@ -234,4 +249,5 @@ struct C4ParticleDrawProcRec
 };
 
 extern C4ParticleProcRec C4ParticleProcMap[]; // particle init/execution function map
+extern C4ParticleExecProcRec C4ParticleExecProcMap[]; // particle batch execution function map
 extern C4ParticleDrawProcRec C4ParticleDrawProcMap[]; // particle drawing function map
@@ -39,6 +39,14 @@
    SetCompletePath don't set move-to waypoint if setting use-zone waypoint (is
    done by C4Command::Transfer on demand and would only cause no-good-entry-point
    move-to's on crawl-zone-entries).
+
+   Path cache
+   Identical searches are answered from a small cache of recent results. Every
+   landscape probe of a search widens its footprint; the landscape is divided
+   into regions which are stamped on every change, and a cached path is
+   dropped as soon as a region within its footprint or any transfer zone has
+   changed. A cache hit thus always yields the same waypoints as a new search,
+   so the cache does not need to be synchronized (e.g. for runtime joins).
 */
 
 #include <C4Include.h>
@@ -46,6 +54,7 @@
 
 #include <C4FacetEx.h>
 #include <C4Game.h>
+#include <C4Wrappers.h>
 
 const int32_t C4PF_MaxDepth  = 35,
               C4PF_MaxCrawl  = 800,
@@ -124,7 +133,7 @@ bool C4PathFinderRay::Execute()
 			else
 			{
 				// Find exit point
-				if (!UseZone->GetEntryPoint(X2, Y2, TargetX, TargetY))
+				if (!GetEntryPoint(UseZone, X2, Y2, TargetX, TargetY))
 				{
 					Status = C4PF_Ray_Failure; break;
 				}
@@ -154,7 +163,7 @@ bool C4PathFinderRay::Execute()
 		{
 			// Zone entry point adjust (if not already in zone)
 			if (!pZone->At(X, Y))
-				pZone->GetEntryPoint(X2, Y2, X2, Y2);
+				GetEntryPoint(pZone, X2, Y2, X2, Y2);
 			// Add use-zone ray
 			if (!pPathFinder->AddRay(X2, Y2, TargetX, TargetY, Depth + 1, Direction, this, pZone))
 			{
@@ -201,7 +210,7 @@ bool C4PathFinderRay::Execute()
 					if (!pZone->Used)
 					{
 						// Add use-zone ray (with zone entry point adjust)
-						iX = X2; iY = Y2; if (pZone->GetEntryPoint(iX, iY, X2, Y2))
+						iX = X2; iY = Y2; if (GetEntryPoint(pZone, iX, iY, X2, Y2))
 							if (!pPathFinder->AddRay(iX, iY, TargetX, TargetY, Depth + 1, Direction, this, pZone))
 							{
 								Status = C4PF_Ray_Failure; break;
@@ -390,18 +399,24 @@ void C4PathFinderRay::SetCompletePath()
 	{
 		// Transfer waypoint
 		if (pRay->UseZone)
-			pPathFinder->SetWaypoint(pRay->X2, pRay->Y2, reinterpret_cast<intptr_t>(pRay->UseZone->Object),
-				pPathFinder->WaypointParameter);
+			pPathFinder->SetWaypointAndRecord(pRay->X2, pRay->Y2, reinterpret_cast<intptr_t>(pRay->UseZone->Object));
 		// MoveTo waypoint
 		else
-			pPathFinder->SetWaypoint(pRay->From->X2, pRay->From->Y2, 0,
-				pPathFinder->WaypointParameter);
+			pPathFinder->SetWaypointAndRecord(pRay->From->X2, pRay->From->Y2, 0);
 	}
 }
 
 bool C4PathFinderRay::PointFree(int32_t iX, int32_t iY)
 {
-	return pPathFinder->PointFree(iX, iY);
+	return pPathFinder->ProbePoint(iX, iY);
+}
+
+bool C4PathFinderRay::GetEntryPoint(C4TransferZone *pZone, int32_t &rX, int32_t &rY, int32_t iToX, int32_t iToY)
+{
+	// The entry point search checks the zone border and might adjust vertically
+	// along the whole landscape height (see AdjustMoveToTarget)
+	pPathFinder->AddFootprint(C4Rect(pZone->X - 1, 0, pZone->Wdt + 2, GBackHgt));
+	return pZone->GetEntryPoint(rX, rY, iToX, iToY);
 }
 
 bool C4PathFinderRay::CrawlTargetFree(int32_t iX, int32_t iY, int32_t iAttach, int32_t iDirection)
@@ -527,25 +542,124 @@ void C4PathFinder::Default()
 	PointFree = nullptr;
 	SetWaypoint = nullptr;
 	FirstRay = nullptr;
+	FreeRays = nullptr;
 	WaypointParameter = 0;
 	Success = false;
 	TransferZones = nullptr;
 	TransferZonesEnabled = true;
 	Level = 1;
+	Cache.clear();
+	CacheReplace = 0;
+	RegionStamps.clear();
+	RegionsWdt = RegionsHgt = 0;
+	ChangeStamp = 0;
+	FootprintX1 = FootprintY1 = FootprintX2 = FootprintY2 = 0;
+	Recording = nullptr;
 }
 
 void C4PathFinder::Clear()
 {
+	ClearRays();
 	C4PathFinderRay *pRay, *pNext;
-	for (pRay = FirstRay; pRay; pRay = pNext) { pNext = pRay->Next; delete pRay; }
+	for (pRay = FreeRays; pRay; pRay = pNext) { pNext = pRay->Next; delete pRay; }
+	FreeRays = nullptr;
+	ClearCache();
+	RegionStamps.clear();
+	RegionsWdt = RegionsHgt = 0;
+}
+
+void C4PathFinder::ClearRays()
+{
+	// Keep the rays for the next search
+	C4PathFinderRay *pRay, *pNext;
+	for (pRay = FirstRay; pRay; pRay = pNext)
+	{
+		pNext = pRay->Next;
+		pRay->Next = FreeRays;
+		FreeRays = pRay;
+	}
 	FirstRay = nullptr;
 }
 
+void C4PathFinder::ClearCache()
+{
+	Cache.clear();
+	CacheReplace = 0;
+	Recording = nullptr;
+	std::fill(RegionStamps.begin(), RegionStamps.end(), 0);
+	ChangeStamp = 0;
+}
+
 void C4PathFinder::Init(bool(*fnPointFree)(int32_t, int32_t), C4TransferZones *pTransferZones)
 {
 	// Set data
 	PointFree = fnPointFree;
 	TransferZones = pTransferZones;
+	// Landscape regions for cache invalidation
+	RegionsWdt = (GBackWdt >> RegionShift) + 1;
+	RegionsHgt = (GBackHgt >> RegionShift) + 1;
+	RegionStamps.assign(RegionsWdt * RegionsHgt, 0);
+	Cache.reserve(CacheSize);
+	ClearCache();
+}
+
+void C4PathFinder::NotifyLandscapeChange(const C4Rect &rect)
+{
+	const int32_t iX1 = std::max<int32_t>(rect.x >> RegionShift, 0), iY1 = std::max<int32_t>(rect.y >> RegionShift, 0);
+	const int32_t iX2 = std::min<int32_t>((rect.x + rect.Wdt) >> RegionShift, RegionsWdt - 1), iY2 = std::min<int32_t>((rect.y + rect.Hgt) >> RegionShift, RegionsHgt - 1);
+	for (int32_t y = iY1; y <= iY2; y++)
+		for (int32_t x = iX1; x <= iX2; x++)
+			RegionStamps[y * RegionsWdt + x] = ChangeStamp;
+}
+
+bool C4PathFinder::ProbePoint(int32_t iX, int32_t iY)
+{
+	if (iX < FootprintX1) FootprintX1 = iX; else if (iX > FootprintX2) FootprintX2 = iX;
+	if (iY < FootprintY1) FootprintY1 = iY; else if (iY > FootprintY2) FootprintY2 = iY;
+	return PointFree(iX, iY);
+}
+
+void C4PathFinder::AddFootprint(const C4Rect &rect)
+{
+	FootprintX1 = std::min(FootprintX1, rect.x); FootprintX2 = std::max(FootprintX2, rect.x + rect.Wdt - 1);
+	FootprintY1 = std::min(FootprintY1, rect.y); FootprintY2 = std::max(FootprintY2, rect.y + rect.Hgt - 1);
+}
+
+void C4PathFinder::SetWaypointAndRecord(int32_t iX, int32_t iY, intptr_t iTransferObject)
+{
+	if (Recording) Recording->Waypoints.push_back({iX, iY, iTransferObject});
+	SetWaypoint(iX, iY, iTransferObject, WaypointParameter);
+}
+
+C4PathFinder::CachedPath *C4PathFinder::FindCached(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY)
+{
+	for (auto &path : Cache)
+	{
+		if (path.FromX != iFromX || path.FromY != iFromY || path.ToX != iToX || path.ToY != iToY
+			|| path.Level != Level || path.TransferZonesEnabled != TransferZonesEnabled)
+			continue;
+		// Check for changes since the path has been found
+		bool fValid = !(TransferZonesEnabled && TransferZones && TransferZones->GetGeneration() != path.TransferZonesGeneration);
+		for (int32_t y = path.Footprint.y; fValid && y < path.Footprint.y + path.Footprint.Hgt; y++)
+			for (int32_t x = path.Footprint.x; x < path.Footprint.x + path.Footprint.Wdt; x++)
+				if (RegionStamps[y * RegionsWdt + x] >= path.Stamp)
+				{
+					fValid = false; break;
+				}
+		if (fValid) return &path;
+		// Outdated: never match again
+		path.Level = 0;
+	}
+	return nullptr;
+}
+
+C4PathFinderRay *C4PathFinder::NewRay()
+{
+	C4PathFinderRay *pRay = FreeRays;
+	if (!pRay) return new C4PathFinderRay;
+	FreeRays = pRay->Next;
+	pRay->Default();
+	return pRay;
 }
 
 void C4PathFinder::EnableTransferZones(bool fEnabled)
@@ -601,7 +715,7 @@ bool C4PathFinder::Execute()
 bool C4PathFinder::Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, bool(*fnSetWaypoint)(int32_t, int32_t, intptr_t, intptr_t), intptr_t iWaypointParameter)
 {
 	// Prepare
-	Clear();
+	ClearRays();
 
 	// Parameter safety
 	if (!fnSetWaypoint) return false;
@@ -611,12 +725,58 @@ bool C4PathFinder::Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iT
 	// Start & target coordinates must be free
 	if (!PointFree(iFromX, iFromY) || !PointFree(iToX, iToY)) return false;
 
-	// Add the first two rays
-	if (!AddRay(iFromX, iFromY, iToX, iToY, 0, C4PF_Direction_Left, nullptr)) return false;
-	if (!AddRay(iFromX, iFromY, iToX, iToY, 0, C4PF_Direction_Right, nullptr)) return false;
+	// Same search done before and nothing changed? (not if the rays should be shown)
+	if (!Game.GraphicsSystem.ShowPathfinder)
+		if (const CachedPath *pPath = FindCached(iFromX, iFromY, iToX, iToY))
+		{
+			for (const auto &waypoint : pPath->Waypoints)
+				SetWaypoint(waypoint.X, waypoint.Y, waypoint.TransferObject, WaypointParameter);
+			return pPath->Success;
+		}
 
-	// Run
-	Run();
+	// Record new cache entry
+	if (!RegionStamps.empty())
+	{
+		// Stamp overflow: start over
+		if (!++ChangeStamp)
+		{
+			ClearCache();
+			ChangeStamp = 1;
+		}
+		if (Cache.size() < CacheSize)
+			Recording = &Cache.emplace_back();
+		else
+		{
+			Recording = &Cache[CacheReplace];
+			CacheReplace = (CacheReplace + 1) % CacheSize;
+		}
+		Recording->FromX = iFromX; Recording->FromY = iFromY;
+		Recording->ToX = iToX; Recording->ToY = iToY;
+		Recording->Level = Level;
+		Recording->TransferZonesEnabled = TransferZonesEnabled;
+		Recording->Stamp = ChangeStamp;
+		Recording->TransferZonesGeneration = TransferZones ? TransferZones->GetGeneration() : 0;
+		Recording->Waypoints.clear();
+	}
+	FootprintX1 = std::min(iFromX, iToX); FootprintX2 = std::max(iFromX, iToX);
+	FootprintY1 = std::min(iFromY, iToY); FootprintY2 = std::max(iFromY, iToY);
+
+	// Add the first two rays and run
+	if (AddRay(iFromX, iFromY, iToX, iToY, 0, C4PF_Direction_Left, nullptr)
+		&& AddRay(iFromX, iFromY, iToX, iToY, 0, C4PF_Direction_Right, nullptr))
+		Run();
+	else
+		Success = false;
+
+	// Finish cache entry
+	if (Recording)
+	{
+		Recording->Success = Success;
+		const int32_t iX1 = BoundBy<int32_t>(FootprintX1 >> RegionShift, 0, RegionsWdt - 1), iY1 = BoundBy<int32_t>(FootprintY1 >> RegionShift, 0, RegionsHgt - 1);
+		const int32_t iX2 = BoundBy<int32_t>(FootprintX2 >> RegionShift, 0, RegionsWdt - 1), iY2 = BoundBy<int32_t>(FootprintY2 >> RegionShift, 0, RegionsHgt - 1);
+		Recording->Footprint.Set(iX1, iY1, iX2 - iX1 + 1, iY2 - iY1 + 1);
+		Recording = nullptr;
+	}
 
 	// Success
 	return Success;
@@ -627,7 +787,7 @@ bool C4PathFinder::AddRay(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t
 	// Max depth
 	if (iDepth >= C4PF_MaxDepth * Level) return false;
 	// Allocate and set new ray
-	auto ray = std::make_unique<C4PathFinderRay>();
+	C4PathFinderRay *ray = NewRay();
 	ray->X = iFromX; ray->Y = iFromY;
 	ray->X2 = iFromX; ray->Y2 = iFromY;
 	ray->TargetX = iToX; ray->TargetY = iToY;
@@ -637,7 +797,7 @@ bool C4PathFinder::AddRay(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t
 	ray->pPathFinder = this;
 	ray->Next = FirstRay;
 	ray->UseZone = pUseZone;
-	FirstRay = ray.release();
+	FirstRay = ray;
 	return true;
 }
 
@@ -646,7 +806,7 @@ bool C4PathFinder::SplitRay(C4PathFinderRay *pRay, int32_t iAtX, int32_t iAtY)
 	// Max depth
 	if (pRay->Depth >= C4PF_MaxDepth * Level) return false;
 	// Allocate and set new ray
-	auto newRay = std::make_unique<C4PathFinderRay>();
+	C4PathFinderRay *newRay = NewRay();
 	newRay->Status = C4PF_Ray_Still;
 	newRay->X = pRay->X; newRay->Y = pRay->Y;
 	newRay->X2 = iAtX; newRay->Y2 = iAtY;
@@ -656,9 +816,9 @@ bool C4PathFinder::SplitRay(C4PathFinderRay *pRay, int32_t iAtX, int32_t iAtY)
 	newRay->From = pRay->From;
 	newRay->pPathFinder = this;
 	newRay->Next = FirstRay;
-	FirstRay = newRay.get();
+	FirstRay = newRay;
 	// Adjust split ray
-	pRay->From = newRay.release();
+	pRay->From = newRay;
 	pRay->X = iAtX; pRay->Y = iAtY;
 	return true;
 }
@@ -19,8 +19,12 @@
 #pragma once
 
 #include "C4ForwardDeclarations.h"
+#include <C4Rect.h>
 #include <C4TransferZone.h>
 
+#include <cstdint>
+#include <vector>
+
 class C4PathFinderRay
 {
 	friend class C4PathFinder;
@@ -58,6 +62,7 @@ protected:
 	bool PointFree(int32_t iX, int32_t iY);
 	bool Crawl();
 	bool PathFree(int32_t &rX, int32_t &rY, int32_t iToX, int32_t iToY, C4TransferZone **ppZone = nullptr);
+	bool GetEntryPoint(C4TransferZone *pZone, int32_t &rX, int32_t &rY, int32_t iToX, int32_t iToY);
 };
 
 class C4PathFinder
@@ -68,18 +73,54 @@ public:
 	C4PathFinder();
 	~C4PathFinder();
 
+	// size of the landscape regions used to invalidate cached paths (as shift)
+	static constexpr int32_t RegionShift = 5;
+	static constexpr size_t CacheSize = 32;
+
+protected:
+	struct CachedWaypoint
+	{
+		int32_t X, Y;
+		intptr_t TransferObject;
+	};
+
+	// Result of a previous search. Only reused for exactly the same query and
+	// only as long as no landscape region inside Footprint and no transfer zone
+	// has changed since, so a cache hit always equals a fresh search.
+	struct CachedPath
+	{
+		int32_t FromX, FromY, ToX, ToY;
+		int Level;
+		bool TransferZonesEnabled;
+		bool Success;
+		uint32_t Stamp;
+		uint32_t TransferZonesGeneration;
+		C4Rect Footprint; // in regions
+		std::vector<CachedWaypoint> Waypoints;
+	};
+
 protected:
 	bool(*PointFree)(int32_t, int32_t);
 	// iToX and iToY are intptr_t because there are stored object
 	// pointers sometimes
 	bool(*SetWaypoint)(int32_t, int32_t, intptr_t, intptr_t);
 	C4PathFinderRay *FirstRay;
+	C4PathFinderRay *FreeRays; // cleared rays kept for reuse by AddRay and SplitRay
 	intptr_t WaypointParameter;
 	bool Success;
 	C4TransferZones *TransferZones;
 	bool TransferZonesEnabled;
 	int Level;
 
+	// Path cache
+	std::vector<CachedPath> Cache;
+	size_t CacheReplace;
+	std::vector<uint32_t> RegionStamps;
+	int32_t RegionsWdt, RegionsHgt;
+	uint32_t ChangeStamp;
+	int32_t FootprintX1, FootprintY1, FootprintX2, FootprintY2; // probed landscape bounds of the current search
+	CachedPath *Recording;
+
 public:
 	void Draw(C4FacetEx &cgo);
 	void Clear();
@@ -88,8 +129,23 @@ public:
 	bool Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, bool(*fnSetWaypoint)(int32_t, int32_t, intptr_t, intptr_t), intptr_t iWaypointParameter);
 	void EnableTransferZones(bool fEnabled);
 	void SetLevel(int iLevel);
+	void ClearCache();
+
+	// must be called for every change of landscape density
+	void NotifyLandscapeChange(int32_t iX, int32_t iY)
+	{
+		const auto index = static_cast<size_t>((iY >> RegionShift) * RegionsWdt + (iX >> RegionShift));
+		if (index < RegionStamps.size()) RegionStamps[index] = ChangeStamp;
+	}
+	void NotifyLandscapeChange(const C4Rect &rect);
 
 protected:
+	bool ProbePoint(int32_t iX, int32_t iY);
+	void AddFootprint(const C4Rect &rect);
+	void SetWaypointAndRecord(int32_t iX, int32_t iY, intptr_t iTransferObject);
+	CachedPath *FindCached(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY);
+	C4PathFinderRay *NewRay();
+	void ClearRays();
 	void Run();
 	bool AddRay(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, int32_t iDepth, int32_t iDirection, C4PathFinderRay *pFrom, C4TransferZone *pUseZone = nullptr);
 	bool SplitRay(C4PathFinderRay *pRay, int32_t iAtX, int32_t iAtY);
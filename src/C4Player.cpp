@@ -74,6 +74,7 @@ void C4Player::ClearPointers(C4Object *pObj, bool fDeath)
 	// no clear when death to do normal decay
 	if (!fDeath)
 		while (FoWViewObjs.Remove(pObj));
+	FoWGridFrame = -1;
 	// Menu
 	Menu.ClearPointers(pObj);
 	// messageboard-queries
@@ -1035,6 +1036,7 @@ void C4Player::Clear()
 	BigIcon.Clear();
 	fFogOfWar = false; bForceFogOfWar = false;
 	FoWViewObjs.Clear();
+	FoWGrid.clear(); FoWGridFrame = -1;
 	fFogOfWarInitialized = false;
 	while (pMsgBoardQuery)
 	{
@@ -1064,6 +1066,7 @@ void C4Player::Default()
 	fFogOfWar = false; fFogOfWarInitialized = false;
 	bForceFogOfWar = false;
 	FoWViewObjs.Default();
+	FoWGridWdt = FoWGridHgt = 0; FoWGridFrame = -1;
 	LeagueEvaluated = false;
 	GameJoinTime = 0; // overwritten in Init
 	pstatControls = pstatActions = nullptr;
@@ -1949,39 +1952,86 @@ void C4Player::FoWGenerators2Map(CClrModAddMap &rMap, int iOffX, int iOffY)
 				rMap.AddModulation(cobj->x + iOffX, cobj->y + iOffY, -cobj->PlrViewRange, -cobj->PlrViewRange + 200, cobj->ColorMod >> 24);
 }
 
+// size of the cells of C4Player::FoWGrid
+static constexpr int32_t C4FoWGridRes = 256;
+
+// FoW effect of a view object at a point: -1 if shadowed by a generator, 1 if made visible by a repeller, 0 if none
+static int32_t FoWViewAt(C4Object *cobj, int32_t iRange, int32_t x, int32_t y)
+{
+	if (!cobj->Contained || cobj->Contained->Def->ClosedContainer != 1)
+		if (Distance(cobj->x, cobj->y, x, y) < Abs(iRange))
+			if (iRange < 0)
+			{
+				if (!(cobj->ColorMod & 0xff000000)) // faded generators generate darkness only; no FoW blocking
+					return -1; // shadowed by FoW-generator
+			}
+			else
+				return 1; // made visible by FoW-repeller
+	return 0;
+}
+
+void C4Player::UpdateFoWGrid()
+{
+	// view objects only move during game ticks
+	if (FoWGridFrame == Game.FrameCounter) return;
+	FoWGridFrame = Game.FrameCounter;
+	FoWGridWdt = std::max<int32_t>(1, (GBackWdt + C4FoWGridRes - 1) / C4FoWGridRes);
+	FoWGridHgt = std::max<int32_t>(1, (GBackHgt + C4FoWGridRes - 1) / C4FoWGridRes);
+	FoWGrid.resize(FoWGridWdt * FoWGridHgt);
+	for (auto &Cell : FoWGrid) Cell.clear();
+	// add every view object to all cells within its range; positions outside the landscape go to the border cells
+	C4Object *cobj; C4ObjectLink *clnk;
+	for (clnk = FoWViewObjs.First; clnk && (cobj = clnk->Obj); clnk = clnk->Next)
+		if (const int32_t iRange = Abs(cobj->PlrViewRange))
+		{
+			const int32_t x0 = BoundBy<int32_t>((cobj->x - iRange) / C4FoWGridRes, 0, FoWGridWdt - 1);
+			const int32_t x1 = BoundBy<int32_t>((cobj->x + iRange) / C4FoWGridRes, 0, FoWGridWdt - 1);
+			const int32_t y0 = BoundBy<int32_t>((cobj->y - iRange) / C4FoWGridRes, 0, FoWGridHgt - 1);
+			const int32_t y1 = BoundBy<int32_t>((cobj->y + iRange) / C4FoWGridRes, 0, FoWGridHgt - 1);
+			for (int32_t cy = y0; cy <= y1; ++cy)
+				for (int32_t cx = x0; cx <= x1; ++cx)
+					FoWGrid[cy * FoWGridWdt + cx].push_back(cobj);
+		}
+}
+
 bool C4Player::FoWIsVisible(int32_t x, int32_t y)
 {
 	// check repellers and generators and ViewTarget
 	bool fSeen = false;
-	C4Object *cobj = nullptr; C4ObjectLink *clnk;
-	clnk = FoWViewObjs.First;
-	int32_t iRange;
-	for (;;)
+	C4Object *cobj; C4ObjectLink *clnk;
+	// objects may be moved around while the game is halted, so the grid is only used while it runs
+	if (Game.HaltCount)
 	{
-		if (clnk)
-		{
-			cobj = clnk->Obj;
-			clnk = clnk->Next;
-			iRange = cobj->PlrViewRange;
-		}
-		else if (ViewMode != C4PVM_Target || !ViewTarget || ViewTarget == cobj)
-			break;
-		else
+		for (clnk = FoWViewObjs.First; clnk && (cobj = clnk->Obj); clnk = clnk->Next)
+			switch (FoWViewAt(cobj, cobj->PlrViewRange, x, y))
+			{
+			case -1: return false;
+			case 1: fSeen = true; break;
+			}
+	}
+	else
+	{
+		UpdateFoWGrid();
+		const int32_t cx = BoundBy<int32_t>(x / C4FoWGridRes, 0, FoWGridWdt - 1);
+		const int32_t cy = BoundBy<int32_t>(y / C4FoWGridRes, 0, FoWGridHgt - 1);
+		for (C4Object *pObj : FoWGrid[cy * FoWGridWdt + cx])
+			switch (FoWViewAt(pObj, pObj->PlrViewRange, x, y))
+			{
+			case -1: return false;
+			case 1: fSeen = true; break;
+			}
+	}
+	// the view target is checked last unless it already was
+	if (ViewMode == C4PVM_Target && ViewTarget && (!FoWViewObjs.Last || ViewTarget != FoWViewObjs.Last->Obj))
+	{
+		int32_t iRange = ViewTarget->PlrViewRange;
+		if (!iRange && Cursor) iRange = Cursor->PlrViewRange;
+		if (!iRange) iRange = C4FOW_Def_View_RangeX;
+		switch (FoWViewAt(ViewTarget, iRange, x, y))
 		{
-			cobj = ViewTarget;
-			iRange = cobj->PlrViewRange;
-			if (!iRange && Cursor) iRange = Cursor->PlrViewRange;
-			if (!iRange) iRange = C4FOW_Def_View_RangeX;
+		case -1: return false;
+		case 1: fSeen = true; break;
 		}
-		if (!cobj->Contained || cobj->Contained->Def->ClosedContainer != 1)
-			if (Distance(cobj->x, cobj->y, x, y) < Abs(iRange))
-				if (iRange < 0)
-				{
-					if (!(cobj->ColorMod & 0xff000000)) // faded generators generate darkness only; no FoW blocking
-						return false; // shadowed by FoW-generator
-				}
-				else
-					fSeen = true; // made visible by FoW-repeller
 	}
 	return fSeen;
 }
@@ -24,6 +24,8 @@
 #include <C4InfoCore.h>
 #include <C4ObjectList.h>
 
+#include <vector>
+
 const int32_t C4PVM_Cursor    = 0,
               C4PVM_Target    = 1,
               C4PVM_Scrolling = 2;
@@ -95,6 +97,9 @@ public:
 	bool bForceFogOfWar;
 	bool fFogOfWarInitialized; // No Save //
 	C4ObjectList FoWViewObjs; // No Save //
+	std::vector<std::vector<C4Object *>> FoWGrid; // No Save // FoWViewObjs by the landscape cells their range overlaps
+	int32_t FoWGridWdt, FoWGridHgt; // No Save //
+	int32_t FoWGridFrame; // No Save // frame FoWGrid was built in; -1 if outdated
 	// Game
 	int32_t Wealth, Points;
 	int32_t Value, InitialValue, ValueGain;
@@ -233,6 +238,11 @@ public:
 	void FoWGenerators2Map(CClrModAddMap &rMap, int iOffX, int iOffY);
 	bool FoWIsVisible(int32_t x, int32_t y); // check whether a point in the landscape is visible
 
+protected:
+	void UpdateFoWGrid();
+
+public:
+
 	// runtime statistics
 	void CreateGraphs();
 	void ClearGraphs();
@@ -40,3 +40,18 @@ int Rnd3()
 #endif
 	return FRndBuf3[FRndPtr3];
 }
+
+void GetRandomState(uint32_t &dwHold, int32_t &iCount, int32_t &iPtr3)
+{
+	dwHold = RandomHold;
+	iCount = RandomCount;
+	iPtr3 = FRndPtr3;
+}
+
+void SetRandomState(uint32_t dwHold, int32_t iCount, int32_t iPtr3)
+{
+	// the Random3 buffer only depends on the random seed, so the pointer is enough
+	RandomHold = dwHold;
+	RandomCount = iCount;
+	FRndPtr3 = iPtr3;
+}
@@ -68,6 +68,13 @@ inline unsigned int SeededRandom(unsigned int iSeed, unsigned int iRange)
 	return (iSeed >> 16) % iRange;
 }
 
+// platform independent hash combination for sync checks
+inline void SyncHashAdd(uint32_t &dwHash, uint32_t dwValue)
+{
+	dwHash = (dwHash ^ dwValue) * 0x01000193u;
+	dwHash ^= dwHash >> 13;
+}
+
 inline int SafeRandom(int range)
 {
 	if (!range) return 0;
@@ -76,3 +83,7 @@ inline int SafeRandom(int range)
 
 void Randomize3();
 int Rnd3();
+
+// for record keyframes, which continue the random sequence
+void GetRandomState(uint32_t &dwHold, int32_t &iCount, int32_t &iPtr3);
+void SetRandomState(uint32_t dwHold, int32_t iCount, int32_t iPtr3);
@@ -26,9 +26,18 @@
 #include <C4Log.h>
 #include <C4Wrappers.h>
 #include <C4Player.h>
+#include <C4Random.h>
 
 #include <StdFile.h>
 
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <zlib.h>
+
 #define IMMEDIATEREC
 
 //#define DEBUGREC_EXTFILE "DbgRec.c4b" // if defined, an external file is used for debugrec writing (replays only)
@@ -77,6 +86,269 @@ void C4PktDebugRec::CompileFunc(StdCompiler *pComp)
 	pComp->Value(mkNamingAdapt(Data,              "Data"));
 }
 
+C4DebugRecTypeMask GetDebugRecTypeMask(const char *szTypes)
+{
+	C4DebugRecTypeMask Mask;
+	if (!szTypes || !*szTypes) return Mask.set();
+	char szType[C4MaxName + 1];
+	for (size_t i = 0; SCopySegment(szTypes, i, szType, ';', C4MaxName, true); ++i)
+		for (int iType = RCT_DbgFrame; iType < RCT_Undefined; ++iType)
+			if (SEqualNoCase(szType, GetRecordChunkTypeName(static_cast<C4RecordChunkType>(iType))))
+				Mask.set(iType & 0x7f);
+	return Mask;
+}
+
+// variable-length integers in the same layout as mkIntPackAdapt
+static void AppendVarInt(std::vector<uint8_t> &rData, uint32_t iVal)
+{
+	for (; iVal >= 0x80; iVal >>= 7)
+		rData.push_back(static_cast<uint8_t>(iVal | 0x80));
+	rData.push_back(static_cast<uint8_t>(iVal));
+}
+
+static bool ReadVarInt(const uint8_t *&pPos, const uint8_t *pEnd, uint32_t &rVal)
+{
+	rVal = 0;
+	for (int iShift = 0; iShift < 35; iShift += 7)
+	{
+		if (pPos == pEnd) return false;
+		const uint8_t iByte = *pPos++;
+		rVal |= static_cast<uint32_t>(iByte & 0x7f) << iShift;
+		if (!(iByte & 0x80)) return true;
+	}
+	return false;
+}
+
+// signed differences are interleaved, so small negative ones are small, too
+static uint32_t ZigZag(uint32_t iDiff) { return (iDiff << 1) ^ (0u - (iDiff >> 31)); }
+static uint32_t UnZigZag(uint32_t iVal) { return (iVal >> 1) ^ (0u - (iVal & 1)); }
+
+static uint32_t GetWord(const uint8_t *pData)
+{
+	uint32_t iWord;
+	std::memcpy(&iWord, pData, sizeof(iWord));
+	return iWord;
+}
+
+void C4RecordDebugPacker::Add(uint32_t iAtFrame, C4RecordChunkType eType, const void *pData, size_t iSize)
+{
+	if (Data.empty()) iFrame = iAtFrame;
+	assert(iFrame == iAtFrame);
+	const size_t iType = eType & 0x7f;
+	const auto *pBytes = static_cast<const uint8_t *>(pData);
+	Data.push_back(static_cast<uint8_t>(eType));
+	AppendVarInt(Data, static_cast<uint32_t>(iSize));
+	// whole words as difference to the previous record of this type
+	const uint8_t *pLast = Records.data() + LastRecordPos[iType];
+	const size_t iLastSize = LastRecordSize[iType];
+	size_t i = 0;
+	for (; i + sizeof(uint32_t) <= iSize; i += sizeof(uint32_t))
+	{
+		const uint32_t iLast = i + sizeof(uint32_t) <= iLastSize ? GetWord(pLast + i) : 0;
+		AppendVarInt(Data, ZigZag(GetWord(pBytes + i) - iLast));
+	}
+	// remaining bytes as they are
+	if (i < iSize) Data.insert(Data.end(), pBytes + i, pBytes + iSize);
+	// base for the next record of this type
+	LastRecordPos[iType] = Records.size();
+	LastRecordSize[iType] = iSize;
+	if (iSize) Records.insert(Records.end(), pBytes, pBytes + iSize);
+}
+
+void C4RecordDebugPacker::Clear()
+{
+	Data.clear();
+	Records.clear();
+	LastRecordPos.fill(0);
+	LastRecordSize.fill(0);
+}
+
+bool C4RecordDebugPacker::Compress(const StdBuf &Raw, StdBuf &rPacked)
+{
+	uLongf iPackedSize = compressBound(static_cast<uLong>(Raw.getSize()));
+	StdBuf Packed; Packed.New(iPackedSize);
+	if (compress2(reinterpret_cast<Bytef *>(Packed.getMData()), &iPackedSize, reinterpret_cast<const Bytef *>(Raw.getData()), static_cast<uLong>(Raw.getSize()), Z_DEFAULT_COMPRESSION) != Z_OK)
+		return false;
+	Packed.SetSize(iPackedSize);
+	auto iRawSize = static_cast<uint32_t>(Raw.getSize());
+	rPacked = DecompileToBuf<StdCompilerBinWrite>(mkInsertAdapt(iRawSize, Packed, false));
+	return true;
+}
+
+bool C4RecordDebugPacker::Unpack(const StdBuf &Packed, size_t iRawSize, std::vector<std::unique_ptr<C4PktDebugRec>> &rRecords)
+{
+	if (!iRawSize) return true;
+	StdBuf Raw; Raw.New(iRawSize);
+	uLongf iSize = static_cast<uLongf>(iRawSize);
+	if (uncompress(reinterpret_cast<Bytef *>(Raw.getMData()), &iSize, reinterpret_cast<const Bytef *>(Packed.getData()), static_cast<uLong>(Packed.getSize())) != Z_OK || iSize != iRawSize)
+		return false;
+	return Decode(Raw, rRecords);
+}
+
+bool C4RecordDebugPacker::Decode(const StdBuf &Raw, std::vector<std::unique_ptr<C4PktDebugRec>> &rRecords)
+{
+	std::array<const C4PktDebugRec *, 0x80> LastRecord{};
+	const auto *pPos = static_cast<const uint8_t *>(Raw.getData()), *pEnd = pPos + Raw.getSize();
+	while (pPos != pEnd)
+	{
+		const auto eType = static_cast<C4RecordChunkType>(*pPos++);
+		uint32_t iRecSize;
+		if (!ReadVarInt(pPos, pEnd, iRecSize)) return false;
+		StdBuf Data; Data.New(iRecSize);
+		auto *pData = reinterpret_cast<uint8_t *>(Data.getMData());
+		const C4PktDebugRec *pLast = LastRecord[eType & 0x7f];
+		const size_t iLastSize = pLast ? pLast->getSize() : 0;
+		size_t i = 0;
+		for (; i + sizeof(uint32_t) <= iRecSize; i += sizeof(uint32_t))
+		{
+			uint32_t iDiff;
+			if (!ReadVarInt(pPos, pEnd, iDiff)) return false;
+			const uint32_t iLast = i + sizeof(uint32_t) <= iLastSize ? GetWord(static_cast<const uint8_t *>(pLast->getData()) + i) : 0;
+			const uint32_t iWord = iLast + UnZigZag(iDiff);
+			std::memcpy(pData + i, &iWord, sizeof(iWord));
+		}
+		if (static_cast<size_t>(pEnd - pPos) < iRecSize - i) return false;
+		if (i < iRecSize) std::memcpy(pData + i, pPos, iRecSize - i);
+		pPos += iRecSize - i;
+		rRecords.push_back(std::make_unique<C4PktDebugRec>(eType, Data));
+		LastRecord[eType & 0x7f] = rRecords.back().get();
+	}
+	return true;
+}
+
+size_t C4RecordDebugPacker::GetUnpackedRecordSize(size_t iSize)
+{
+	// chunk head, type and size of C4PktDebugRec
+	size_t iSizeBytes = 1;
+	for (size_t iVal = iSize; iVal >= 0x80; iVal >>= 7) ++iSizeBytes;
+	return sizeof(C4RecordChunkHead) + sizeof(int32_t) + iSizeBytes + iSize;
+}
+
+// Writes control record chunks on a separate thread, compressing debug record blocks on the way,
+// so neither compression nor disk latency stall the simulation of DEBUGREC builds.
+class C4RecordWriter
+{
+public:
+	C4RecordWriter(CStdFile &File) : File(File), Thread(&C4RecordWriter::Execute, this) {}
+	~C4RecordWriter(); // writes all pending chunks
+
+	void Write(StdBuf &&Chunk, bool fPack, bool fFrameStart); // fPack: data after the chunk head is a raw debug record block
+	void Flush(); // wait until all pending chunks are written
+
+	// only valid after Flush
+	uint32_t GetSize() const { return iSize; }
+	uint32_t GetFrameStartPos() const { return iFrameStartPos; }
+	uint32_t GetPackedSize() const { return iPackedSize; }
+	uint32_t GetPackFailures() const { return iPackFailures; }
+
+private:
+	static constexpr size_t MaxPending = 256; // chunks after which the simulation waits for the writer
+
+	struct Chunk
+	{
+		StdBuf Data;
+		bool fPack, fFrameStart;
+	};
+
+	CStdFile &File;
+	std::mutex Mutex;
+	std::condition_variable PendingCond, DoneCond;
+	std::deque<Chunk> Pending;
+	bool fBusy{false}, fStop{false};
+	uint32_t iSize{0}; // bytes written
+	uint32_t iFrameStartPos{0}; // position of the last chunk that started a frame
+	uint32_t iPackedSize{0}; // bytes of debug record blocks written
+	uint32_t iPackFailures{0}; // debug record blocks written as single chunks, because they could not be compressed
+	std::thread Thread;
+
+	void Execute();
+};
+
+C4RecordWriter::~C4RecordWriter()
+{
+	{
+		const std::lock_guard lock{Mutex};
+		fStop = true;
+	}
+	PendingCond.notify_one();
+	Thread.join();
+}
+
+void C4RecordWriter::Write(StdBuf &&Chunk, bool fPack, bool fFrameStart)
+{
+	{
+		std::unique_lock lock{Mutex};
+		DoneCond.wait(lock, [this] { return Pending.size() < MaxPending; });
+		Pending.push_back({std::move(Chunk), fPack, fFrameStart});
+	}
+	PendingCond.notify_one();
+}
+
+void C4RecordWriter::Flush()
+{
+	std::unique_lock lock{Mutex};
+	DoneCond.wait(lock, [this] { return Pending.empty() && !fBusy; });
+}
+
+void C4RecordWriter::Execute()
+{
+	std::unique_lock lock{Mutex};
+	for (;;)
+	{
+		if (Pending.empty())
+		{
+			if (fStop) break;
+			PendingCond.wait(lock);
+			continue;
+		}
+		// write everything that has piled up and flush once
+		std::deque<Chunk> Chunks;
+		Chunks.swap(Pending);
+		fBusy = true;
+		lock.unlock();
+		DoneCond.notify_all();
+		for (auto &chunk : Chunks)
+		{
+			if (chunk.fPack)
+			{
+				const StdBuf Raw = chunk.Data.getPart(sizeof(C4RecordChunkHead), chunk.Data.getSize() - sizeof(C4RecordChunkHead));
+				StdBuf Packed;
+				if (C4RecordDebugPacker::Compress(Raw, Packed))
+				{
+					chunk.Data.SetSize(sizeof(C4RecordChunkHead));
+					chunk.Data.Append(Packed);
+				}
+				else
+				{
+					// don't lose the records: write them as single chunks of the same frame
+					++iPackFailures;
+					std::vector<std::unique_ptr<C4PktDebugRec>> Records;
+					C4RecordDebugPacker::Decode(Raw, Records);
+					C4RecordChunkHead Head;
+					std::memcpy(&Head, chunk.Data.getData(), sizeof(Head));
+					StdBuf Chunks;
+					for (const auto &pRecord : Records)
+					{
+						Head.Type = static_cast<uint8_t>(pRecord->getType());
+						Chunks.Append(&Head, sizeof(Head));
+						Chunks.Append(DecompileToBuf<StdCompilerBinWrite>(*pRecord));
+						Head.iFrm = 0;
+					}
+					chunk.Data = std::move(Chunks);
+				}
+				iPackedSize += chunk.Data.getSize();
+			}
+			if (chunk.fFrameStart) iFrameStartPos = iSize;
+			File.Write(chunk.Data.getData(), chunk.Data.getSize());
+			iSize += chunk.Data.getSize();
+		}
+		File.Flush();
+		lock.lock();
+		fBusy = false;
+		DoneCond.notify_all();
+	}
+}
+
 C4RecordChunk::C4RecordChunk()
 	: pCtrl(nullptr) {}
 
@@ -108,8 +380,20 @@ void C4RecordChunk::CompileFunc(StdCompiler *pComp)
 	}
 }
 
+void C4RecordKeyframe::CompileFunc(StdCompiler *pComp)
+{
+	pComp->Value(mkNamingAdapt(Frame,     "Frame",     0));
+	pComp->Value(mkNamingAdapt(Offset,    "Offset",    0u));
+	pComp->Value(mkNamingAdapt(BaseFrame, "BaseFrame", 0));
+	pComp->Value(mkNamingAdapt(Filename,  "Filename",  ""));
+	pComp->Value(mkNamingAdapt(ContinueRandom, "ContinueRandom", false));
+	pComp->Value(mkNamingAdapt(RandomHold,     "RandomHold",     0u));
+	pComp->Value(mkNamingAdapt(RandomCount,    "RandomCount",    0));
+	pComp->Value(mkNamingAdapt(Random3Ptr,     "Random3Ptr",     0));
+}
+
 C4Record::C4Record()
-	: fRecording(false), fStreaming(false) {}
+	: fRecording(false), iKeyframeInterval(0), fKeyframeRequested(false), fStreaming(false) {}
 
 C4Record::~C4Record() {}
 
@@ -161,6 +445,10 @@ bool C4Record::Start(bool fInitial)
 	char szCtrlRecFilename[_MAX_PATH + 1 + _MAX_FNAME];
 	sprintf(szCtrlRecFilename, "%s" DirSep C4CFN_CtrlRec, sFilename.getData());
 	if (!CtrlRec.Create(szCtrlRecFilename)) return false;
+#ifdef DEBUGREC
+	// debug records are plenty: compress and write them on a separate thread
+	Writer = std::make_unique<C4RecordWriter>(CtrlRec);
+#endif
 
 	// open record group
 	if (!RecordGrp.Open(sFilename.getData()))
@@ -170,6 +458,16 @@ bool C4Record::Start(bool fInitial)
 	fStreaming = false;
 	fRecording = true;
 	iLastFrame = 0;
+	iCtrlRecSize = iFramePos = iFrameBaseFrame = 0;
+	iPosFrame = -1;
+	DebugRecPacker.Clear();
+	iDebugRecCount = iDebugRecUnpackedSize = iDebugRecPackedSize = iDebugRecPackFailures = 0;
+	iStartTime = timeGetTime();
+	// keyframes
+	iKeyframeInterval = std::max<int32_t>(Config.General.RecordKeyframeInterval, 0);
+	iLastKeyframe = Game.FrameCounter;
+	fKeyframeRequested = false;
+	Keyframes.clear();
 	return true;
 }
 
@@ -179,6 +477,24 @@ bool C4Record::Stop(StdStrBuf *pRecordName, uint8_t *pRecordSHA1)
 	if (!fRecording) return false;
 	if (!DirectoryExists(sFilename.getData())) return false;
 
+	// write pending chunks; while streaming, so the debug records of the last frame are sent as well
+	FlushDebugRec();
+	if (Writer)
+	{
+		Writer->Flush();
+		iDebugRecPackedSize += Writer->GetPackedSize();
+		iDebugRecPackFailures += Writer->GetPackFailures();
+		Writer.reset();
+	}
+	if (iDebugRecCount)
+	{
+		const uint32_t iTime = std::max<uint32_t>(timeGetTime() - iStartTime, 1);
+		LogSilentF("Record: %u debug records (%u/s), %u KB packed, %u KB as single chunks",
+			iDebugRecCount, static_cast<uint32_t>(uint64_t{iDebugRecCount} * 1000 / iTime), iDebugRecPackedSize / 1024, iDebugRecUnpackedSize / 1024);
+	}
+	if (iDebugRecPackFailures)
+		LogF("Record: %u debug record blocks could not be compressed and were written as single chunks", iDebugRecPackFailures);
+
 	// streaming finished
 	StopStreaming();
 
@@ -240,28 +556,108 @@ bool C4Record::Rec(C4PacketType eCtrlType, C4ControlPacket *pCtrl, int iFrame)
 }
 
 bool C4Record::Rec(uint32_t iFrame, const StdBuf &sBuf, C4RecordChunkType eType)
+{
+	// debug records that happened before go first
+	FlushDebugRec();
+	return WriteChunk(iFrame, sBuf, eType);
+}
+
+void C4Record::RecDebug(uint32_t iFrame, C4RecordChunkType eType, const void *pData, size_t iSize)
+{
+	if (!fRecording) return;
+	// one block per frame, so the frame difference of the chunk applies to all of its records
+	if (!DebugRecPacker.IsEmpty() && (DebugRecPacker.GetFrame() != iFrame || DebugRecPacker.GetSize() >= C4RecordDebugPacker::MaxBlockSize))
+		FlushDebugRec();
+	DebugRecPacker.Add(iFrame, eType, pData, iSize);
+	++iDebugRecCount;
+	iDebugRecUnpackedSize += C4RecordDebugPacker::GetUnpackedRecordSize(iSize);
+}
+
+void C4Record::FlushDebugRec()
+{
+	if (DebugRecPacker.IsEmpty()) return;
+	const uint32_t iFrame = DebugRecPacker.GetFrame();
+	const StdBuf Block = DebugRecPacker.GetData();
+	DebugRecPacker.Clear();
+	WriteChunk(iFrame, Block, RCT_DbgPack);
+}
+
+bool C4Record::WriteDebugRecChunks(uint32_t iFrame, const StdBuf &Block)
+{
+	std::vector<std::unique_ptr<C4PktDebugRec>> Records;
+	if (!C4RecordDebugPacker::Decode(Block, Records)) return false;
+	for (const auto &pRecord : Records)
+		if (!WriteChunk(iFrame, DecompileToBuf<StdCompilerBinWrite>(*pRecord), pRecord->getType()))
+			return false;
+	return true;
+}
+
+bool C4Record::WriteChunk(uint32_t iFrame, const StdBuf &sBuf, C4RecordChunkType eType)
 {
 	// filler chunks (this should never be necessary, though)
 	while (iFrame > iLastFrame + 0xff)
-		Rec(iLastFrame + 0xff, StdBuf(), RCT_Frame);
+		WriteChunk(iLastFrame + 0xff, StdBuf(), RCT_Frame);
+	// debug record blocks are compressed by the writer, unless they need to be streamed right away
+	const bool fPack = eType == RCT_DbgPack;
+	StdBuf Data;
+	if (fPack && (!Writer || fStreaming))
+	{
+		if (!C4RecordDebugPacker::Compress(sBuf, Data))
+		{
+			// don't lose the records: write them as single chunks instead
+			++iDebugRecPackFailures;
+			return WriteDebugRecChunks(iFrame, sBuf);
+		}
+		iDebugRecPackedSize += sizeof(C4RecordChunkHead) + Data.getSize();
+	}
+	else
+		Data.Ref(sBuf);
+	// remember where the chunks of this frame start (for keyframes)
+	bool fFrameStart = false;
+	if (static_cast<int32_t>(iFrame) != iPosFrame)
+	{
+		iPosFrame = iFrame;
+		iFramePos = iCtrlRecSize;
+		iFrameBaseFrame = iLastFrame;
+		fFrameStart = true;
+	}
 	// get frame difference
 	const uint32_t iFrameDiff = iLastFrame > iFrame ? 0 : iFrame - iLastFrame;
 	iLastFrame += iFrameDiff;
 	// create head
 	C4RecordChunkHead Head = { static_cast<uint8_t>(iFrameDiff), static_cast<uint8_t>(eType) };
 	// pack
-	CtrlRec.Write(&Head, sizeof(Head));
-	CtrlRec.Write(sBuf.getData(), sBuf.getSize());
+	if (Writer)
+	{
+		StdBuf Chunk(&Head, sizeof(Head));
+		Chunk.Append(Data);
+		Writer->Write(std::move(Chunk), fPack && !fStreaming, fFrameStart);
+	}
+	else
+	{
+		CtrlRec.Write(&Head, sizeof(Head));
+		CtrlRec.Write(Data.getData(), Data.getSize());
+		iCtrlRecSize += sizeof(Head) + Data.getSize();
 #ifdef IMMEDIATEREC
-	// immediate rec: always flush
-	CtrlRec.Flush();
+		// immediate rec: always flush
+		CtrlRec.Flush();
 #endif
+	}
 	// Stream
 	if (fStreaming)
-		Stream(Head, sBuf);
+		Stream(Head, Data);
 	return true;
 }
 
+void C4Record::SyncWriter()
+{
+	if (!Writer) return;
+	// file positions are only known to the writer
+	Writer->Flush();
+	iCtrlRecSize = Writer->GetSize();
+	iFramePos = Writer->GetFrameStartPos();
+}
+
 void C4Record::Stream(const C4RecordChunkHead &Head, const StdBuf &sBuf)
 {
 	if (!fStreaming) return;
@@ -313,6 +709,56 @@ bool C4Record::AddFile(const char *szLocalFilename, const char *szAddAs, bool fD
 	return true;
 }
 
+void C4Record::SkipKeyframe()
+{
+	fKeyframeRequested = false;
+	iLastKeyframe = std::max(iLastKeyframe, Game.FrameCounter + C4RecordKeyframeRetryDelay - iKeyframeInterval);
+}
+
+bool C4Record::SaveKeyframe()
+{
+	if (!fRecording) return false;
+	fKeyframeRequested = false;
+	iLastKeyframe = Game.FrameCounter;
+	FlushDebugRec();
+	SyncWriter();
+	// the control of the current frame has already been recorded and
+	// will be executed again when starting from the keyframe (like for runtime records)
+	C4RecordKeyframe Keyframe;
+	Keyframe.Frame = Game.FrameCounter;
+	if (iPosFrame == Game.FrameCounter)
+	{
+		Keyframe.Offset = iFramePos;
+		Keyframe.BaseFrame = iFrameBaseFrame;
+	}
+	else
+	{
+		Keyframe.Offset = iCtrlRecSize;
+		Keyframe.BaseFrame = iLastFrame;
+	}
+	Keyframe.Filename.Format(C4CFN_RecKeyframe, Game.FrameCounter);
+	// keyframe synchronizations don't reset the random sequence, so playback has to continue it
+	Keyframe.ContinueRandom = true;
+	GetRandomState(Keyframe.RandomHold, Keyframe.RandomCount, Keyframe.Random3Ptr);
+	// save game into record folder
+	C4GameSaveRecord saveRec(false, Index, Game.Parameters.isLeague());
+	if (!saveRec.Save(FormatString("%s" DirSep "%s", sFilename.getData(), Keyframe.Filename.getData()).getData()))
+	{
+		LogF("Record: Could not save keyframe at frame %d!", Game.FrameCounter);
+		return false;
+	}
+	saveRec.Close();
+	Keyframes.push_back(std::move(Keyframe));
+	// update index, so keyframes are usable even if the record isn't stopped properly
+	return SaveKeyframeIndex();
+}
+
+bool C4Record::SaveKeyframeIndex()
+{
+	StdStrBuf Buf = DecompileToBuf<StdCompilerINIWrite>(mkNamingAdapt(mkSTLContainerAdapt(Keyframes), "Keyframe"));
+	return Buf.SaveToFile(FormatString("%s" DirSep C4CFN_RecKeyframes, sFilename.getData()).getData());
+}
+
 bool C4Record::StartStreaming(bool fInitial)
 {
 	if (!fRecording) return false;
@@ -376,7 +822,7 @@ bool C4Record::StreamFile(const char *szLocalFilename, const char *szAddAs)
 }
 
 // set defaults
-C4Playback::C4Playback() : Finished(true), fLoadSequential(false) {}
+C4Playback::C4Playback() : Finished(true), iPlaybackGroupRemaining(0), fLoadSequential(false) {}
 
 C4Playback::~C4Playback()
 {
@@ -399,15 +845,24 @@ bool C4Playback::Open(C4Group &rGrp)
 	}
 	else
 	{
-		// open group? Then do some sequential reading for large files
+		// Do some sequential reading, so large records don't need to be held in memory
 		// Can't do this when a dump is forced, because the dump needs all data
 		// Also can't do this when stripping is desired
-		if (!rGrp.IsPacked()) if (!Game.RecordDumpFile.getLength()) if (!fStrip) fLoadSequential = true;
+		if (!Game.RecordDumpFile.getLength()) if (!fStrip) fLoadSequential = true;
 		// get record file
 		if (fLoadSequential)
 		{
-			if (!rGrp.FindEntry(C4CFN_CtrlRec)) return false;
-			if (!playbackFile.Open(FormatString("%s%c%s", rGrp.GetFullName().getData(), DirectorySeparator, C4CFN_CtrlRec).getData())) return false;
+			// no control data: might be a keyframe savegame of a record
+			if (!rGrp.FindEntry(C4CFN_CtrlRec))
+			{
+				if (!OpenKeyframe(rGrp))
+				{
+					LogFatal("Record: No control data found!");
+					return false;
+				}
+			}
+			else if (!OpenSequential(rGrp))
+				return false;
 			// forcing first chunk to be read; will call ReadBinary
 			currChunk = chunks.end();
 			if (!NextSequentialChunk())
@@ -468,6 +923,71 @@ bool C4Playback::Open(C4Group &rGrp)
 	return true;
 }
 
+bool C4Playback::OpenSequential(C4Group &rGrp, uint32_t iOffset, int32_t iBaseFrame)
+{
+	iLastSequentialFrame = iBaseFrame;
+	if (!rGrp.IsPacked())
+	{
+		// folder: read file directly
+		if (!playbackFile.Open(FormatString("%s%c%s", rGrp.GetFullName().getData(), DirectorySeparator, C4CFN_CtrlRec).getData())) return false;
+		return !iOffset || playbackFile.Advance(iOffset);
+	}
+	// packed: read through an own group, so accesses to rGrp during the game don't interfere
+	if (!playbackGroup.Open(rGrp.GetFullName().getData())) return false;
+	if (!playbackGroup.AccessEntry(C4CFN_CtrlRec, &iPlaybackGroupRemaining)) return false;
+	// skip to offset
+	uint8_t SkipBuf[4096];
+	while (iOffset)
+	{
+		size_t iRealSize = 0;
+		if (!ReadSequential(SkipBuf, std::min<size_t>(iOffset, sizeof(SkipBuf)), &iRealSize) || !iRealSize) return false;
+		iOffset -= iRealSize;
+	}
+	return true;
+}
+
+bool C4Playback::OpenKeyframe(C4Group &rGrp)
+{
+	// the keyframe is saved directly inside the record
+	char szRecord[_MAX_PATH + 1];
+	SCopy(rGrp.GetFullName().getData(), szRecord, _MAX_PATH);
+	StdStrBuf sKeyframe; sKeyframe.Copy(GetFilename(szRecord));
+	if (!TruncatePath(szRecord)) return false;
+	C4Group RecordGrp;
+	if (!RecordGrp.Open(szRecord)) return false;
+	C4RecordKeyframeList Keyframes;
+	if (!LoadKeyframes(RecordGrp, Keyframes)) return false;
+	for (const auto &keyframe : Keyframes)
+		if (SEqualNoCase(keyframe.Filename.getData(), sKeyframe.getData()))
+		{
+			LogF("Record: Starting playback at keyframe (frame %d)", static_cast<int>(keyframe.Frame));
+			StartKeyframe = keyframe;
+			return OpenSequential(RecordGrp, keyframe.Offset, keyframe.BaseFrame);
+		}
+	return false;
+}
+
+bool C4Playback::LoadKeyframes(C4Group &rGrp, C4RecordKeyframeList &rKeyframes)
+{
+	StdStrBuf Buf;
+	if (!rGrp.LoadEntryString(C4CFN_RecKeyframes, Buf)) return false;
+	return CompileFromBuf_LogWarn<StdCompilerINIRead>(mkNamingAdapt(mkSTLContainerAdapt(rKeyframes), "Keyframe"), Buf, C4CFN_RecKeyframes);
+}
+
+bool C4Playback::ReadSequential(void *pBuffer, size_t iSize, size_t *ipRealSize)
+{
+	if (!playbackGroup.IsOpen())
+		return playbackFile.Read(pBuffer, iSize, ipRealSize);
+	// do not read beyond the accessed entry
+	iSize = std::min(iSize, iPlaybackGroupRemaining);
+	*ipRealSize = 0;
+	if (!iSize) return true;
+	if (!playbackGroup.Read(pBuffer, iSize)) return false;
+	iPlaybackGroupRemaining -= iSize;
+	*ipRealSize = iSize;
+	return true;
+}
+
 bool C4Playback::ReadBinary(const StdBuf &Buf)
 {
 	// sequential reading: Take over rest from last buffer
@@ -494,6 +1014,7 @@ bool C4Playback::ReadBinary(const StdBuf &Buf)
 		C4RecordChunk c;
 		c.Frame = (iFrame += pHead->iFrm);
 		c.Type = pHead->Type;
+		uint32_t iDbgPackRawSize = 0; StdBuf DbgPack;
 		// Unpack data
 		try
 		{
@@ -517,6 +1038,10 @@ bool C4Playback::ReadBinary(const StdBuf &Buf)
 				Compiler.Value(c.Filename);
 				Compiler.Value(mkPtrAdaptNoNull(c.pFileData));
 				break;
+			case RCT_DbgPack:
+				Compiler.Value(iDbgPackRawSize);
+				Compiler.Value(DbgPack);
+				break;
 			default:
 				// debugrec
 				if (pHead->Type >= 0x80)
@@ -545,6 +1070,16 @@ bool C4Playback::ReadBinary(const StdBuf &Buf)
 			c.Delete();
 			return false;
 		}
+		// debug record block: add the single records instead
+		if (c.Type == RCT_DbgPack)
+		{
+			if (!UnpackDebugRec(c.Frame, DbgPack, iDbgPackRawSize))
+			{
+				LogF("Record: Debug record block at frame %d is corrupt", static_cast<int>(c.Frame));
+				return false;
+			}
+			continue;
+		}
 		// Add to list
 		chunks.push_back(c); c.pPkt = nullptr;
 	} while (!fFinished);
@@ -563,6 +1098,21 @@ bool C4Playback::ReadBinary(const StdBuf &Buf)
 	return true;
 }
 
+bool C4Playback::UnpackDebugRec(int32_t iFrame, const StdBuf &Packed, size_t iRawSize)
+{
+	std::vector<std::unique_ptr<C4PktDebugRec>> Records;
+	if (!C4RecordDebugPacker::Unpack(Packed, iRawSize, Records)) return false;
+	for (auto &pRecord : Records)
+	{
+		C4RecordChunk c;
+		c.Frame = iFrame;
+		c.Type = pRecord->getType();
+		c.pDbg = pRecord.release();
+		chunks.push_back(c);
+	}
+	return true;
+}
+
 bool C4Playback::ReadText(const StdStrBuf &Buf)
 {
 	return CompileFromBuf_LogWarn<StdCompilerINIRead>(mkNamingAdapt(mkSTLContainerAdapt(chunks), "Rec"), Buf, C4CFN_CtrlRecText);
@@ -589,7 +1139,7 @@ bool C4Playback::NextSequentialChunk()
 	for (;;)
 	{
 		iRealSize = 0;
-		playbackFile.Read(BinaryBuf.getMData(), 4096, &iRealSize);
+		ReadSequential(BinaryBuf.getMData(), 4096, &iRealSize);
 		if (!iRealSize) return false;
 		BinaryBuf.SetSize(iRealSize);
 		if (!ReadBinary(BinaryBuf)) return false;
@@ -791,6 +1341,17 @@ void C4Playback::Strip()
 	}
 }
 
+bool C4Playback::RestoreKeyframeRandom()
+{
+	// only once, at the synchronization of the game start
+	if (!StartKeyframe) return false;
+	const bool fContinue = StartKeyframe->ContinueRandom;
+	if (fContinue)
+		SetRandomState(StartKeyframe->RandomHold, StartKeyframe->RandomCount, StartKeyframe->Random3Ptr);
+	StartKeyframe.reset();
+	return fContinue;
+}
+
 bool C4Playback::ExecuteControl(C4Control *pCtrl, int iFrame)
 {
 	// still playbacking?
@@ -864,8 +1425,11 @@ void C4Playback::Clear()
 	for (chunks_t::iterator i = chunks.begin(); i != chunks.end(); i++) i->Delete();
 	chunks.clear(); currChunk = chunks.end();
 	playbackFile.Close();
+	playbackGroup.Close();
+	iPlaybackGroupRemaining = 0;
 	sequentialBuffer.Clear();
 	fLoadSequential = false;
+	StartKeyframe.reset();
 #ifdef DEBUGREC
 	C4IDPacket *pkt;
 	while (pkt = DebugRec.firstPkt()) DebugRec.Delete(pkt);
@@ -887,6 +1451,7 @@ const char *GetRecordChunkTypeName(C4RecordChunkType eType)
 	case RCT_End:     return "End"; // --- the end ---
 	case RCT_Log:     return "Log"; // log message
 	case RCT_File:    return "File"; // file data
+	case RCT_DbgPack: return "DbgPack"; // packed debug records
 	// DEBUGREC
 	case RCT_DbgFrame:   return "DbgFrame";
 	case RCT_Block:      return "Block";      // point in Game::Execute
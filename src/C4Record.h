@@ -26,7 +26,12 @@ class C4Record;
 #include "CStdFile.h"
 #include "Fixed.h"
 
+#include <array>
+#include <bitset>
 #include <list>
+#include <memory>
+#include <optional>
+#include <vector>
 
 #ifdef DEBUGREC
 extern int DoNoDebugRec; // debugrec disable counter in C4Record.cpp
@@ -61,6 +66,8 @@ enum C4RecordChunkType // record file chunk type
 	RCT_Log     = 0x20, // log message
 	// Streaming
 	RCT_File = 0x30, // file data
+	// DEBUGREC, compact
+	RCT_DbgPack = 0x40, // compressed block of debug records of one frame (see C4RecordDebugPacker)
 	// DEBUGREC
 	RCT_DbgFrame   = 0x81,
 	RCT_Block      = 0x82, // point in Game::Execute
@@ -103,6 +110,12 @@ enum C4RecordChunkType // record file chunk type
 void AddDbgRec(C4RecordChunkType eType, const void *pData = nullptr, int iSize = 0); // record debug stuff
 #endif
 
+// debug record types to capture, indexed by the chunk type without its upper bit
+typedef std::bitset<0x80> C4DebugRecTypeMask;
+C4DebugRecTypeMask GetDebugRecTypeMask(const char *szTypes); // ;-separated type names; empty for all
+
+const char *GetRecordChunkTypeName(C4RecordChunkType eType);
+
 #pragma pack(1)
 
 struct C4RecordChunkHead // record file chunk head
@@ -250,6 +263,61 @@ public:
 	virtual void CompileFunc(StdCompiler *pComp) override;
 };
 
+// Packs the debug records of one frame into a block that is written as a single RCT_DbgPack chunk.
+// Each record is stored as type byte, size and data; whole 32 bit words of the data are stored
+// as differences to the same word of the previous record of that type, because most debug records
+// (random calls, pixel changes, object positions) change only slightly from one to the next.
+// Sizes and differences are written as variable-length integers, so small values take a single byte.
+// Blocks are compressed and can be decoded on their own, so playback can start at any keyframe.
+class C4RecordDebugPacker
+{
+public:
+	static constexpr size_t MaxBlockSize = 1 << 16; // raw size at which a block is closed within a frame
+
+private:
+	std::vector<uint8_t> Data; // packed records of the current block
+	std::vector<uint8_t> Records; // unpacked records of the current block
+	std::array<size_t, 0x80> LastRecordPos, LastRecordSize; // previous record of each type in Records
+	uint32_t iFrame{0}; // frame of the records in the current block
+
+public:
+	C4RecordDebugPacker() { Clear(); }
+
+	void Add(uint32_t iAtFrame, C4RecordChunkType eType, const void *pData, size_t iSize);
+	void Clear();
+
+	bool IsEmpty() const { return Data.empty(); }
+	size_t GetSize() const { return Data.size(); }
+	uint32_t GetFrame() const { return iFrame; }
+	StdBuf GetData() const { return StdBuf(Data.data(), Data.size()); }
+
+	static bool Compress(const StdBuf &Raw, StdBuf &rPacked); // raw block to RCT_DbgPack chunk data
+	static bool Unpack(const StdBuf &Packed, size_t iRawSize, std::vector<std::unique_ptr<C4PktDebugRec>> &rRecords);
+	static bool Decode(const StdBuf &Raw, std::vector<std::unique_ptr<C4PktDebugRec>> &rRecords); // raw block to single records
+
+	static size_t GetUnpackedRecordSize(size_t iSize); // size of a record as a single chunk
+};
+
+// savegame taken during recording, from which playback can be started
+struct C4RecordKeyframe
+{
+	int32_t Frame; // frame at which the savegame has been taken
+	uint32_t Offset; // position of the first control chunk of that frame in the control record
+	int32_t BaseFrame; // frame the frame difference of that chunk is relative to
+	StdStrBuf Filename; // savegame group name inside the record
+	bool ContinueRandom; // if set, the game did not reset the random sequence at this synchronization
+	uint32_t RandomHold; int32_t RandomCount, Random3Ptr; // random state to continue with
+
+	void CompileFunc(StdCompiler *pComp);
+};
+
+// frames to wait before requesting a keyframe again that had to be skipped
+const int32_t C4RecordKeyframeRetryDelay = 35;
+
+typedef std::vector<C4RecordKeyframe> C4RecordKeyframeList;
+
+class C4RecordWriter;
+
 class C4Record // demo recording
 {
 private:
@@ -258,9 +326,23 @@ private:
 	C4Group RecordGrp; // record scenario group
 	bool fRecording; // set if recording is active
 	uint32_t iLastFrame; // frame of last chunk written
+	uint32_t iCtrlRecSize; // bytes written to control file
+	uint32_t iFramePos, iFrameBaseFrame; // control file position and base frame of the first chunk of iPosFrame
+	int32_t iPosFrame;
+	int32_t iKeyframeInterval; // frames between keyframes; 0 if disabled
+	int32_t iLastKeyframe; // frame of last keyframe (or record start)
+	bool fKeyframeRequested; // synchronization for next keyframe requested
+	C4RecordKeyframeList Keyframes;
 	bool fStreaming; // perdiodically sent new control to server
 	unsigned int iStreamingPos; // Position of current buffer in stream
 	StdBuf StreamingData; // accumulated control data since last stream sync
+	std::unique_ptr<C4RecordWriter> Writer; // writes and compresses chunks on a separate thread; nullptr to write directly
+	C4RecordDebugPacker DebugRecPacker; // debug records of the current frame that have not been written yet
+	uint32_t iDebugRecCount; // debug records written
+	uint32_t iDebugRecUnpackedSize; // size the debug records would have taken as single chunks
+	uint32_t iDebugRecPackedSize; // size of the debug record chunks (if written directly)
+	uint32_t iDebugRecPackFailures; // blocks that could not be compressed and were written as single chunks (if written directly)
+	uint32_t iStartTime;
 
 public:
 	C4Record(); // creates control file etc
@@ -276,16 +358,28 @@ public:
 	bool Rec(const C4Control &Ctrl, int iFrame); // record control
 	bool Rec(C4PacketType eCtrlType, C4ControlPacket *pCtrl, int iFrame); // record control packet
 	bool Rec(uint32_t iFrame, const StdBuf &sBuf, C4RecordChunkType eType);
+	void RecDebug(uint32_t iFrame, C4RecordChunkType eType, const void *pData, size_t iSize); // record debug record in compact form
 
 	bool AddFile(const char *szLocalFilename, const char *szAddAs, bool fDelete = false);
 
+	bool IsKeyframeDue(int32_t iFrame) const { return iKeyframeInterval && iFrame >= iLastKeyframe + iKeyframeInterval; }
+	bool IsKeyframeRequested() const { return fKeyframeRequested; }
+	void SetKeyframeRequested() { fKeyframeRequested = true; }
+	void SkipKeyframe(); // keyframe synchronization was skipped; request again a bit later
+	bool SaveKeyframe(); // save game state of current synchronization as keyframe
+
 	bool StartStreaming(bool fInitial);
 	void ClearStreamingBuf(unsigned int iAmount);
 	void StopStreaming();
 
 private:
+	bool WriteChunk(uint32_t iFrame, const StdBuf &sBuf, C4RecordChunkType eType);
+	void FlushDebugRec(); // write pending debug records
+	bool WriteDebugRecChunks(uint32_t iFrame, const StdBuf &Block); // write a raw debug record block as single chunks
+	void SyncWriter(); // wait for the writer and take over its file positions
 	void Stream(const C4RecordChunkHead &Head, const StdBuf &sBuf);
 	bool StreamFile(const char *szFilename, const char *szAddAs);
+	bool SaveKeyframeIndex();
 };
 
 class C4Playback // demo playback
@@ -296,9 +390,12 @@ private:
 	chunks_t::iterator currChunk;
 	bool Finished; // if set, free playback in next frame
 	CStdFile playbackFile; // if open, try reading additional chunks from this file
+	C4Group playbackGroup; // if open, read additional chunks from the accessed entry of this (packed) group instead
+	size_t iPlaybackGroupRemaining; // unread bytes of the accessed control entry in playbackGroup
 	bool fLoadSequential; // used for debugrecs: Sequential reading of files
 	StdBuf sequentialBuffer; // buffer to manage sequential reads
 	uint32_t iLastSequentialFrame; // frame number of last chunk read
+	std::optional<C4RecordKeyframe> StartKeyframe; // keyframe playback started from, until its random state has been restored
 	void Finish(); // end playback
 #ifdef DEBUGREC
 	C4PacketList DebugRec;
@@ -313,10 +410,20 @@ public:
 	bool ReadText(const StdStrBuf &Buf);
 	void NextChunk(); // point to next prepared chunk in mem or read it
 	bool NextSequentialChunk(); // read from seq file until a new chunk has been filled
+	static bool LoadKeyframes(C4Group &rGrp, C4RecordKeyframeList &rKeyframes);
+
+private:
+	bool OpenSequential(C4Group &rGrp, uint32_t iOffset = 0, int32_t iBaseFrame = 0); // stream control data of rGrp
+	bool OpenKeyframe(C4Group &rGrp); // stream control data of the record rGrp is a keyframe of
+	bool ReadSequential(void *pBuffer, size_t iSize, size_t *ipRealSize);
+	bool UnpackDebugRec(int32_t iFrame, const StdBuf &Packed, size_t iRawSize); // add records of a RCT_DbgPack chunk
+
+public:
 	StdStrBuf ReWriteText();
 	StdBuf ReWriteBinary();
 	void Strip();
 	bool ExecuteControl(C4Control *pCtrl, int iFrame); // assign control
+	bool RestoreKeyframeRandom(); // continue the random sequence of the start keyframe; false if it has to be reset as usual
 	void Clear();
 #ifdef DEBUGREC
 	void Check(C4RecordChunkType eType, const uint8_t *pData, int iSize); // compare with debugrec
@@ -3422,6 +3422,35 @@ static C4Value FnCall(C4AulContext *cthr, C4String *szFunction,
 	return cthr->Obj->Call(FnStringPar(szFunction), Pars, true, !cthr->CalledWithStrictNil());
 }
 
+static C4ValueInt FnStartCoroutine(C4AulContext *cthr, C4String *szFunction, C4ValueInt iBudget,
+	C4Value par0, C4Value par1, C4Value par2, C4Value par3, C4Value par4,
+	C4Value par5, C4Value par6, C4Value par7)
+{
+	if (!szFunction) return 0;
+	// function of the calling script, executed in the same context
+	C4AulScript *pScript = cthr->Obj ? static_cast<C4AulScript *>(&cthr->Obj->Def->Script) : cthr->Def ? static_cast<C4AulScript *>(&cthr->Def->Script) : &Game.Script;
+	C4AulScriptFunc *pFunc = pScript->GetSFunc(FnStringPar(szFunction), AA_PRIVATE, true);
+	if (!pFunc) return 0;
+	C4AulParSet Pars;
+	Copy2ParSet8(Pars, par);
+	return Game.ScriptEngine.StartCoroutine(pFunc, cthr->Obj, Pars, iBudget);
+}
+
+static bool FnYield(C4AulContext *cthr)
+{
+	return Game.ScriptEngine.YieldCoroutine();
+}
+
+static bool FnStopCoroutine(C4AulContext *cthr, C4ValueInt iNumber)
+{
+	return Game.ScriptEngine.StopCoroutine(iNumber);
+}
+
+static bool FnIsCoroutineRunning(C4AulContext *cthr, C4ValueInt iNumber)
+{
+	return Game.ScriptEngine.IsCoroutineRunning(iNumber);
+}
+
 static C4Value FnObjectCall(C4AulContext *cthr,
 	C4Object *pObj, C4String *szFunction,
 	C4Value par0, C4Value par1, C4Value par2, C4Value par3, C4Value par4,
@@ -6609,6 +6638,10 @@ void InitFunctionMap(C4AulScriptEngine *pEngine)
 	AddFunc(pEngine, "GameCallEx", FnGameCallEx);
 	AddFunc(pEngine, "DefinitionCall", FnDefinitionCall);
 	AddFunc(pEngine, "Call", FnCall, false);
+	AddFunc(pEngine, "StartCoroutine", FnStartCoroutine);
+	AddFunc(pEngine, "Yield", FnYield);
+	AddFunc(pEngine, "StopCoroutine", FnStopCoroutine);
+	AddFunc(pEngine, "IsCoroutineRunning", FnIsCoroutineRunning);
 	AddFunc(pEngine, "GetPlrKnowledge", FnGetPlrKnowledge);
 	AddFunc(pEngine, "GetPlrMagic", FnGetPlrMagic);
 	AddFunc(pEngine, "GetComponent", FnGetComponent);
@@ -25,6 +25,25 @@
 #include <C4Log.h>
 #include <C4Record.h>
 
+#include <bit>
+
+/* OCF counts */
+
+void C4LSectorOCFCount::Change(uint32_t ocf, int32_t iChange)
+{
+	for (ocf &= C4LSectorOCFMask; ocf; ocf &= ocf - 1)
+		Count[std::countr_zero(ocf)] += iChange;
+}
+
+bool C4LSectorOCFCount::May(uint32_t ocf) const
+{
+	// flags that are not counted may always match
+	if (ocf & ~C4LSectorOCFMask) return true;
+	for (; ocf; ocf &= ocf - 1)
+		if (Count[std::countr_zero(ocf)]) return true;
+	return false;
+}
+
 /* sector */
 
 void C4LSector::Init(int ix, int iy)
@@ -33,6 +52,8 @@ void C4LSector::Init(int ix, int iy)
 	Clear();
 	// store class members
 	x = ix; y = iy;
+	ObjectsOCF.Clear();
+	ObjectShapesOCF.Clear();
 }
 
 void C4LSector::Clear()
@@ -70,6 +91,15 @@ void C4LSectors::Init(int iWdt, int iHgt)
 
 void C4LSectors::Clear()
 {
+	// objects still listed are not counted anymore
+	if (Sectors)
+	{
+		for (int cnt = 0; cnt < Size; cnt++)
+			for (C4Object *pObj : Sectors[cnt].Objects)
+				pObj->SectorOCF = 0;
+		for (C4Object *pObj : SectorOut.Objects)
+			pObj->SectorOCF = 0;
+	}
 	// clear out-sector
 	SectorOut.Clear();
 	// free sectors
@@ -91,6 +121,8 @@ void C4LSectors::Add(C4Object *pObj, C4ObjectList *pMainList)
 	// Add to owning sector
 	C4LSector *pSct = SectorAt(pObj->x, pObj->y);
 	pSct->Objects.Add(pObj, C4ObjectList::stMain, pMainList);
+	pObj->SectorOCF = pObj->OCF | OCF_Normal;
+	pSct->ObjectsOCF.Change(pObj->SectorOCF, +1);
 	// Save position
 	pObj->old_x = pObj->x; pObj->old_y = pObj->y;
 	// Add to all sectors in shape area
@@ -98,6 +130,7 @@ void C4LSectors::Add(C4Object *pObj, C4ObjectList *pMainList)
 	for (pSct = pObj->Area.First(); pSct; pSct = pObj->Area.Next(pSct))
 	{
 		pSct->ObjectShapes.Add(pObj, C4ObjectList::stMain, pMainList);
+		pSct->ObjectShapesOCF.Change(pObj->SectorOCF, +1);
 	}
 #ifdef DEBUGREC
 	pObj->Area.DebugRec(pObj, 'A');
@@ -122,7 +155,9 @@ void C4LSectors::Update(C4Object *pObj, C4ObjectList *pMainList)
 		if (pOld != pNew)
 		{
 			pOld->Objects.Remove(pObj);
+			pOld->ObjectsOCF.Change(pObj->SectorOCF, -1);
 			pNew->Objects.Add(pObj, C4ObjectList::stMain, pMainList);
+			pNew->ObjectsOCF.Change(pObj->SectorOCF, +1);
 		}
 		// Save position
 		pObj->old_x = pObj->x; pObj->old_y = pObj->y;
@@ -133,12 +168,16 @@ void C4LSectors::Update(C4Object *pObj, C4ObjectList *pMainList)
 	// Remove from all old sectors in shape area
 	for (pOld = pObj->Area.First(); pOld; pOld = pObj->Area.Next(pOld))
 		if (!NewArea.Contains(pOld))
+		{
 			pOld->ObjectShapes.Remove(pObj);
+			pOld->ObjectShapesOCF.Change(pObj->SectorOCF, -1);
+		}
 	// Add to all new sectors in shape area
 	for (pNew = NewArea.First(); pNew; pNew = NewArea.Next(pNew))
 		if (!pObj->Area.Contains(pNew))
 		{
 			pNew->ObjectShapes.Add(pObj, C4ObjectList::stMain, pMainList);
+			pNew->ObjectShapesOCF.Change(pObj->SectorOCF, +1);
 		}
 	// Update area
 	pObj->Area = NewArea;
@@ -152,7 +191,9 @@ void C4LSectors::Remove(C4Object *pObj)
 	assert(Sectors); assert(pObj);
 	// Remove from owning sector
 	C4LSector *pSct = SectorAt(pObj->old_x, pObj->old_y);
-	if (!pSct->Objects.Remove(pObj))
+	if (pSct->Objects.Remove(pObj))
+		pSct->ObjectsOCF.Change(pObj->SectorOCF, -1);
+	else
 	{
 #ifndef NDEBUG
 		LogF("WARNING: Object %d of type %s deleted but not found in pos sector list!", pObj->Number, C4IdText(pObj->id));
@@ -160,28 +201,54 @@ void C4LSectors::Remove(C4Object *pObj)
 		// if it was not found in owning sector, it must be somewhere else. yeah...
 		bool fFound = false;
 		for (pSct = pObj->Area.First(); pSct; pSct = pObj->Area.Next(pSct))
-			if (pSct->Objects.Remove(pObj)) { fFound = true; break; }
+			if (pSct->Objects.Remove(pObj)) { pSct->ObjectsOCF.Change(pObj->SectorOCF, -1); fFound = true; break; }
 		// yukh, somewhere else entirely...
 		if (!fFound)
 		{
 			fFound = !!SectorOut.Objects.Remove(pObj);
-			if (!fFound)
+			if (fFound)
+				SectorOut.ObjectsOCF.Change(pObj->SectorOCF, -1);
+			else
 			{
 				pSct = Sectors;
 				for (int cnt = 0; cnt < Size; cnt++, pSct++)
-					if (pSct->Objects.Remove(pObj)) { fFound = true; break; }
+					if (pSct->Objects.Remove(pObj)) { pSct->ObjectsOCF.Change(pObj->SectorOCF, -1); fFound = true; break; }
 			}
 			assert(fFound);
 		}
 	}
 	// Remove from all sectors in shape area
 	for (pSct = pObj->Area.First(); pSct; pSct = pObj->Area.Next(pSct))
-		pSct->ObjectShapes.Remove(pObj);
+		if (pSct->ObjectShapes.Remove(pObj))
+			pSct->ObjectShapesOCF.Change(pObj->SectorOCF, -1);
+	pObj->SectorOCF = 0;
 #ifdef DEBUGREC
 	pObj->Area.DebugRec(pObj, 'R');
 #endif
 }
 
+void C4LSectors::UpdateOCF(C4Object *pObj)
+{
+	// not in sectors?
+	if (!pObj->SectorOCF) return;
+	// counted flags unchanged?
+	const uint32_t dwNewOCF = pObj->OCF | OCF_Normal;
+	if (!((pObj->SectorOCF ^ dwNewOCF) & C4LSectorOCFMask))
+	{
+		pObj->SectorOCF = dwNewOCF;
+		return;
+	}
+	C4LSector *pSct = SectorAt(pObj->old_x, pObj->old_y);
+	pSct->ObjectsOCF.Change(pObj->SectorOCF, -1);
+	pSct->ObjectsOCF.Change(dwNewOCF, +1);
+	for (pSct = pObj->Area.First(); pSct; pSct = pObj->Area.Next(pSct))
+	{
+		pSct->ObjectShapesOCF.Change(pObj->SectorOCF, -1);
+		pSct->ObjectShapesOCF.Change(dwNewOCF, +1);
+	}
+	pObj->SectorOCF = dwNewOCF;
+}
+
 void C4LSectors::AssertObjectNotInList(C4Object *pObj)
 {
 	C4LSector *sct = Sectors;
@@ -219,6 +286,23 @@ bool C4LSectors::CheckSort()
 	return true;
 }
 
+bool C4LSectors::CheckOCFCounts()
+{
+	// recount all lists and compare
+	const auto check = [](C4ObjectList &List, const C4LSectorOCFCount &Counted)
+	{
+		C4LSectorOCFCount Count;
+		Count.Clear();
+		for (C4Object *pObj : List)
+			Count.Change(pObj->OCF | OCF_Normal, +1);
+		return Count == Counted;
+	};
+	for (int cnt = 0; cnt < Size; cnt++)
+		if (!check(Sectors[cnt].Objects, Sectors[cnt].ObjectsOCF) || !check(Sectors[cnt].ObjectShapes, Sectors[cnt].ObjectShapesOCF))
+			return false;
+	return check(SectorOut.Objects, SectorOut.ObjectsOCF) && check(SectorOut.ObjectShapes, SectorOut.ObjectShapesOCF);
+}
+
 /* landscape area */
 
 bool C4LArea::operator==(const C4LArea &Area) const
@@ -21,6 +21,8 @@
 
 #include <C4ObjectList.h>
 
+#include <array>
+
 // class predefs
 class C4LSector;
 class C4LSectors;
@@ -30,6 +32,24 @@ class C4LArea;
 const int32_t C4LSectorWdt = 50,
               C4LSectorHgt = 50;
 
+// OCF flags counted per sector list, so CrossCheck can skip sectors without candidates
+// OCF_Normal is always set and marks objects as counted
+const uint32_t C4LSectorOCFMask = OCF_Normal | OCF_Carryable | OCF_HitSpeed2 | OCF_FightReady | OCF_Inflammable;
+
+// number of objects per OCF bit
+class C4LSectorOCFCount
+{
+protected:
+	std::array<int32_t, 32> Count;
+
+public:
+	void Clear() { Count.fill(0); }
+	void Change(uint32_t ocf, int32_t iChange);
+	bool May(uint32_t ocf) const; // whether any object may match one of the flags
+
+	bool operator==(const C4LSectorOCFCount &) const = default;
+};
+
 // one of those object list sectors
 class C4LSector
 {
@@ -47,6 +67,9 @@ public:
 	C4ObjectList Objects; // objects within this sector
 	C4ObjectList ObjectShapes; // objects with shapes that overlap this sector
 
+	C4LSectorOCFCount ObjectsOCF; // OCF counts of Objects
+	C4LSectorOCFCount ObjectShapesOCF; // OCF counts of ObjectShapes
+
 	void CompileFunc(StdCompiler *pComp);
 
 	friend class C4LSectors;
@@ -70,6 +93,7 @@ public:
 	void Add(C4Object *pObj, C4ObjectList *pMainList);
 	void Update(C4Object *pObj, C4ObjectList *pMainList); // does not update object order!
 	void Remove(C4Object *pObj);
+	void UpdateOCF(C4Object *pObj); // update OCF counts after the OCF of an object changed
 
 	void AssertObjectNotInList(C4Object *pObj); // searches all sector lists for object, and assert if it's inside a list
 
@@ -77,6 +101,7 @@ public:
 
 	void Dump();
 	bool CheckSort();
+	bool CheckOCFCounts();
 };
 
 // a defined sector-area within the map
@@ -22,6 +22,8 @@
 #include <C4Physics.h>
 #include <C4Material.h>
 #include <C4Wrappers.h>
+#include <C4Config.h>
+#include <C4Log.h>
 
 bool C4Shape::AddVertex(int32_t iX, int32_t iY)
 {
@@ -354,11 +356,57 @@ bool C4Shape::RemoveVertex(int32_t iPos)
 	return true;
 }
 
+C4ShapeContactStats C4Shape::ContactStats;
+
+bool C4Shape::IsContactCacheValid(int32_t cx, int32_t cy) const
+{
+	const C4ShapeContactCache &rCache = ContactCache;
+	return rCache.Valid && rCache.cx == cx && rCache.cy == cy && rCache.ContactDensity == ContactDensity && rCache.VtxNum == VtxNum
+		&& !memcmp(rCache.VtxX, VtxX, VtxNum * sizeof(*VtxX))
+		&& !memcmp(rCache.VtxY, VtxY, VtxNum * sizeof(*VtxY))
+		&& !memcmp(rCache.VtxCNAT, VtxCNAT, VtxNum * sizeof(*VtxCNAT))
+		&& !Game.Landscape.HasChangedSince(rCache.Area, rCache.LandscapeStamp);
+}
+
+void C4Shape::StoreContactCache(int32_t cx, int32_t cy, const int32_t *pPosX, const int32_t *pPosY, int32_t iCount)
+{
+	C4ShapeContactCache &rCache = ContactCache;
+	rCache.Valid = true;
+	rCache.cx = cx; rCache.cy = cy;
+	rCache.ContactDensity = ContactDensity;
+	rCache.VtxNum = VtxNum;
+	memcpy(rCache.VtxX, VtxX, VtxNum * sizeof(*VtxX));
+	memcpy(rCache.VtxY, VtxY, VtxNum * sizeof(*VtxY));
+	memcpy(rCache.VtxCNAT, VtxCNAT, VtxNum * sizeof(*VtxCNAT));
+	// checked pixels and their neighbours
+	if (iCount)
+	{
+		const auto [iMinX, iMaxX] = std::minmax_element(pPosX, pPosX + iCount);
+		const auto [iMinY, iMaxY] = std::minmax_element(pPosY, pPosY + iCount);
+		rCache.Area.Set(*iMinX - 1, *iMinY - 1, *iMaxX - *iMinX + 3, *iMaxY - *iMinY + 3);
+	}
+	else
+		rCache.Area.Default();
+	rCache.LandscapeStamp = Game.Landscape.GetChangeStamp();
+	rCache.ContactCNAT = ContactCNAT;
+	rCache.ContactCount = ContactCount;
+	memcpy(rCache.VtxContactCNAT, VtxContactCNAT, VtxNum * sizeof(*VtxContactCNAT));
+	memcpy(rCache.VtxContactMat, VtxContactMat, VtxNum * sizeof(*VtxContactMat));
+}
+
 bool C4Shape::CheckContact(int32_t cx, int32_t cy)
 {
 	// Check all vertices at given object position.
 	// Return true on any contact.
 
+	++ContactStats.Checks;
+	// the last full check at this position knows
+	if (Config.Developer.ContactCache && !Config.Developer.ContactCacheVerify && IsContactCacheValid(cx, cy))
+	{
+		++ContactStats.CacheHits;
+		return ContactCache.ContactCount > 0;
+	}
+
 	for (int32_t cvtx = 0; cvtx < VtxNum; cvtx++)
 		if (!(VtxCNAT[cvtx] & CNAT_NoCollision))
 			if (GBackDensity(cx + VtxX[cvtx], cy + VtxY[cvtx]) >= ContactDensity)
@@ -374,34 +422,81 @@ bool C4Shape::ContactCheck(int32_t cx, int32_t cy)
 	// Set VtxContactCNAT and VtxContactMat.
 	// Return true on any contact.
 
-	ContactCNAT = CNAT_None;
-	ContactCount = 0;
+	++ContactStats.Checks;
+	// same position, vertices and landscape as last time: same result
+	const bool fCached = Config.Developer.ContactCache && IsContactCacheValid(cx, cy);
+	if (fCached)
+	{
+		++ContactStats.CacheHits;
+		if (!Config.Developer.ContactCacheVerify)
+		{
+			ContactCNAT = ContactCache.ContactCNAT;
+			ContactCount = ContactCache.ContactCount;
+			for (int32_t cvtx = 0; cvtx < VtxNum; cvtx++)
+				if (!(VtxCNAT[cvtx] & CNAT_NoCollision))
+				{
+					VtxContactCNAT[cvtx] = ContactCache.VtxContactCNAT[cvtx];
+					VtxContactMat[cvtx] = ContactCache.VtxContactMat[cvtx];
+				}
+			return ContactCount;
+		}
+	}
 
+	// gather the landscape positions of all vertices that collide
+	int32_t iCount = 0;
+	int32_t CheckVtx[C4D_MaxVertex], CheckX[C4D_MaxVertex], CheckY[C4D_MaxVertex];
 	for (int32_t cvtx = 0; cvtx < VtxNum; cvtx++)
-
 		// Ignore vertex if collision has been flagged out
 		if (!(VtxCNAT[cvtx] & CNAT_NoCollision))
+		{
+			CheckVtx[iCount] = cvtx;
+			CheckX[iCount] = cx + VtxX[cvtx];
+			CheckY[iCount] = cy + VtxY[cvtx];
+			++iCount;
+		}
+
+	ContactCNAT = CNAT_None;
+	ContactCount = 0;
+
+	for (int32_t i = 0; i < iCount; i++)
+	{
+		const int32_t cvtx = CheckVtx[i], tx = CheckX[i], ty = CheckY[i];
+		VtxContactCNAT[cvtx] = CNAT_None;
+		VtxContactMat[cvtx] = GBackMat(tx, ty);
 
+		if (GBackDensity(tx, ty) >= ContactDensity)
 		{
-			VtxContactCNAT[cvtx] = CNAT_None;
-			VtxContactMat[cvtx] = GBackMat(cx + VtxX[cvtx], cy + VtxY[cvtx]);
+			ContactCNAT |= VtxCNAT[cvtx];
+			VtxContactCNAT[cvtx] |= CNAT_Center;
+			ContactCount++;
+			// Vertex center contact, now check top,bottom,left,right
+			if (GBackDensity(tx, ty - 1) >= ContactDensity)
+				VtxContactCNAT[cvtx] |= CNAT_Top;
+			if (GBackDensity(tx, ty + 1) >= ContactDensity)
+				VtxContactCNAT[cvtx] |= CNAT_Bottom;
+			if (GBackDensity(tx - 1, ty) >= ContactDensity)
+				VtxContactCNAT[cvtx] |= CNAT_Left;
+			if (GBackDensity(tx + 1, ty) >= ContactDensity)
+				VtxContactCNAT[cvtx] |= CNAT_Right;
+		}
+	}
 
-			if (GBackDensity(cx + VtxX[cvtx], cy + VtxY[cvtx]) >= ContactDensity)
-			{
-				ContactCNAT |= VtxCNAT[cvtx];
-				VtxContactCNAT[cvtx] |= CNAT_Center;
-				ContactCount++;
-				// Vertex center contact, now check top,bottom,left,right
-				if (GBackDensity(cx + VtxX[cvtx], cy + VtxY[cvtx] - 1) >= ContactDensity)
-					VtxContactCNAT[cvtx] |= CNAT_Top;
-				if (GBackDensity(cx + VtxX[cvtx], cy + VtxY[cvtx] + 1) >= ContactDensity)
-					VtxContactCNAT[cvtx] |= CNAT_Bottom;
-				if (GBackDensity(cx + VtxX[cvtx] - 1, cy + VtxY[cvtx]) >= ContactDensity)
-					VtxContactCNAT[cvtx] |= CNAT_Left;
-				if (GBackDensity(cx + VtxX[cvtx] + 1, cy + VtxY[cvtx]) >= ContactDensity)
-					VtxContactCNAT[cvtx] |= CNAT_Right;
-			}
+	// verify mode: the cached result must not differ in anything that would have been returned
+	if (fCached)
+	{
+		bool fMatch = ContactCache.ContactCNAT == ContactCNAT && ContactCache.ContactCount == ContactCount;
+		for (int32_t i = 0; i < iCount; i++)
+			fMatch = fMatch && ContactCache.VtxContactCNAT[CheckVtx[i]] == VtxContactCNAT[CheckVtx[i]] && ContactCache.VtxContactMat[CheckVtx[i]] == VtxContactMat[CheckVtx[i]];
+		if (!fMatch)
+		{
+			++ContactStats.Mismatches;
+			LogF("Contact cache mismatch at %d/%d!", static_cast<int>(cx), static_cast<int>(cy));
+			assert(!"Contact cache mismatch");
 		}
+	}
+
+	if (Config.Developer.ContactCache)
+		StoreContactCache(cx, cy, CheckX, CheckY, iCount);
 
 	return ContactCount;
 }
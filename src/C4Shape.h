@@ -36,6 +36,31 @@ public:
 
 extern C4DensityProvider DefaultDensityProvider;
 
+// result of the last C4Shape::ContactCheck, reused as long as position, vertices and the landscape around them are unchanged
+struct C4ShapeContactCache
+{
+	bool Valid{false};
+	int32_t cx, cy, ContactDensity, VtxNum;
+	int32_t VtxX[C4D_MaxVertex], VtxY[C4D_MaxVertex], VtxCNAT[C4D_MaxVertex];
+	C4Rect Area; // landscape pixels the result depends on
+	uint64_t LandscapeStamp;
+	int32_t ContactCNAT, ContactCount;
+	int32_t VtxContactCNAT[C4D_MaxVertex], VtxContactMat[C4D_MaxVertex];
+};
+
+// contact check counters
+struct C4ShapeContactStats
+{
+	uint32_t Checks{0}, CacheHits{0}; // current frame
+	uint32_t TotalChecks{0}, TotalCacheHits{0}, Mismatches{0}; // since the last report
+
+	void NextFrame()
+	{
+		TotalChecks += Checks; TotalCacheHits += CacheHits;
+		Checks = CacheHits = 0;
+	}
+};
+
 class C4Shape : public C4Rect
 {
 public:
@@ -53,6 +78,9 @@ public:
 	int32_t VtxContactCNAT[C4D_MaxVertex]{};
 	int32_t VtxContactMat[C4D_MaxVertex]{};
 	int32_t iAttachX{}, iAttachY{}, iAttachVtx{};
+	C4ShapeContactCache ContactCache; // NoSave; validates itself, so it needs no adjustment in CopyFrom
+
+	static C4ShapeContactStats ContactStats;
 
 public:
 	C4Shape();
@@ -75,4 +103,8 @@ public:
 	int32_t GetVertexContact(int32_t iVtx, uint32_t dwCheckMask, int32_t tx, int32_t ty, const C4DensityProvider &rDensityProvider = DefaultDensityProvider); // get CNAT-mask for given vertex - does not check range for iVtx!
 	void CreateOwnOriginalCopy(C4Shape &rFrom); // create copy of all vertex members in back area of own buffers
 	void CompileFunc(StdCompiler *pComp, bool fRuntime);
+
+private:
+	bool IsContactCacheValid(int32_t cx, int32_t cy) const;
+	void StoreContactCache(int32_t cx, int32_t cy, const int32_t *pPosX, const int32_t *pPosY, int32_t iCount);
 };
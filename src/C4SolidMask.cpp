@@ -23,6 +23,8 @@
 #include <C4Object.h>
 #include <C4Wrappers.h>
 
+#include <algorithm>
+
 void C4SolidMask::Put(bool fCauseInstability, C4TargetRect *pClipRect, bool fRestoreAttachment)
 {
 	// If not put, put mask to background,
@@ -174,6 +176,8 @@ void C4SolidMask::Put(bool fCauseInstability, C4TargetRect *pClipRect, bool fRes
 	}
 	// Store mask put status
 	MaskPut = true;
+	// put rect may have changed
+	if (RegularPut) UpdateIndex();
 	// restore attached object positions if moved
 	if (fRestoreAttachment && iAttachingObjectsCount)
 	{
@@ -261,8 +265,10 @@ void C4SolidMask::Remove(bool fCauseInstability, bool fBackupAttachment)
 	MaskPut = false;
 	// update surrounding masks in that range
 	C4TargetRect ClipRect;
-	for (C4SolidMask *pSolid = C4SolidMask::Last; pSolid; pSolid = pSolid->Prev)
-		if (pSolid->MaskPut) if (pSolid->MaskPutRect.Overlap(MaskPutRect))
+	std::vector<C4SolidMask *> Masks;
+	GetCandidates(MaskPutRect, Masks);
+	for (auto it = Masks.rbegin(); it != Masks.rend(); ++it)
+		if (C4SolidMask *pSolid = *it; pSolid->MaskPut) if (pSolid->MaskPutRect.Overlap(MaskPutRect))
 		{
 			// set clipping rect for all calls, since they may modify it
 			ClipRect.Set(MaskPutRect.x, MaskPutRect.y, MaskPutRect.Wdt, MaskPutRect.Hgt, 0, 0);
@@ -383,9 +389,121 @@ void C4SolidMask::Repair(C4Rect where)
 	}
 }
 
+void C4SolidMask::RemoveTemporaryAll(C4Rect where)
+{
+	// remove in reverse order of putting
+	std::vector<C4SolidMask *> Masks;
+	GetCandidates(where, Masks);
+	for (auto it = Masks.rbegin(); it != Masks.rend(); ++it)
+		(*it)->RemoveTemporary(where);
+}
+
+void C4SolidMask::PutTemporaryAll(C4Rect where)
+{
+	std::vector<C4SolidMask *> Masks;
+	GetCandidates(where, Masks);
+	for (C4SolidMask *pSolid : Masks)
+		pSolid->PutTemporary(where);
+}
+
+void C4SolidMask::RepairAll(C4Rect where)
+{
+	std::vector<C4SolidMask *> Masks;
+	GetCandidates(where, Masks);
+	for (C4SolidMask *pSolid : Masks)
+		pSolid->Repair(where);
+}
+
+C4Rect C4SolidMask::GetCells(const C4Rect &rRect)
+{
+	const int32_t iX1 = rRect.x, iY1 = rRect.y;
+	const int32_t iX2 = rRect.x + std::max<int32_t>(rRect.Wdt, 1) - 1, iY2 = rRect.y + std::max<int32_t>(rRect.Hgt, 1) - 1;
+	// round towards negative infinity
+	auto Cell = [](int32_t iPos, int32_t iSize) { return iPos >= 0 ? iPos / iSize : -((-iPos + iSize - 1) / iSize); };
+	const int32_t iCX1 = Cell(iX1, C4SolidMaskCellWdt), iCY1 = Cell(iY1, C4SolidMaskCellHgt);
+	return C4Rect(iCX1, iCY1, Cell(iX2, C4SolidMaskCellWdt) - iCX1 + 1, Cell(iY2, C4SolidMaskCellHgt) - iCY1 + 1);
+}
+
+uint32_t C4SolidMask::GetCellKey(int32_t iCellX, int32_t iCellY)
+{
+	// colliding keys only add candidates
+	return (static_cast<uint32_t>(iCellY) << 16) ^ static_cast<uint32_t>(iCellX & 0xffff);
+}
+
+void C4SolidMask::UpdateIndex()
+{
+	C4Rect Cells = GetCells(MaskPutRect);
+	if (IndexCells.Wdt && Cells == IndexCells) return;
+	RemoveFromIndex();
+	for (int32_t y = Cells.y; y < Cells.y + Cells.Hgt; ++y)
+		for (int32_t x = Cells.x; x < Cells.x + Cells.Wdt; ++x)
+			Index[GetCellKey(x, y)].push_back(this);
+	IndexCells = Cells;
+}
+
+void C4SolidMask::RemoveFromIndex()
+{
+	if (!IndexCells.Wdt) return;
+	for (int32_t y = IndexCells.y; y < IndexCells.y + IndexCells.Hgt; ++y)
+		for (int32_t x = IndexCells.x; x < IndexCells.x + IndexCells.Wdt; ++x)
+		{
+			auto it = Index.find(GetCellKey(x, y));
+			if (it == Index.end()) continue;
+			std::vector<C4SolidMask *> &rCell = it->second;
+			rCell.erase(std::remove(rCell.begin(), rCell.end(), this), rCell.end());
+			if (rCell.empty()) Index.erase(it);
+		}
+	IndexCells.Default();
+}
+
+void C4SolidMask::GetCandidates(const C4Rect &rRect, std::vector<C4SolidMask *> &rMasks)
+{
+	rMasks.clear();
+	const C4Rect Cells = GetCells(rRect);
+	// huge rects: walking the list is cheaper than looking up every cell
+	if (static_cast<size_t>(Cells.Wdt) * Cells.Hgt > Index.size())
+	{
+		for (C4SolidMask *pSolid = First; pSolid; pSolid = pSolid->Next)
+			if (pSolid->IndexCells.Wdt)
+				rMasks.push_back(pSolid);
+		return;
+	}
+	for (int32_t y = Cells.y; y < Cells.y + Cells.Hgt; ++y)
+		for (int32_t x = Cells.x; x < Cells.x + Cells.Wdt; ++x)
+		{
+			auto it = Index.find(GetCellKey(x, y));
+			if (it != Index.end())
+				rMasks.insert(rMasks.end(), it->second.begin(), it->second.end());
+		}
+	// masks spanning several cells have been found multiple times
+	std::sort(rMasks.begin(), rMasks.end(), [](C4SolidMask *a, C4SolidMask *b) { return a->Serial < b->Serial; });
+	rMasks.erase(std::unique(rMasks.begin(), rMasks.end()), rMasks.end());
+#ifdef SOLIDMASK_DEBUG
+	// cross-check against full list: every mask which is put and touches the rect must be found
+	C4Rect Rect = rRect;
+	if (Rect.Wdt <= 0) Rect.Wdt = 1;
+	if (Rect.Hgt <= 0) Rect.Hgt = 1;
+	for (C4SolidMask *pSolid = First; pSolid; pSolid = pSolid->Next)
+		if (pSolid->MaskPut)
+		{
+			C4Rect PutRect = pSolid->MaskPutRect;
+			if (PutRect.Wdt <= 0) PutRect.Wdt = 1;
+			if (PutRect.Hgt <= 0) PutRect.Hgt = 1;
+			if (PutRect.Overlap(Rect) && !std::binary_search(rMasks.begin(), rMasks.end(), pSolid, [](C4SolidMask *a, C4SolidMask *b) { return a->Serial < b->Serial; }))
+			{
+				LogF("SolidMask index: mask of %s at (%d, %d, %d, %d) missing", pSolid->pForObject->GetName(), pSolid->MaskPutRect.x, pSolid->MaskPutRect.y, pSolid->MaskPutRect.Wdt, pSolid->MaskPutRect.Hgt);
+				assert(false);
+			}
+		}
+#endif
+}
+
 C4SolidMask::C4SolidMask(C4Object *pForObject) : pForObject(pForObject)
 {
 	// zero fields
+	Serial = NextSerial++;
+	IndexCells.Default();
+	MaskPutRect.Default();
 	MaskPut = false;
 	MaskPutRotation = 0;
 	MaskRemovalX = MaskRemovalY = 0;
@@ -424,12 +542,15 @@ C4SolidMask::~C4SolidMask()
 	if (Prev) Prev->Next = Next;
 	if (First == this) First = Next;
 	if (Last == this) Last = Prev;
+	RemoveFromIndex();
 	// clear fields
 	Clear();
 }
 
 C4SolidMask *C4SolidMask::First = nullptr;
 C4SolidMask *C4SolidMask::Last = nullptr;
+std::unordered_map<uint32_t, std::vector<C4SolidMask *>> C4SolidMask::Index;
+uint32_t C4SolidMask::NextSerial = 0;
 
 #ifdef SOLIDMASK_DEBUG
 
@@ -22,6 +22,14 @@
 #include <C4ObjectList.h>
 #include <C4Shape.h>
 
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// cell size of the solid mask index
+const int32_t C4SolidMaskCellWdt = 64,
+              C4SolidMaskCellHgt = 64;
+
 class C4SolidMask
 {
 protected:
@@ -40,6 +48,19 @@ protected:
 
 	C4Object *pForObject;
 
+	// spatial index of all solid masks, keyed by cell; a mask is registered in all cells its put rect touches
+	static std::unordered_map<uint32_t, std::vector<C4SolidMask *>> Index;
+	static uint32_t NextSerial;
+	uint32_t Serial; // creation order, which is also the order in the linked list
+	C4Rect IndexCells; // cells this mask is registered in; Wdt is 0 if not registered
+
+	static C4Rect GetCells(const C4Rect &rRect); // cells touched by rRect; empty rects touch the cell of their origin
+	static uint32_t GetCellKey(int32_t iCellX, int32_t iCellY);
+	void UpdateIndex(); // register at current MaskPutRect
+	void RemoveFromIndex();
+	// all masks that may overlap rRect, in linked list order; superset of the masks actually overlapping
+	static void GetCandidates(const C4Rect &rRect, std::vector<C4SolidMask *> &rMasks);
+
 	// provides density within put SolidMask of an object
 	class DensityProvider : public C4DensityProvider
 	{
@@ -59,6 +80,10 @@ protected:
 	void PutTemporary(C4Rect where);
 	// Reput and update Matbuf after landscape change underneath
 	void Repair(C4Rect where);
+	// Same for all masks overlapping where, in the order required for landscape changes
+	static void RemoveTemporaryAll(C4Rect where);
+	static void PutTemporaryAll(C4Rect where);
+	static void RepairAll(C4Rect where);
 
 	friend class C4Landscape;
 	friend class DensityProvider;
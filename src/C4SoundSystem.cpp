@@ -115,9 +115,6 @@ void C4SoundSystem::LoadEffects(C4Group &group)
 		group.ResetSearch();
 		while (group.FindNextEntry(fileType, filename))
 		{
-			// Try to find existing sample of the same name
-			const auto existingSample = std::find_if(samples.cbegin(), samples.cend(),
-				[&](const auto &sample) { return SEqualNoCase(filename, sample.name.c_str()); });
 			// Load sample
 			StdBuf buf;
 			if (!group.LoadEntry(filename, buf)) continue;
@@ -125,7 +122,13 @@ void C4SoundSystem::LoadEffects(C4Group &group)
 			{
 				samples.emplace_back(filename, buf.getData(), buf.getSize());
 				// Overload (i.e. remove) existing sample of the same name
-				if (existingSample != samples.cend()) samples.erase(existingSample);
+				const auto [indexIt, inserted] = sampleIndex.try_emplace(GetIndexKey(filename), std::prev(samples.end()));
+				if (!inserted)
+				{
+					samples.erase(indexIt->second);
+					indexIt->second = std::prev(samples.end());
+				}
+				matchCache.clear();
 			}
 			catch (const std::runtime_error &e)
 			{
@@ -269,17 +272,12 @@ bool C4SoundSystem::Instance::IsNear(const C4Object &obj2) const
 auto C4SoundSystem::FindInst(const char *wildcard, const C4Object *const obj) ->
 	std::optional<decltype(Sample::instances)::iterator>
 {
-	const auto wildcardStr = PrepareFilename(wildcard);
-	wildcard = wildcardStr.c_str();
-
-	for (auto &sample : samples)
+	for (const auto sample : GetMatches(PrepareFilename(wildcard)))
 	{
-		// Skip samples whose names do not match the wildcard
-		if (!WildcardMatch(wildcard, sample.name.c_str())) continue;
 		// Try to find an instance that is bound to obj
-		auto it = std::find_if(sample.instances.begin(), sample.instances.end(),
+		auto it = std::find_if(sample->instances.begin(), sample->instances.end(),
 			[&](const auto &inst) { return inst.GetObj() == obj; });
-		if (it != sample.instances.end()) return it;
+		if (it != sample->instances.end()) return it;
 	}
 
 	// Not found
@@ -304,31 +302,21 @@ auto C4SoundSystem::NewInstance(const char *filename, const bool loop,
 	if (!Application.AudioSystem) return nullptr;
 
 	const auto filenameStr = PrepareFilename(filename);
-	filename = filenameStr.c_str();
 
 	Sample *sample;
 	// Search for matching file if name contains no wildcard
 	if (filenameStr.find('?') == std::string::npos)
 	{
-		const auto end = samples.end();
-		const auto it = std::find_if(samples.begin(), end,
-			[&](const auto &sample) { return SEqualNoCase(filename, sample.name.c_str()); });
+		const auto it = sampleIndex.find(GetIndexKey(filenameStr));
 		// File not found
-		if (it == end) return nullptr;
+		if (it == sampleIndex.end()) return nullptr;
 		// Success: Found the file
-		sample = &*it;
+		sample = &*it->second;
 	}
 	// Randomly select any matching file if name contains wildcard
 	else
 	{
-		std::vector<Sample *> matches;
-		for (auto &sample : samples)
-		{
-			if (WildcardMatch(filename, sample.name.c_str()))
-			{
-				matches.push_back(&sample);
-			}
-		}
+		const auto &matches = GetMatches(filenameStr);
 		// File not found
 		if (matches.empty()) return nullptr;
 		// Success: Randomly select any of the matching files
@@ -364,3 +352,27 @@ std::string C4SoundSystem::PrepareFilename(const char *const filename)
 	std::replace(result.begin(), result.end(), '*', '?');
 	return result;
 }
+
+std::string C4SoundSystem::GetIndexKey(std::string name)
+{
+	std::transform(name.begin(), name.end(), name.begin(), [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return name;
+}
+
+auto C4SoundSystem::GetMatches(const std::string &wildcard) -> const std::vector<Sample *> &
+{
+	if (const auto it = matchCache.find(wildcard); it != matchCache.end()) return it->second;
+
+	// Script generated names could fill the cache forever
+	if (matchCache.size() >= MaxCachedPatterns) matchCache.clear();
+
+	std::vector<Sample *> matches;
+	for (auto &sample : samples)
+	{
+		if (WildcardMatch(wildcard.c_str(), sample.name.c_str()))
+		{
+			matches.push_back(&sample);
+		}
+	}
+	return matchCache.emplace(wildcard, std::move(matches)).first->second;
+}
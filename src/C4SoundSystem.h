@@ -27,7 +27,9 @@
 #include <list>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <variant>
+#include <vector>
 
 bool IsSoundPlaying(const char *name, const C4Object *obj);
 void SoundLevel(const char *name, C4Object *obj, std::int32_t iLevel);
@@ -60,12 +62,48 @@ public:
 private:
 	struct Instance;
 
+	// Keeps freed list nodes for reuse, so playing sounds does not hit the heap every time.
+	// Only used from the main thread.
+	template<typename T>
+	struct PoolAllocator
+	{
+		using value_type = T;
+
+		PoolAllocator() = default;
+		template<typename U> PoolAllocator(const PoolAllocator<U> &) {}
+
+		T *allocate(const std::size_t n)
+		{
+			if (n != 1 || freeNodes.empty()) return static_cast<T *>(::operator new(n * sizeof(T)));
+			const auto node = freeNodes.back();
+			freeNodes.pop_back();
+			return static_cast<T *>(node);
+		}
+
+		void deallocate(T *const p, const std::size_t n)
+		{
+			if (n == 1 && freeNodes.size() < MaxFreeNodes) freeNodes.push_back(p);
+			else ::operator delete(p);
+		}
+
+		template<typename U> bool operator==(const PoolAllocator<U> &) const { return true; }
+
+	private:
+		struct FreeList : std::vector<void *>
+		{
+			~FreeList() { for (const auto node : *this) ::operator delete(node); }
+		};
+
+		static constexpr std::size_t MaxFreeNodes = 256;
+		static inline FreeList freeNodes;
+	};
+
 	struct Sample
 	{
 		const std::string name;
 		const std::unique_ptr<C4AudioSystem::SoundFile> sample;
 		const std::uint32_t duration;
-		std::list<Instance> instances;
+		std::list<Instance, PoolAllocator<Instance>> instances;
 
 		Sample(const char *const name, const void *const buf, const std::size_t size);
 		Sample(const Sample &) = delete;
@@ -123,7 +161,12 @@ private:
 	};
 
 	static constexpr std::int32_t MaxSoundInstances = 20;
+	static constexpr std::size_t MaxCachedPatterns = 256;
 	std::list<Sample> samples;
+	// Samples by lower case name
+	std::unordered_map<std::string, decltype(samples)::iterator> sampleIndex;
+	// Matching samples in list order by prepared name or wildcard
+	std::unordered_map<std::string, std::vector<Sample *>> matchCache;
 
 	// Returns a sound instance that matches the specified name and object.
 	std::optional<decltype(Sample::instances)::iterator> FindInst(
@@ -136,6 +179,9 @@ private:
 		std::int32_t volume, std::int32_t pan, C4Object *obj, std::int32_t falloffDistance);
 	// Adds default file extension if missing and replaces "*" with "?"
 	static std::string PrepareFilename(const char *filename);
+	static std::string GetIndexKey(std::string name);
+	// Returns all samples matching the prepared wildcard, in list order
+	const std::vector<Sample *> &GetMatches(const std::string &wildcard);
 
 	friend bool IsSoundPlaying(const char *, const C4Object *);
 	friend void SoundLevel(const char *, C4Object *, std::int32_t);
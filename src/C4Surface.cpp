@@ -34,6 +34,7 @@
 #include <cstdint>
 #include <memory>
 #include <stdexcept>
+#include <string>
 
 C4Surface::C4Surface() : fIsBackground(false)
 {
@@ -61,6 +62,9 @@ C4Surface &C4Surface::operator=(C4Surface &&other)
 {
 	using std::swap;
 
+	FinishPendingPNG();
+	other.FinishPendingPNG();
+
 #ifndef NDEBUG
 	swap(dbg_idx, other.dbg_idx);
 #endif
@@ -95,6 +99,7 @@ void C4Surface::Default()
 	ClipX = ClipY = ClipX2 = ClipY2 = 0;
 	Locked = 0;
 	fPrimary = false;
+	fPendingPNG = false;
 	ppTex = nullptr;
 	pMainSfc = nullptr;
 	ClrByOwnerClr = 0;
@@ -110,6 +115,12 @@ void C4Surface::Clear()
 {
 	// Undo all locks
 	while (Locked) Unlock();
+	// drop pending decode
+	if (fPendingPNG)
+	{
+		if (C4SurfaceLoadQueue::pActive) C4SurfaceLoadQueue::pActive->Discard(this);
+		fPendingPNG = false;
+	}
 	// release surface
 	FreeTextures();
 	ppTex = nullptr;
@@ -125,6 +136,14 @@ bool C4Surface::IsRenderTarget()
 	return fPrimary;
 }
 
+void C4Surface::FinishPendingPNGNow()
+{
+	if (C4SurfaceLoadQueue::pActive)
+		C4SurfaceLoadQueue::pActive->Finish(this);
+	else
+		fPendingPNG = false;
+}
+
 void C4Surface::NoClip()
 {
 	ClipX = 0; ClipY = 0; ClipX2 = Wdt - 1; ClipY2 = Hgt - 1;
@@ -491,6 +510,8 @@ bool C4Surface::GetSurfaceSize(int &irX, int &irY)
 
 bool C4Surface::Lock()
 {
+	// pixels must be present
+	FinishPendingPNG();
 	// lock main sfc
 	if (pMainSfc) if (!pMainSfc->Lock()) return false;
 	// not yet locked?
@@ -591,6 +612,7 @@ bool C4Surface::Unlock(bool noUpload)
 
 bool C4Surface::GetTexAt(C4TexRef **ppTexRef, int &rX, int &rY)
 {
+	FinishPendingPNG();
 	// texture present?
 	if (!ppTex) return false;
 	// get pos
@@ -918,6 +940,9 @@ bool C4Surface::ReadPNG(CStdStream &hGroup)
 	std::unique_ptr<uint8_t[]> pData(new uint8_t[iSize]);
 	// load file into mem
 	hGroup.Read(pData.get(), iSize);
+	// decode later if a load queue is running
+	if (C4SurfaceLoadQueue::pActive)
+		return C4SurfaceLoadQueue::pActive->Add(this, std::move(pData), iSize);
 	// load as png file
 	std::unique_ptr<StdBitmap> bmp;
 	std::uint32_t width, height; bool useAlpha;
@@ -939,6 +964,11 @@ bool C4Surface::ReadPNG(CStdStream &hGroup)
 	if (!bmp) return false;
 	// create surface(s) - do not create an 8bit-buffer!
 	if (!Create(width, height)) return false;
+	return SetPNGPixels(*bmp, useAlpha);
+}
+
+bool C4Surface::SetPNGPixels(StdBitmap &bmp, bool useAlpha)
+{
 	// lock for writing data
 	if (!Lock()) return false;
 	if (!ppTex)
@@ -965,7 +995,7 @@ bool C4Surface::ReadPNG(CStdStream &hGroup)
 				// Optimize the easy case of a png in the same format as the display
 				// 32 bit
 				uint32_t *pPix = reinterpret_cast<uint32_t *>((reinterpret_cast<char *>(pTexRef->texLock.pBits)) + iY * pTexRef->texLock.Pitch);
-				memcpy(pPix, static_cast<const std::uint32_t *>(bmp->GetPixelAddr32(0, rY)) +
+				memcpy(pPix, static_cast<const std::uint32_t *>(bmp.GetPixelAddr32(0, rY)) +
 					tX * iTexSize, maxX * 4);
 				int iX = maxX;
 				while (iX--) { if (reinterpret_cast<uint8_t *>(pPix)[3] == 0xff) *pPix = 0xff000000; ++pPix; }
@@ -976,7 +1006,7 @@ bool C4Surface::ReadPNG(CStdStream &hGroup)
 				// Loop through every pixel and convert
 				for (int iX = 0; iX < maxX; ++iX)
 				{
-					uint32_t dwCol = bmp->GetPixel(iX + tX * iTexSize, rY);
+					uint32_t dwCol = bmp.GetPixel(iX + tX * iTexSize, rY);
 					// if color is fully transparent, ensure it's black
 					if (dwCol >> 24 == 0xff) dwCol = 0xff000000;
 					// set pix in surface
@@ -1010,6 +1040,7 @@ bool C4Surface::SavePNG(C4Group &hGroup, const char *szFilename, bool fSaveAlpha
 
 bool C4Surface::Copy(C4Surface &fromSfc)
 {
+	fromSfc.FinishPendingPNG();
 	// Clear anything old
 	Clear();
 	// Default to other surface's color depth
@@ -1300,4 +1331,146 @@ void C4TexMgr::IntUnlock()
 }
 
 C4TexMgr *pTexMgr;
+
+// C4SurfaceLoadQueue
+
+struct C4SurfaceLoadQueue::Job
+{
+	std::unique_ptr<uint8_t[]> Data; // file contents; must outlive PNG
+	std::unique_ptr<CPNGFile> PNG;
+	std::unique_ptr<StdBitmap> Bitmap;
+	std::uint32_t Width, Height;
+	bool useAlpha;
+	bool fStarted = false, fDone = false;
+	std::string Error;
+};
+
+C4SurfaceLoadQueue *C4SurfaceLoadQueue::pActive = nullptr;
+
+C4SurfaceLoadQueue::C4SurfaceLoadQueue(int32_t iThreads) : fStop(false), iDecodeCount(0)
+{
+	// default: keep one hardware thread for the main thread
+	if (iThreads <= 0) iThreads = static_cast<int32_t>(std::thread::hardware_concurrency()) - 1;
+	iThreads = std::max<int32_t>(iThreads, 1);
+	for (int32_t i = 0; i < iThreads; ++i)
+		Workers.emplace_back(&C4SurfaceLoadQueue::Execute, this);
+	pActive = this;
+}
+
+C4SurfaceLoadQueue::~C4SurfaceLoadQueue()
+{
+	FinishAll();
+	pActive = nullptr;
+	{
+		const std::lock_guard<std::mutex> lock{Mutex};
+		fStop = true;
+	}
+	TodoCond.notify_all();
+	for (auto &worker : Workers) worker.join();
+}
+
+bool C4SurfaceLoadQueue::Add(C4Surface *pSfc, std::unique_ptr<uint8_t[]> Data, std::size_t iSize)
+{
+	// read header now, so the surface gets its size immediately
+	auto job = std::make_unique<Job>();
+	job->Data = std::move(Data);
+	try
+	{
+		job->PNG = std::make_unique<CPNGFile>(job->Data.get(), iSize);
+		job->Width = job->PNG->Width(); job->Height = job->PNG->Height(); job->useAlpha = job->PNG->UsesAlpha();
+	}
+	catch (const std::runtime_error &e)
+	{
+		LogF("Could not create surface from PNG file: %s", e.what());
+		return false;
+	}
+	// textures may only be created on the main thread
+	if (!pSfc->Create(job->Width, job->Height)) return false;
+	pSfc->fPendingPNG = true;
+	{
+		const std::lock_guard<std::mutex> lock{Mutex};
+		Todo.push_back(job.get());
+		Jobs[pSfc] = std::move(job);
+	}
+	TodoCond.notify_one();
+	return true;
+}
+
+void C4SurfaceLoadQueue::Decode(Job &job)
+{
+	try
+	{
+		auto bmp = std::make_unique<StdBitmap>(job.Width, job.Height, job.useAlpha);
+		job.PNG->Decode(bmp->GetBytes());
+		job.Bitmap = std::move(bmp);
+	}
+	catch (const std::runtime_error &e)
+	{
+		job.Error = e.what();
+	}
+	job.PNG.reset();
+	job.Data.reset();
+}
+
+void C4SurfaceLoadQueue::Execute()
+{
+	std::unique_lock<std::mutex> lock{Mutex};
+	for (;;)
+	{
+		TodoCond.wait(lock, [this] { return fStop || !Todo.empty(); });
+		if (Todo.empty()) return;
+		Job *pJob = Todo.front(); Todo.pop_front();
+		pJob->fStarted = true;
+		lock.unlock();
+		Decode(*pJob);
+		lock.lock();
+		pJob->fDone = true;
+		DoneCond.notify_all();
+	}
+}
+
+std::unique_ptr<C4SurfaceLoadQueue::Job> C4SurfaceLoadQueue::Take(C4Surface *pSfc, bool fDecode)
+{
+	std::unique_lock<std::mutex> lock{Mutex};
+	const auto it = Jobs.find(pSfc);
+	if (it == Jobs.end()) return nullptr;
+	auto job = std::move(it->second);
+	Jobs.erase(it);
+	if (!job->fStarted)
+	{
+		// no worker got to it yet: do it here instead of waiting
+		Todo.erase(std::find(Todo.begin(), Todo.end(), job.get()));
+		lock.unlock();
+		if (fDecode) Decode(*job);
+		return job;
+	}
+	DoneCond.wait(lock, [&job] { return job->fDone; });
+	return job;
+}
+
+void C4SurfaceLoadQueue::Finish(C4Surface *pSfc)
+{
+	const auto job = Take(pSfc, true);
+	pSfc->fPendingPNG = false;
+	if (!job) return;
+	++iDecodeCount;
+	if (!job->Bitmap)
+	{
+		LogF("Could not create surface from PNG file: %s", job->Error.c_str());
+		return;
+	}
+	pSfc->SetPNGPixels(*job->Bitmap, job->useAlpha);
+}
+
+void C4SurfaceLoadQueue::Discard(C4Surface *pSfc)
+{
+	Take(pSfc, false);
+	pSfc->fPendingPNG = false;
+}
+
+void C4SurfaceLoadQueue::FinishAll()
+{
+	while (!Jobs.empty())
+		Finish(Jobs.begin()->first);
+}
 const uint8_t FColors[] = { 31, 16, 39, 47, 55, 63, 71, 79, 87, 95, 23, 30, 99, 103 };
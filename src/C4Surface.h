@@ -26,7 +26,14 @@
 #include <GL/glew.h>
 #endif
 
+#include <condition_variable>
+#include <deque>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 // config settings
 #define C4GFXCFG_NO_ALPHA_ADD    1
@@ -65,6 +72,7 @@ extern CStdDDraw *lpDDraw;
 
 class C4Group;
 class C4GroupSet;
+class StdBitmap;
 
 class C4Surface
 {
@@ -122,10 +130,14 @@ public:
 private:
 	bool CreateTextures(); // create ppTex-array
 	void FreeTextures(); // free ppTex-array if existent
+	bool SetPNGPixels(StdBitmap &bmp, bool useAlpha); // copy decoded png into textures
+	void FinishPendingPNG() { if (fPendingPNG) FinishPendingPNGNow(); }
+	void FinishPendingPNGNow();
 
 	friend class CStdDDraw;
 	friend class CPattern;
 	friend class CStdGL;
+	friend class C4SurfaceLoadQueue;
 
 public:
 	int Wdt, Hgt; // size of surface
@@ -148,6 +160,7 @@ public:
 private:
 	int Locked;
 	bool fPrimary;
+	bool fPendingPNG; // pixels still being decoded by C4SurfaceLoadQueue
 
 	bool IsSingleSurface() const { return iTexX * iTexY == 1; } // return whether surface is not split
 };
@@ -207,3 +220,40 @@ public:
 };
 
 extern C4TexMgr *pTexMgr;
+
+// Decodes PNG files read by C4Surface::ReadPNG on worker threads while it exists
+// Surfaces are created immediately; pixels are uploaded on the main thread once a surface is accessed or the queue is finished
+class C4SurfaceLoadQueue
+{
+public:
+	C4SurfaceLoadQueue(int32_t iThreads);
+	~C4SurfaceLoadQueue();
+
+	C4SurfaceLoadQueue(const C4SurfaceLoadQueue &) = delete;
+	C4SurfaceLoadQueue &operator=(const C4SurfaceLoadQueue &) = delete;
+
+public:
+	static C4SurfaceLoadQueue *pActive; // queue used by ReadPNG; nullptr for immediate decoding
+
+	bool Add(C4Surface *pSfc, std::unique_ptr<uint8_t[]> Data, std::size_t iSize);
+	void Finish(C4Surface *pSfc); // wait for decoding of this surface and upload it
+	void Discard(C4Surface *pSfc); // surface is cleared: drop its job
+	void FinishAll();
+	int32_t GetThreadCount() const { return static_cast<int32_t>(Workers.size()); }
+	int32_t GetDecodeCount() const { return iDecodeCount; }
+
+private:
+	struct Job;
+
+	void Execute(); // worker thread
+	void Decode(Job &job);
+	std::unique_ptr<Job> Take(C4Surface *pSfc, bool fDecode); // remove job; decodes here if no worker has started it yet
+
+	std::vector<std::thread> Workers;
+	std::unordered_map<C4Surface *, std::unique_ptr<Job>> Jobs;
+	std::deque<Job *> Todo;
+	std::mutex Mutex;
+	std::condition_variable TodoCond, DoneCond;
+	bool fStop;
+	int32_t iDecodeCount;
+};
@@ -57,8 +57,10 @@ public:
 protected:
 	int32_t RemoveNullZones();
 	C4TransferZone *First;
+	uint32_t Generation; // changed whenever zones are added, removed or moved
 
 public:
+	uint32_t GetGeneration() const { return Generation; }
 	void Default();
 	void Clear();
 	void ClearUsed();
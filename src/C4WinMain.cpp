@@ -175,6 +175,8 @@ int main()
 
 static void crash_handler(int signo)
 {
+	// get pending log lines out before the crash report
+	FlushLogOnCrash();
 	int logfd = STDERR_FILENO;
 	for (;;)
 	{
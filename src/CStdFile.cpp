@@ -44,7 +44,7 @@ CStdFile::~CStdFile()
 	Close();
 }
 
-bool CStdFile::Create(const char *szFilename, bool fCompressed, bool fExecutable)
+bool CStdFile::Create(const char *szFilename, bool fCompressed, bool fExecutable, int iCompressionLevel)
 {
 	SCopy(szFilename, Name, _MAX_PATH);
 	// Set modes
@@ -54,7 +54,7 @@ bool CStdFile::Create(const char *szFilename, bool fCompressed, bool fExecutable
 	{
 		try
 		{
-			writeCompressedFile.reset(new StdGzCompressedFile::Write{szFilename});
+			writeCompressedFile.reset(new StdGzCompressedFile::Write{szFilename, iCompressionLevel});
 		}
 		catch (const StdGzCompressedFile::Exception &)
 		{
@@ -53,7 +53,7 @@ protected:
 	bool ModeWrite;
 
 public:
-	bool Create(const char *szFileName, bool fCompressed = false, bool fExecutable = false);
+	bool Create(const char *szFileName, bool fCompressed = false, bool fExecutable = false, int iCompressionLevel = Z_BEST_COMPRESSION);
 	bool Open(const char *szFileName, bool fCompressed = false);
 	bool Append(const char *szFilename); // append (uncompressed only)
 	bool Close();
@@ -515,7 +515,7 @@ struct StdPtrAdapt
 			}
 			else
 			{
-				bool fNull = !!rpObj;
+				bool fNull = !rpObj;
 				pComp->Value(fNull);
 				// Null? Nothing further to do
 				if (fNull) return;
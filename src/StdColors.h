@@ -375,6 +375,8 @@ private:
 	bool fFadeTransparent; // if set, ReduceModulation and AddModulation fade transparent instead of black
 	int iResolutionX, iResolutionY;
 
+	void GetCellRange(int cx, int cy, int iRadius, int &ix0, int &iy0, int &ix1, int &iy1) const; // cells that may be within iRadius of cx/cy
+
 public:
 	enum { iDefResolutionX = 64, iDefResolutionY = 64 };
 
@@ -29,6 +29,7 @@
 
 #include <stdio.h>
 #include <limits.h>
+#include <algorithm>
 #include <cmath>
 #include <numbers>
 
@@ -332,55 +333,71 @@ void CClrModAddMap::Reset(int iResX, int iResY, int iWdtPx, int iHgtPx, int iOff
 	}
 }
 
+void CClrModAddMap::GetCellRange(int cx, int cy, int iRadius, int &ix0, int &iy0, int &ix1, int &iy1) const
+{
+	// cells at least iRadius away in one direction cannot be within iRadius
+	iRadius = Abs(iRadius);
+	ix0 = std::max(0, (cx - iRadius - iOffX) / iResolutionX);
+	iy0 = std::max(0, (cy - iRadius - iOffY) / iResolutionY);
+	ix1 = std::min(iWdt - 1, (cx + iRadius - iOffX) / iResolutionX + 1);
+	iy1 = std::min(iHgt - 1, (cy + iRadius - iOffY) / iResolutionY + 1);
+}
+
 void CClrModAddMap::ReduceModulation(int cx, int cy, int iRadius1, int iRadius2)
 {
 	// reveal all within iRadius1; fade off squared until iRadius2
-	int i = iMapSize, x = iOffX, y = iOffY, xe = iWdt * iResolutionX + iOffX;
+	int ix0, iy0, ix1, iy1;
+	GetCellRange(cx, cy, iRadius2, ix0, iy0, ix1, iy1);
 	int iRadius1Sq = iRadius1 * iRadius1, iRadius2Sq = iRadius2 * iRadius2;
-	for (CClrModAdd *pCurr = pMap; i--; ++pCurr)
+	for (int iy = iy0; iy <= iy1; ++iy)
 	{
-		int d = (x - cx) * (x - cx) + (y - cy) * (y - cy);
-		if (d < iRadius2Sq)
+		const int y = iOffY + iy * iResolutionY;
+		CClrModAdd *pCurr = pMap + iy * iWdt + ix0;
+		for (int ix = ix0, x = iOffX + ix0 * iResolutionX; ix <= ix1; ++ix, ++pCurr, x += iResolutionX)
 		{
-			if (d < iRadius1Sq)
-				pCurr->dwModClr = 0xffffff; // full visibility
-			else
+			int d = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+			if (d < iRadius2Sq)
 			{
-				// partly visible
-				int iVis = (iRadius2Sq - d) * 255 / (iRadius2Sq - iRadius1Sq);
-				pCurr->dwModClr = fFadeTransparent ? (0xffffff + (std::min<uint32_t>(pCurr->dwModClr >> 24, 255 - iVis) << 24))
-					: std::max<uint32_t>(pCurr->dwModClr, RGB(iVis, iVis, iVis));
+				if (d < iRadius1Sq)
+					pCurr->dwModClr = 0xffffff; // full visibility
+				else
+				{
+					// partly visible
+					int iVis = (iRadius2Sq - d) * 255 / (iRadius2Sq - iRadius1Sq);
+					pCurr->dwModClr = fFadeTransparent ? (0xffffff + (std::min<uint32_t>(pCurr->dwModClr >> 24, 255 - iVis) << 24))
+						: std::max<uint32_t>(pCurr->dwModClr, RGB(iVis, iVis, iVis));
+				}
 			}
 		}
-		// next pos
-		x += iResolutionX;
-		if (x >= xe) { x = iOffX; y += iResolutionY; }
 	}
 }
 
 void CClrModAddMap::AddModulation(int cx, int cy, int iRadius1, int iRadius2, uint8_t byTransparency)
 {
 	// hide all within iRadius1; fade off squared until iRadius2
-	int i = iMapSize, x = iOffX, y = iOffY, xe = iWdt * iResolutionX + iOffX;
+	int ix0, iy0, ix1, iy1;
+	GetCellRange(cx, cy, iRadius2, ix0, iy0, ix1, iy1);
 	int iRadius1Sq = iRadius1 * iRadius1, iRadius2Sq = iRadius2 * iRadius2;
-	for (CClrModAdd *pCurr = pMap; i--; ++pCurr)
+	for (int iy = iy0; iy <= iy1; ++iy)
 	{
-		int d = (x - cx) * (x - cx) + (y - cy) * (y - cy);
-		if (d < iRadius2Sq)
+		const int y = iOffY + iy * iResolutionY;
+		CClrModAdd *pCurr = pMap + iy * iWdt + ix0;
+		for (int ix = ix0, x = iOffX + ix0 * iResolutionX; ix <= ix1; ++ix, ++pCurr, x += iResolutionX)
 		{
-			if (d < iRadius1Sq && !byTransparency)
-				pCurr->dwModClr = 0x000000; // full invisibility
-			else
+			int d = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+			if (d < iRadius2Sq)
 			{
-				// partly visible
-				int iVis = std::min<int>(255 - std::min<int>((iRadius2Sq - d) * 255 / (iRadius2Sq - iRadius1Sq), 255) + byTransparency, 255);
-				pCurr->dwModClr = fFadeTransparent ? (0xffffff + (std::max<uint32_t>(pCurr->dwModClr >> 24, 255 - iVis) << 24))
-					: std::min<uint32_t>(pCurr->dwModClr, RGB(iVis, iVis, iVis));
+				if (d < iRadius1Sq && !byTransparency)
+					pCurr->dwModClr = 0x000000; // full invisibility
+				else
+				{
+					// partly visible
+					int iVis = std::min<int>(255 - std::min<int>((iRadius2Sq - d) * 255 / (iRadius2Sq - iRadius1Sq), 255) + byTransparency, 255);
+					pCurr->dwModClr = fFadeTransparent ? (0xffffff + (std::max<uint32_t>(pCurr->dwModClr >> 24, 255 - iVis) << 24))
+						: std::min<uint32_t>(pCurr->dwModClr, RGB(iVis, iVis, iVis));
+				}
 			}
 		}
-		// next pos
-		x += iResolutionX;
-		if (x >= xe) { x = iOffX; y += iResolutionY; }
 	}
 }
 
@@ -511,6 +528,8 @@ void CStdDDraw::Default()
 	DefRamp.Default();
 	lpPrimary = lpBack = nullptr;
 	fUseClrModMap = false;
+	sfcBatchTarget = nullptr;
+	BatchLines.clear(); BatchPixs.clear(); BatchSprites.clear();
 }
 
 void CStdDDraw::Clear()
@@ -1086,6 +1105,90 @@ void CStdDDraw::DrawPix(C4Surface *sfcDest, float tx, float ty, uint32_t dwClr)
 	DrawPixInt(sfcDest, tx, ty, dwClr);
 }
 
+void CStdDDraw::BeginBatch(C4Surface *sfcTarget)
+{
+	// draw anything left over from a previous batch
+	if (sfcBatchTarget) FlushBatch();
+	sfcBatchTarget = sfcTarget;
+}
+
+void CStdDDraw::BatchLineDw(float x1, float y1, float x2, float y2, uint32_t dwClr)
+{
+	// only valid between BeginBatch and FlushBatch
+	if (!sfcBatchTarget) return;
+	ClrByCurrentBlitMod(dwClr);
+	BatchLines.push_back({x1, y1, x2, y2, dwClr});
+}
+
+void CStdDDraw::BatchPix(float tx, float ty, uint32_t dwClr)
+{
+	if (!sfcBatchTarget) return;
+	ClrByCurrentBlitMod(dwClr);
+	// apply modulation map now, so the backend doesn't have to
+	if (fUseClrModMap)
+		ModulateClr(dwClr, pClrModMap->GetModAt(static_cast<int>(tx), static_cast<int>(ty)));
+	BatchPixs.push_back({tx, ty, dwClr});
+}
+
+void CStdDDraw::BatchBlit(C4Surface *sfcSource, float fx, float fy, float fwdt, float fhgt, int tx, int ty, int twdt, int thgt)
+{
+	if (!sfcBatchTarget || !sfcSource) return;
+	BatchSprites.push_back({sfcSource, fx, fy, fwdt, fhgt, tx, ty, twdt, thgt, BlitModulateClr, BlitModulated});
+}
+
+void CStdDDraw::FlushBatch()
+{
+	C4Surface *sfcTarget = sfcBatchTarget;
+	if (!sfcTarget) return;
+	sfcBatchTarget = nullptr;
+	// modulation has been applied when adding
+	const bool fWasModulated = BlitModulated;
+	const uint32_t dwWasModClr = BlitModulateClr;
+	BlitModulated = false;
+	if (!BatchLines.empty()) DrawLinesDw(sfcTarget, BatchLines.data(), BatchLines.size());
+	if (!BatchPixs.empty()) DrawPixsInt(sfcTarget, BatchPixs.data(), BatchPixs.size());
+	if (!BatchSprites.empty())
+	{
+		// pass on consecutive runs of the same source surface; sprites must not be reordered,
+		// because overlapping sprites of different surfaces are drawn in submission order
+		size_t iStart = 0;
+		for (size_t i = 1; i <= BatchSprites.size(); ++i)
+			if (i == BatchSprites.size() || BatchSprites[i].sfcSource != BatchSprites[iStart].sfcSource)
+			{
+				BlitSprites(sfcTarget, BatchSprites.data() + iStart, i - iStart);
+				iStart = i;
+			}
+	}
+	BlitModulated = fWasModulated;
+	BlitModulateClr = dwWasModClr;
+	// keep buffers for the next batch
+	BatchLines.clear(); BatchPixs.clear(); BatchSprites.clear();
+}
+
+void CStdDDraw::DrawLinesDw(C4Surface *sfcTarget, const CStdBatchLine *pLines, size_t iCount)
+{
+	for (size_t i = 0; i < iCount; ++i)
+		DrawLineDw(sfcTarget, pLines[i].x1, pLines[i].y1, pLines[i].x2, pLines[i].y2, pLines[i].dwClr);
+}
+
+void CStdDDraw::DrawPixsInt(C4Surface *sfcDest, const CStdBatchPix *pPixs, size_t iCount)
+{
+	for (size_t i = 0; i < iCount; ++i)
+		DrawPixInt(sfcDest, pPixs[i].x, pPixs[i].y, pPixs[i].dwClr);
+}
+
+void CStdDDraw::BlitSprites(C4Surface *sfcTarget, const CStdBatchSprite *pSprites, size_t iCount)
+{
+	for (size_t i = 0; i < iCount; ++i)
+	{
+		const CStdBatchSprite &rSprite = pSprites[i];
+		BlitModulated = rSprite.fModulated;
+		BlitModulateClr = rSprite.dwModClr;
+		Blit(rSprite.sfcSource, rSprite.fx, rSprite.fy, rSprite.fwdt, rSprite.fhgt, sfcTarget, rSprite.tx, rSprite.ty, rSprite.twdt, rSprite.thgt, true);
+	}
+	BlitModulated = false;
+}
+
 void CStdDDraw::DrawBox(C4Surface *sfcDest, int iX1, int iY1, int iX2, int iY2, uint8_t byCol)
 {
 	// get color
@@ -268,6 +268,28 @@ protected:
 	static CStdShaderProgram *currentShaderProgram;
 };
 
+// primitives and sprites collected for batched drawing
+struct CStdBatchLine
+{
+	float x1, y1, x2, y2;
+	uint32_t dwClr;
+};
+
+struct CStdBatchPix
+{
+	float x, y;
+	uint32_t dwClr;
+};
+
+struct CStdBatchSprite
+{
+	C4Surface *sfcSource;
+	float fx, fy, fwdt, fhgt; // source rect
+	int tx, ty, twdt, thgt; // target rect
+	uint32_t dwModClr; // blit modulation
+	bool fModulated;
+};
+
 // direct draw encapsulation
 class CStdDDraw
 {
@@ -297,6 +319,10 @@ protected:
 	bool fUseClrModMap; // if set, pClrModMap will be checked for color modulations
 	float texIndent;
 	float blitOffset;
+	C4Surface *sfcBatchTarget{nullptr}; // target of the current batch; nullptr if not batching
+	std::vector<CStdBatchLine> BatchLines;
+	std::vector<CStdBatchPix> BatchPixs;
+	std::vector<CStdBatchSprite> BatchSprites;
 
 public:
 	// General
@@ -379,6 +405,16 @@ public:
 	virtual void DrawLineDw(C4Surface *sfcTarget, float x1, float y1, float x2, float y2, uint32_t dwClr) = 0;
 	virtual void DrawQuadDw(C4Surface *sfcTarget, int *ipVtx, uint32_t dwClr1, uint32_t dwClr2, uint32_t dwClr3, uint32_t dwClr4) = 0;
 
+	// Batched drawing
+	// everything added between BeginBatch and FlushBatch is drawn by FlushBatch: lines first, then pixels, then sprites grouped by source surface
+	// blit modulation is applied when adding; the blit mode active at FlushBatch is used for all of it
+	void BeginBatch(C4Surface *sfcTarget);
+	void BatchLineDw(float x1, float y1, float x2, float y2, uint32_t dwClr);
+	void BatchPix(float tx, float ty, uint32_t dwClr);
+	void BatchBlit(C4Surface *sfcSource, float fx, float fy, float fwdt, float fhgt, int tx, int ty, int twdt, int thgt);
+	void FlushBatch();
+	bool IsBatching() const { return !!sfcBatchTarget; }
+
 	// gamma
 	void SetGamma(uint32_t dwClr1, uint32_t dwClr2, uint32_t dwClr3); // set gamma ramp
 	virtual void DisableGamma(); // reset gamma ramp to default
@@ -414,6 +450,9 @@ public:
 protected:
 	bool StringOut(const char *szText, C4Surface *sfcDest, int iTx, int iTy, uint32_t dwFCol, uint8_t byForm, bool fDoMarkup, CMarkup &Markup, CStdFont *pFont, float fZoom);
 	virtual void DrawPixInt(C4Surface *sfcDest, float tx, float ty, uint32_t dwCol) = 0; // without ClrModMap
+	virtual void DrawLinesDw(C4Surface *sfcTarget, const CStdBatchLine *pLines, size_t iCount); // without blit modulation
+	virtual void DrawPixsInt(C4Surface *sfcDest, const CStdBatchPix *pPixs, size_t iCount); // without blit modulation and ClrModMap
+	virtual void BlitSprites(C4Surface *sfcTarget, const CStdBatchSprite *pSprites, size_t iCount); // all sprites share the same source surface
 	bool CreatePrimaryClipper();
 	virtual bool CreatePrimarySurfaces() = 0;
 	bool Error(const char *szMsg);
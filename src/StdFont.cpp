@@ -26,6 +26,7 @@
 #include <StdMarkup.h>
 
 #include <cmath>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 
@@ -563,11 +564,78 @@ void CStdFont::Clear()
 	// font not yet initialized
 	*szFontName = 0;
 	id = 0;
+	ClearLayoutCache();
+}
+
+/* Layout cache */
+
+void CStdFont::ClearLayoutCache()
+{
+	LayoutIndex.clear();
+	LayoutCache.clear();
+}
+
+std::string CStdFont::GetLayoutKey(const char *szText, int32_t iWdt, float fZoom, bool fCheckMarkup, bool ignoreScale, size_t maxLines)
+{
+	// texts with images depend on the custom image handler's current state
+	const size_t iLen = std::strlen(szText);
+	if (iLen > LayoutCacheMaxTextLength || (fCheckMarkup && SSearch(szText, "{{"))) return {};
+	const struct
+	{
+		int32_t iWdt;
+		float fZoom;
+		uint32_t dwFlags;
+		uint32_t iMaxLines;
+	} params = { iWdt, fZoom, static_cast<uint32_t>(fCheckMarkup) | (static_cast<uint32_t>(ignoreScale) << 1), static_cast<uint32_t>(std::min<size_t>(maxLines, UINT32_MAX)) };
+	std::string key;
+	key.reserve(sizeof(params) + iLen);
+	key.append(reinterpret_cast<const char *>(&params), sizeof(params));
+	key.append(szText, iLen);
+	return key;
+}
+
+const CStdFont::LayoutResult *CStdFont::GetCachedLayout(const std::string &key)
+{
+	const auto it = LayoutIndex.find(key);
+	if (it == LayoutIndex.end()) { ++iLayoutCacheMisses; return nullptr; }
+	// move to front
+	LayoutCache.splice(LayoutCache.begin(), LayoutCache, it->second);
+	++iLayoutCacheHits;
+	return &it->second->second;
+}
+
+void CStdFont::AddCachedLayout(std::string &&key, LayoutResult &&result)
+{
+	// drop least recently used
+	if (LayoutCache.size() >= LayoutCacheSize)
+	{
+		LayoutIndex.erase(LayoutCache.back().first);
+		LayoutCache.pop_back();
+	}
+	LayoutCache.emplace_front(std::move(key), std::move(result));
+	LayoutIndex.emplace(LayoutCache.front().first, LayoutCache.begin());
 }
 
 /* Text size measurement */
 
 bool CStdFont::GetTextExtent(const char *szText, int32_t &rsx, int32_t &rsy, bool fCheckMarkup, bool ignoreScale)
+{
+	// safety
+	if (!szText) return false;
+	// cached?
+	std::string key = GetLayoutKey(szText, -1, 1.0f, fCheckMarkup, ignoreScale, 0);
+	if (!key.empty())
+		if (const auto *result = GetCachedLayout(key))
+		{
+			rsx = result->iWdt; rsy = result->iHgt;
+			return true;
+		}
+	if (!MeasureText(szText, rsx, rsy, fCheckMarkup, ignoreScale)) return false;
+	if (!key.empty()) AddCachedLayout(std::move(key), { rsx, rsy, {} });
+	return true;
+}
+
+bool CStdFont::MeasureText(const char *szText, int32_t &rsx, int32_t &rsy, bool fCheckMarkup, bool ignoreScale)
 {
 	float realScale = 1.f;
 	if (!ignoreScale)
@@ -640,6 +708,21 @@ int CStdFont::BreakMessage(const char *szMsg, int iWdt, StdStrBuf *pOut, bool fC
 {
 	// safety
 	if (!szMsg || !pOut) return 0;
+	// cached?
+	std::string key = GetLayoutKey(szMsg, iWdt, fZoom, fCheckMarkup, false, maxLines);
+	if (!key.empty())
+		if (const auto *result = GetCachedLayout(key))
+		{
+			pOut->Copy(result->Text.c_str(), result->Text.size());
+			return result->iHgt;
+		}
+	const int iHgt = BreakText(szMsg, iWdt, pOut, fCheckMarkup, fZoom, maxLines);
+	if (!key.empty()) AddCachedLayout(std::move(key), { 0, iHgt, std::string(pOut->getLength() ? pOut->getData() : "", pOut->getLength()) });
+	return iHgt;
+}
+
+int CStdFont::BreakText(const char *szMsg, int iWdt, StdStrBuf *pOut, bool fCheckMarkup, float fZoom, size_t maxLines)
+{
 	pOut->Clear();
 	uint32_t c;
 	const char *szPos = szMsg, // current parse position in the text
@@ -25,7 +25,11 @@
 #include <StdMarkup.h>
 #include <StdBuf.h>
 #include <stdio.h>
+#include <list>
 #include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #ifdef _WIN32
 #include <tchar.h>
 #endif
@@ -116,6 +120,24 @@ protected:
 	int iLineHgt; // height of one line of font (in pixels)
 	float scale = 1.f;
 
+	// recently measured and broken texts; cleared whenever the font is (re)initialized
+	struct LayoutResult
+	{
+		int32_t iWdt, iHgt;
+		std::string Text; // BreakMessage output
+	};
+	static constexpr size_t LayoutCacheSize = 512;
+	static constexpr size_t LayoutCacheMaxTextLength = 2048;
+	std::list<std::pair<std::string, LayoutResult>> LayoutCache; // most recently used first
+	std::unordered_map<std::string_view, decltype(LayoutCache)::iterator> LayoutIndex; // keys point into LayoutCache
+	int32_t iLayoutCacheHits = 0, iLayoutCacheMisses = 0;
+
+	std::string GetLayoutKey(const char *szText, int32_t iWdt, float fZoom, bool fCheckMarkup, bool ignoreScale, size_t maxLines);
+	const LayoutResult *GetCachedLayout(const std::string &key);
+	void AddCachedLayout(std::string &&key, LayoutResult &&result);
+	bool MeasureText(const char *szText, int32_t &rsx, int32_t &rsy, bool fCheckMarkup, bool ignoreScale);
+	int BreakText(const char *szMsg, int iWdt, class StdStrBuf *pOut, bool fCheckMarkup, float fZoom, size_t maxLines);
+
 public:
 	// draw ine line of text
 	void DrawText(C4Surface *sfcDest, int iX, int iY, uint32_t dwColor, const char *szText, uint32_t dwFlags, CMarkup &Markup, float fZoom);
@@ -140,6 +162,8 @@ public:
 	void Init(const char *szFontName, C4Surface *psfcFontSfc, int iIndent);
 
 	void Clear(); // clear font
+	void ClearLayoutCache();
+	void GetLayoutCacheStats(int32_t &riHits, int32_t &riMisses) const { riHits = iLayoutCacheHits; riMisses = iLayoutCacheMisses; }
 
 	// query whether font is initialized
 	bool IsInitialized() { return !!*szFontName; }
@@ -159,6 +183,7 @@ public:
 	void SetCustomImages(CustomImages *pHandler)
 	{
 		pCustomImages = pHandler;
+		ClearLayoutCache();
 	}
 };
 
@@ -483,6 +483,117 @@ void CStdGL::PerformBlt(CBltData &rBltData, C4TexRef *const pTex,
 	}
 }
 
+void CStdGL::BlitSprites(C4Surface *const sfcTarget,
+	const CStdBatchSprite *const pSprites, const size_t iCount)
+{
+	if (!iCount) return;
+	C4Surface *const sfcSource = pSprites[0].sfcSource;
+	// one draw call only covers plain sprites from a single texture;
+	// overlays, modulation maps, MOD2 and scaled output go through the regular blit
+	if (!sfcTarget->IsRenderTarget() || !sfcSource->ppTex || sfcSource->iTexX != 1 || sfcSource->iTexY != 1
+		|| (sfcSource->pMainSfc && sfcSource->pMainSfc->ppTex) || fUseClrModMap
+		|| (dwBlitMode & C4GFXBLIT_MOD2) || pApp->GetScale() != 1.f)
+	{
+		CStdDDraw::BlitSprites(sfcTarget, pSprites, iCount);
+		return;
+	}
+	if (ClipAll) return;
+	if (!PrepareRendering(sfcTarget)) return;
+
+	C4TexRef *const pTex = *sfcSource->ppTex;
+	const int iTexSize = pTex->iSize;
+	SetTexture();
+	// same modulation as PerformBlt, but with the color always taken from the vertices
+	uint32_t dwModMask = 0;
+	if (BlitShader)
+	{
+		BlitShader.Select();
+	}
+	else if (!Config.Graphics.NoAlphaAdd)
+	{
+		glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
+		glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB,      GL_MODULATE);
+		glTexEnvf(GL_TEXTURE_ENV, GL_RGB_SCALE,        1.0f);
+		glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_ALPHA,    GL_ADD);
+		glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB,      GL_TEXTURE);
+		glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_RGB,      GL_PRIMARY_COLOR);
+		glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA,    GL_TEXTURE);
+		glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA,    GL_PRIMARY_COLOR);
+		glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_RGB,     GL_SRC_COLOR);
+		glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_RGB,     GL_SRC_COLOR);
+		glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA,   GL_SRC_ALPHA);
+		glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA,   GL_SRC_ALPHA);
+	}
+	else
+	{
+		glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+		glTexEnvf(GL_TEXTURE_ENV, GL_RGB_SCALE,        1.0f);
+		dwModMask = 0xff000000;
+	}
+	glShadeModel(GL_FLAT);
+	glBindTexture(GL_TEXTURE_2D, pTex->texName);
+	// texture coordinates are given directly
+	glMatrixMode(GL_TEXTURE);
+	glLoadIdentity();
+	glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+
+	bool fFiltering = false;
+	glBegin(GL_QUADS);
+	for (size_t i = 0; i < iCount; ++i)
+	{
+		const CStdBatchSprite &rSprite = pSprites[i];
+		if (!rSprite.fwdt || !rSprite.fhgt || rSprite.twdt <= 0 || rSprite.thgt <= 0) continue;
+		// clip source to the texture
+		const float fTexBltLeft   = std::max<float>(0.0f, rSprite.fx);
+		const float fTexBltTop    = std::max<float>(0.0f, rSprite.fy);
+		const float fTexBltRight  = std::min<float>(static_cast<float>(iTexSize), rSprite.fx + rSprite.fwdt);
+		const float fTexBltBottom = std::min<float>(static_cast<float>(iTexSize), rSprite.fy + rSprite.fhgt);
+		if (fTexBltLeft >= fTexBltRight || fTexBltTop >= fTexBltBottom) continue;
+		// texture filtering can only be switched outside of glBegin/glEnd
+		const bool fExact = rSprite.fwdt == rSprite.twdt && rSprite.fhgt == rSprite.thgt;
+		if (fFiltering != (!fExact && !Config.Graphics.PointFiltering))
+		{
+			glEnd();
+			fFiltering = !fFiltering;
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, fFiltering ? GL_LINEAR : GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, fFiltering ? GL_LINEAR : GL_NEAREST);
+			glBegin(GL_QUADS);
+		}
+		// dest bounds and texture coordinates as calculated by Blit
+		const float scaleX = rSprite.twdt / rSprite.fwdt;
+		const float scaleY = rSprite.thgt / rSprite.fhgt;
+		const float scaleX2 = scaleX * (iTexSize + texIndent * 2);
+		const float scaleY2 = scaleY * (iTexSize + texIndent * 2);
+		const float tTexBltLeft  {(fTexBltLeft   - rSprite.fx) * scaleX + rSprite.tx + blitOffset};
+		const float tTexBltTop   {(fTexBltTop    - rSprite.fy) * scaleY + rSprite.ty + blitOffset};
+		const float tTexBltRight {(fTexBltRight  - rSprite.fx) * scaleX + rSprite.tx + blitOffset};
+		const float tTexBltBottom{(fTexBltBottom - rSprite.fy) * scaleY + rSprite.ty + blitOffset};
+		const float fTexLeft  {(fTexBltLeft + texIndent) / iTexSize};
+		const float fTexTop   {(fTexBltTop  + texIndent) / iTexSize};
+		const float fTexRight {fTexLeft + (tTexBltRight  - tTexBltLeft) / scaleX2};
+		const float fTexBottom{fTexTop  + (tTexBltBottom - tTexBltTop)  / scaleY2};
+
+		glColorDw((rSprite.fModulated ? rSprite.dwModClr : 0xffffff) | dwModMask);
+		glTexCoord2f(fTexLeft,  fTexTop);    glVertex2f(tTexBltLeft,  tTexBltTop);
+		glTexCoord2f(fTexRight, fTexTop);    glVertex2f(tTexBltRight, tTexBltTop);
+		glTexCoord2f(fTexRight, fTexBottom); glVertex2f(tTexBltRight, tTexBltBottom);
+		glTexCoord2f(fTexLeft,  fTexBottom); glVertex2f(tTexBltLeft,  tTexBltBottom);
+	}
+	glEnd();
+
+	if (BlitShader)
+	{
+		CStdShaderProgram::Deselect();
+	}
+	if (fFiltering)
+	{
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	}
+	ResetTexture();
+}
+
 void CStdGL::BlitLandscape(C4Surface *const sfcSource, C4Surface *const sfcSource2,
 	C4Surface *const sfcLiquidAnimation, const int fx, const int fy,
 	C4Surface *const sfcTarget, const int tx, const int ty, const int wdt, const int hgt)
@@ -841,6 +952,66 @@ void CStdGL::DrawPixInt(C4Surface *const sfcTarget,
 	glEnd();
 }
 
+void CStdGL::DrawLinesDw(C4Surface *const sfcTarget,
+	const CStdBatchLine *const pLines, const size_t iCount)
+{
+	// render target?
+	assert(sfcTarget->IsRenderTarget());
+	// prepare rendering to target
+	if (!PrepareRendering(sfcTarget)) return;
+
+	CStdGLShaderProgram::Deselect();
+
+	// set blitting state once for all lines
+	const int iAdditive = dwBlitMode & C4GFXBLIT_ADDITIVE;
+	// use a different blendfunc here, because GL_LINE_SMOOTH expects this one
+	glBlendFunc(GL_SRC_ALPHA, iAdditive ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+	glBegin(GL_LINES);
+	for (size_t i = 0; i < iCount; ++i)
+	{
+		const CStdBatchLine &rLine = pLines[i];
+		// global clr modulation map
+		uint32_t dwClr1 = rLine.dwClr, dwClr2 = rLine.dwClr;
+		if (fUseClrModMap)
+		{
+			ModulateClr(dwClr1, pClrModMap->GetModAt(
+				static_cast<int>(rLine.x1), static_cast<int>(rLine.y1)));
+			ModulateClr(dwClr2, pClrModMap->GetModAt(
+				static_cast<int>(rLine.x2), static_cast<int>(rLine.y2)));
+		}
+		// convert from clonk-alpha to GL_LINE_SMOOTH alpha
+		glColorDw(InvertRGBAAlpha(dwClr1));
+		glVertex2f(rLine.x1 + 0.5f, rLine.y1 + 0.5f);
+		glColorDw(InvertRGBAAlpha(dwClr2));
+		glVertex2f(rLine.x2 + 0.5f, rLine.y2 + 0.5f);
+	}
+	glEnd();
+}
+
+void CStdGL::DrawPixsInt(C4Surface *const sfcTarget,
+	const CStdBatchPix *const pPixs, const size_t iCount)
+{
+	// render target?
+	assert(sfcTarget->IsRenderTarget());
+
+	if (!PrepareRendering(sfcTarget)) return;
+
+	CStdGLShaderProgram::Deselect();
+
+	const int iAdditive = dwBlitMode & C4GFXBLIT_ADDITIVE;
+	// use a different blendfunc here because of GL_POINT_SMOOTH
+	glBlendFunc(GL_SRC_ALPHA, iAdditive ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+	// all points in one go
+	glBegin(GL_POINTS);
+	for (size_t i = 0; i < iCount; ++i)
+	{
+		// convert the alpha value for that blendfunc
+		glColorDw(InvertRGBAAlpha(pPixs[i].dwClr));
+		glVertex2f(pPixs[i].x + 0.5f, pPixs[i].y + 0.5f);
+	}
+	glEnd();
+}
+
 bool CStdGL::RestoreDeviceObjects()
 {
 	// safety
@@ -202,6 +202,7 @@ public:
 
 	// Blit
 	void PerformBlt(CBltData &rBltData, C4TexRef *pTex, uint32_t dwModClr, bool fMod2, bool fExact) override;
+	void BlitSprites(C4Surface *sfcTarget, const CStdBatchSprite *pSprites, size_t iCount) override;
 	virtual void BlitLandscape(C4Surface *sfcSource, C4Surface *sfcSource2, C4Surface *sfcLiquidAnimation, int fx, int fy,
 		C4Surface *sfcTarget, int tx, int ty, int wdt, int hgt) override;
 	void FillBG(uint32_t dwClr = 0) override;
@@ -210,6 +211,8 @@ public:
 	void DrawQuadDw(C4Surface *sfcTarget, int *ipVtx, uint32_t dwClr1, uint32_t dwClr2, uint32_t dwClr3, uint32_t dwClr4) override;
 	void DrawLineDw(C4Surface *sfcTarget, float x1, float y1, float x2, float y2, uint32_t dwClr) override;
 	void DrawPixInt(C4Surface *sfcDest, float tx, float ty, uint32_t dwCol) override;
+	void DrawLinesDw(C4Surface *sfcTarget, const CStdBatchLine *pLines, size_t iCount) override;
+	void DrawPixsInt(C4Surface *sfcDest, const CStdBatchPix *pPixs, size_t iCount) override;
 
 	// Gamma
 	virtual bool ApplyGammaRamp(CGammaControl &ramp, bool fForce) override;
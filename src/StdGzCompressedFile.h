@@ -73,7 +73,7 @@ class Write
 	bool magicBytesDone = false;
 
 public:
-	Write(const std::string &filename);
+	Write(const std::string &filename, int level = Z_BEST_COMPRESSION); // Z_NO_COMPRESSION for files that are read back right away
 	~Write() noexcept(false);
 	void WriteData(const uint8_t *const fromBuffer, const size_t size);
 
@@ -22,6 +22,17 @@
 
 class CStdNoGfx : public CStdDDraw
 {
+public:
+	// number of draw calls that would have reached the graphics device
+	struct DrawCallStats
+	{
+		uint32_t Blits, Lines, Pixels, Quads;
+		uint32_t LineBatches, PixBatches, SpriteBatches;
+	};
+
+protected:
+	DrawCallStats Stats{};
+
 public:
 	CStdNoGfx();
 	virtual ~CStdNoGfx();
@@ -34,10 +45,15 @@ public:
 	virtual bool OnResolutionChanged() override { return true; }
 	virtual bool PrepareRendering(C4Surface *) override { return true; }
 	virtual void FillBG(uint32_t dwClr = 0) override {}
-	virtual void PerformBlt(CBltData &, C4TexRef *, uint32_t, bool, bool) override {}
-	virtual void DrawLineDw(C4Surface *, float, float, float, float, uint32_t) override {}
-	virtual void DrawQuadDw(C4Surface *, int *, uint32_t, uint32_t, uint32_t, uint32_t) override {}
-	virtual void DrawPixInt(C4Surface *, float, float, uint32_t) override {}
+	virtual void PerformBlt(CBltData &, C4TexRef *, uint32_t, bool, bool) override { ++Stats.Blits; }
+	virtual void DrawLineDw(C4Surface *, float, float, float, float, uint32_t) override { ++Stats.Lines; }
+	virtual void DrawQuadDw(C4Surface *, int *, uint32_t, uint32_t, uint32_t, uint32_t) override { ++Stats.Quads; }
+	virtual void DrawPixInt(C4Surface *, float, float, uint32_t) override { ++Stats.Pixels; }
+	virtual void DrawLinesDw(C4Surface *, const CStdBatchLine *, size_t iCount) override { ++Stats.LineBatches; Stats.Lines += static_cast<uint32_t>(iCount); }
+	virtual void DrawPixsInt(C4Surface *, const CStdBatchPix *, size_t iCount) override { ++Stats.PixBatches; Stats.Pixels += static_cast<uint32_t>(iCount); }
+	virtual void BlitSprites(C4Surface *sfcTarget, const CStdBatchSprite *pSprites, size_t iCount) override { ++Stats.SpriteBatches; CStdDDraw::BlitSprites(sfcTarget, pSprites, iCount); }
+	const DrawCallStats &GetDrawCallStats() const { return Stats; }
+	void ResetDrawCallStats() { Stats = {}; }
 	virtual bool ApplyGammaRamp(CGammaControl &, bool) override { return true; }
 	virtual bool SaveDefaultGammaRamp(CStdWindow *) override { return true; }
 	virtual void SetTexture() override {}
@@ -42,6 +42,8 @@
 #include <shellapi.h>
 #include <conio.h>
 
+#include <chrono>
+
 int globalArgC;
 char **globalArgV;
 int iFirstCommand = -1;
@@ -73,9 +75,16 @@ int dbg_printf(const char *strMessage, Args... args)
 #endif
 #endif
 
+void PrintTime(const char *szWhat, std::chrono::steady_clock::time_point tStart)
+{
+	const auto tDuration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - tStart);
+	if (!fQuiet) printf("%s in %d ms\n", szWhat, static_cast<int>(tDuration.count()));
+}
+
 bool ProcessGroup(const char *szFilename)
 {
 	C4Group hGroup;
+	std::chrono::steady_clock::time_point tStart;
 	int iArg;
 	bool fDeleteGroup = false;
 	hGroup.SetStdOutput(true);
@@ -215,32 +224,38 @@ bool ProcessGroup(const char *szFilename)
 					// Pack
 					case 'p':
 						printf("Packing...\n");
+						tStart = std::chrono::steady_clock::now();
 						// Close
 						if (!hGroup.Close()) printf("Closing failed: %s\n", hGroup.GetError());
 						// Pack
 						else if (!C4Group_PackDirectory(szFilename)) printf("Pack failed\n");
 						// Reopen
 						else if (!hGroup.Open(szFilename)) printf("Reopen failed: %s\n", hGroup.GetError());
+						else PrintTime("Packed", tStart);
 						break;
 					// Unpack
 					case 'u':
 						printf("Unpacking...\n");
+						tStart = std::chrono::steady_clock::now();
 						// Close
 						if (!hGroup.Close()) printf("Closing failed: %s\n", hGroup.GetError());
 						// Unpack
 						else if (!C4Group_UnpackDirectory(szFilename)) printf("Unpack failed\n");
 						// Reopen
 						else if (!hGroup.Open(szFilename)) printf("Reopen failed: %s\n", hGroup.GetError());
+						else PrintTime("Unpacked", tStart);
 						break;
 					// Unpack
 					case 'x':
 						printf("Exploding...\n");
+						tStart = std::chrono::steady_clock::now();
 						// Close
 						if (!hGroup.Close()) printf("Closing failed: %s\n", hGroup.GetError());
 						// Explode
 						else if (!C4Group_ExplodeDirectory(szFilename)) printf("Unpack failed\n");
 						// Reopen
 						else if (!hGroup.Open(szFilename)) printf("Reopen failed: %s\n", hGroup.GetError());
+						else PrintTime("Exploded", tStart);
 						break;
 					// Print maker
 					case 'k':
@@ -458,6 +473,8 @@ int main(int argc, char *argv[])
 			case 'u': fUnregisterShell = true; break;
 			// Prompt at end
 			case 'p': fPromptAtEnd = true; break;
+			// Worker threads for packing and exploding
+			case 'j': C4Group_SetWorkerThreads(argv[i][2] ? atoi(argv[i] + 2) : 0); break;
 			// Execute at end
 			case 'x': SCopy(argv[i] + 3, strExecuteAtEnd, _MAX_PATH); break;
 			// Unknown
@@ -536,6 +553,7 @@ int main(int argc, char *argv[])
 		printf("Options:  /q Quiet /r Recursive /p Prompt at end\n");
 		printf("          /i Register shell /u Unregister shell\n");
 		printf("          /x:<command> Execute shell command when done\n");
+		printf("          /j[n] Pack and explode with n threads (default: all cores)\n");
 		printf("\n");
 		printf("Examples: c4group pack.c4g -a myfile.dat -v *.dat\n");
 		printf("          c4group pack.c4g -as myfile.dat myfile.bin\n");
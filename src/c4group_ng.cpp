@@ -39,6 +39,8 @@
 #include <C4Update.h>
 #include <C4Config.h>
 
+#include <chrono>
+
 // from http://cboard.cprogramming.com/archive/index.php/t-27714.html
 #include <stdio.h>
 #include <termios.h>
@@ -88,9 +90,16 @@ bool LogF(const char *strMessage, Args... args)
 	return Log(FormatString(strMessage, args...).getData());
 }
 
+void LogTime(const char *szWhat, std::chrono::steady_clock::time_point tStart)
+{
+	const auto tDuration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - tStart);
+	LogF("%s in %d ms", szWhat, static_cast<int>(tDuration.count()));
+}
+
 bool ProcessGroup(const char *FilenamePar)
 {
 	C4Group hGroup;
+	std::chrono::steady_clock::time_point tStart;
 	hGroup.SetStdOutput(!fQuiet);
 	bool fDeleteGroup = false;
 
@@ -268,6 +277,7 @@ bool ProcessGroup(const char *FilenamePar)
 					// Pack
 					case 'p':
 						Log("Packing...");
+						tStart = std::chrono::steady_clock::now();
 						// Close
 						if (!hGroup.Close())
 						{
@@ -283,10 +293,12 @@ bool ProcessGroup(const char *FilenamePar)
 						{
 							fprintf(stderr, "Reopen failed: %s\n", hGroup.GetError());
 						}
+						else LogTime("Packed", tStart);
 						break;
 					// Unpack
 					case 'u':
 						LogF("Unpacking...");
+						tStart = std::chrono::steady_clock::now();
 						// Close
 						if (!hGroup.Close())
 						{
@@ -302,10 +314,12 @@ bool ProcessGroup(const char *FilenamePar)
 						{
 							fprintf(stderr, "Reopen failed: %s\n", hGroup.GetError());
 						}
+						else LogTime("Unpacked", tStart);
 						break;
 					// Unpack
 					case 'x':
 						Log("Exploding...");
+						tStart = std::chrono::steady_clock::now();
 						// Close
 						if (!hGroup.Close())
 						{
@@ -321,6 +335,7 @@ bool ProcessGroup(const char *FilenamePar)
 						{
 							fprintf(stderr, "Reopen failed: %s\n", hGroup.GetError());
 						}
+						else LogTime("Exploded", tStart);
 						break;
 					// Print maker
 					case 'k':
@@ -507,6 +522,8 @@ int main(int argc, char *argv[])
 				break;
 			// Prompt at end
 			case 'p': fPromptAtEnd = true; break;
+			// Worker threads for packing and exploding
+			case 'j': C4Group_SetWorkerThreads(argv[i][2] ? atoi(argv[i] + 2) : 0); break;
 			// Execute at end
 			case 'x': SCopy(argv[i] + 3, strExecuteAtEnd, _MAX_PATH); break;
 			// Unknown
@@ -584,6 +601,7 @@ int main(int argc, char *argv[])
 		printf("\n");
 		printf("Options:  -v Verbose -r Recursive -p Prompt at end\n");
 		printf("          -i Register shell -u Unregister shell\n");
+		printf("          -j[n] Pack and explode with n threads (default: all cores)\n");
 		printf("          -x:<command> Execute shell command when done\n");
 		printf("\n");
 		printf("Examples: c4group pack.c4g -a myfile.dat -l \"*.dat\"\n");
@@ -592,6 +610,7 @@ int main(int argc, char *argv[])
 		printf("          c4group pack.c4g -et myfile.dat myfile.bak\n");
 		printf("          c4group pack.c4g -s \"*.bin|*.dat\"\n");
 		printf("          c4group pack.c4g -x\n");
+		printf("          c4group -j4 pack.c4g -p\n");
 		printf("          c4group pack.c4g -k\n");
 		printf("          c4group update.c4u -g ver1.c4f ver2.c4f New_Version\n");
 		printf("          c4group -i\n");